@@ -0,0 +1,712 @@
+#include "Engine.h"
+#include "Systems/WorldSystem.h"
+#include "Systems/EventSystem.h"
+#include "Systems/LogSystem.h"
+#include "Systems/ResourceSystem.h"
+#include "Components/TransformComponent.h"
+#include "Memory/MemoryTracker.h"
+
+#include <charconv>
+#include <cmath>
+#include <deque>
+#include <iomanip>
+#include <span>
+
+//
+// EngineBench
+//
+// Boots the full engine headless once per scenario and drives a scripted workload from a tick
+// subscriber, timing every frame from one tick to the next. Each scenario reports frame time
+// percentiles and how much of its work got through per second, optionally compared against a
+// baseline written by an earlier run. Any scenario that regresses past the tolerance fails the run.
+//
+// Usage: EngineBench [--frames 600] [--warmup 60] [--only NAME] [--baseline PATH]
+//                    [--write-baseline PATH] [--tolerance 0.1]
+//
+
+using namespace CE;
+using Clock = std::chrono::steady_clock;
+using Milliseconds = std::chrono::duration<double, std::milli>;
+
+namespace
+{
+	constexpr std::string_view s_usage =
+		"Usage: EngineBench [--frames 600] [--warmup 60] [--only NAME] [--baseline PATH]\n"
+		"                   [--write-baseline PATH] [--tolerance 0.1]";
+
+	struct BenchEvent : Event
+	{
+		int value = 0;
+		std::array<float, 4> payload{};
+	};
+
+	struct PayloadEvent : Event
+	{
+		InternedString name;
+		std::string_view text;
+		std::span<float> values;
+	};
+
+	struct ScenarioResult
+	{
+		std::string name;
+		std::string unit;
+		double mean = 0.0;
+		double p50 = 0.0;
+		double p95 = 0.0;
+		double p99 = 0.0;
+		double max = 0.0;
+		double throughput = 0.0;
+
+		// Set when the scenario's own check failed, fails the run like a regression
+		std::string failure;
+	};
+
+	//
+	// Scenario
+	//
+	// Setup runs on the first tick with every system up, Run on every tick after it. Frames are only
+	// measured once the warmup has passed.
+	//
+	class Scenario : public ITickEventSubscriber
+	{
+	public:
+		virtual ~Scenario() = default;
+
+		virtual std::string_view GetName() const = 0;
+		virtual std::string_view GetUnit() const = 0;
+
+		virtual void Setup(Engine& engine) {}
+		virtual void Teardown(Engine& engine) {}
+
+		// Returns how many units of work the frame did
+		virtual std::uint64_t Run(Engine& engine) = 0;
+
+		// Empty unless something the scenario checks for beyond timing went wrong
+		virtual std::string GetFailure() const { return {}; }
+
+		ScenarioResult Measure(std::uint64_t warmup, std::uint64_t frames)
+		{
+			m_warmup = warmup;
+			m_frameTimes.clear();
+			m_frameTimes.reserve(frames);
+			m_work = 0;
+			m_measuredWork = 0;
+			m_tick = 0;
+
+			// One extra tick closes out the last measured frame
+			EngineConfig config;
+			config.bHeadless = true;
+			config.maxFrames = warmup + frames + 2;
+			config.seed = 1337;
+			config.hitchBudgetMs = 0.0;
+			config.statsPath.clear();
+
+			{
+				Engine engine(config);
+				m_engine = &engine;
+				engine.Subscribe(this);
+				engine.Start();
+				Teardown(engine);
+				engine.Unsubscribe(this);
+				m_engine = nullptr;
+			}
+
+			return Summarize();
+		}
+
+		void OnTick() override
+		{
+			const Clock::time_point now = Clock::now();
+
+			if (m_tick == 0)
+			{
+				Setup(*m_engine);
+			}
+			else if (m_tick > m_warmup + 1)
+			{
+				m_frameTimes.push_back(Milliseconds(now - m_lastTick).count());
+			}
+
+			if (m_tick == m_warmup + 1)
+			{
+				m_measureStart = now;
+				m_work = 0;
+			}
+			m_lastTick = now;
+
+			// Work from this tick lands in a frame that only ends at the next one
+			m_measureEnd = now;
+			m_measuredWork = m_work;
+
+			if (m_tick > 0)
+			{
+				m_work += Run(*m_engine);
+			}
+			m_tick++;
+		}
+
+	private:
+		Engine* m_engine = nullptr;
+		std::uint64_t m_tick = 0;
+		std::uint64_t m_warmup = 0;
+		std::uint64_t m_work = 0;
+		std::uint64_t m_measuredWork = 0;
+		Clock::time_point m_lastTick;
+		Clock::time_point m_measureStart;
+		Clock::time_point m_measureEnd;
+		std::vector<double> m_frameTimes;
+
+		ScenarioResult Summarize()
+		{
+			ScenarioResult result;
+			result.name = GetName();
+			result.unit = GetUnit();
+			result.failure = GetFailure();
+			if (m_frameTimes.empty())
+			{
+				return result;
+			}
+
+			std::vector<double> sorted = m_frameTimes;
+			std::sort(sorted.begin(), sorted.end());
+
+			auto percentile = [&sorted](double p) {
+				const double rank = p * (sorted.size() - 1);
+				const std::size_t low = static_cast<std::size_t>(rank);
+				const std::size_t high = std::min(low + 1, sorted.size() - 1);
+				return sorted[low] + (sorted[high] - sorted[low]) * (rank - low);
+			};
+
+			for (double ms : sorted)
+			{
+				result.mean += ms;
+			}
+			result.mean /= sorted.size();
+			result.p50 = percentile(0.50);
+			result.p95 = percentile(0.95);
+			result.p99 = percentile(0.99);
+			result.max = sorted.back();
+
+			const double seconds = std::chrono::duration<double>(m_measureEnd - m_measureStart).count();
+			result.throughput = seconds > 0.0 ? m_measuredWork / seconds : 0.0;
+			return result;
+		}
+	};
+
+	// Spawns entities with a few transforms each, retiring the oldest to hold a steady population
+	class SpawnEntitiesScenario : public Scenario
+	{
+	public:
+		// 100k live transforms, leaving the component pool room for the world's own test bodies
+		static constexpr std::size_t s_spawnPerFrame = 1024;
+		static constexpr std::size_t s_componentsPerEntity = 4;
+		static constexpr std::size_t s_maxAlive = 25000;
+
+		std::string_view GetName() const override { return "spawn_entities"; }
+		std::string_view GetUnit() const override { return "entities/s"; }
+
+		std::uint64_t Run(Engine& engine) override
+		{
+			std::shared_ptr<WorldSystem> WS = engine.GetSystem<WorldSystem>();
+			for (std::size_t i = 0; i < s_spawnPerFrame; i++)
+			{
+				if (m_alive.size() >= s_maxAlive)
+				{
+					WS->DestroyEntity(m_alive.front());
+					m_alive.pop_front();
+				}
+
+				const EntityHandle handle = WS->CreateEntity().m_handle;
+				for (std::size_t c = 0; c < s_componentsPerEntity; c++)
+				{
+					TransformComponent* transform = WS->AddComponent<TransformComponent>(handle);
+					transform->SetPosition(glm::vec3(
+						Globals::g_rand.GetFloat(-100.f, 100.f),
+						Globals::g_rand.GetFloat(-100.f, 100.f),
+						Globals::g_rand.GetFloat(-100.f, 100.f)));
+				}
+				m_alive.push_back(handle);
+			}
+			return s_spawnPerFrame;
+		}
+
+	private:
+		std::deque<EntityHandle> m_alive;
+	};
+
+	// Many events a frame fanned out to many listeners
+	class PostEventsScenario : public Scenario
+	{
+	public:
+		static constexpr std::size_t s_listeners = 1024;
+		static constexpr std::size_t s_eventsPerFrame = 1024;
+
+		std::string_view GetName() const override { return "post_events"; }
+		std::string_view GetUnit() const override { return "deliveries/s"; }
+
+		void Setup(Engine& engine) override
+		{
+			std::shared_ptr<EventSystem> ES = engine.GetSystem<EventSystem>();
+			ES->AddQueue<BenchEvent>();
+			for (std::size_t i = 0; i < s_listeners; i++)
+			{
+				ES->RegisterGlobalListener<BenchEvent>([this](const BenchEvent& event) {
+					m_sum += event.value;
+				});
+			}
+		}
+
+		std::uint64_t Run(Engine& engine) override
+		{
+			std::shared_ptr<EventSystem> ES = engine.GetSystem<EventSystem>();
+			for (std::size_t i = 0; i < s_eventsPerFrame; i++)
+			{
+				BenchEvent event;
+				event.value = static_cast<int>(i);
+				ES->PostEvent(event);
+			}
+
+			// Posted now, delivered by ProcessEvents later this same frame
+			return s_eventsPerFrame * s_listeners;
+		}
+
+	private:
+		std::uint64_t m_sum = 0;
+	};
+
+	// Events carrying an interned name plus text and an array from the frame arena. Once the queues
+	// and arena have grown to a frame's worth, posting and dispatching them should not touch the heap,
+	// checked against the EVENTS tag when memory tracking is compiled in.
+	class EventPayloadsScenario : public Scenario
+	{
+	public:
+		static constexpr std::size_t s_eventsPerFrame = 4096;
+		static constexpr std::size_t s_valuesPerEvent = 16;
+		static constexpr std::uint64_t s_settleFrames = 30;
+
+		std::string_view GetName() const override { return "event_payloads"; }
+		std::string_view GetUnit() const override { return "events/s"; }
+
+		void Setup(Engine& engine) override
+		{
+			std::shared_ptr<EventSystem> ES = engine.GetSystem<EventSystem>();
+			ES->AddQueue<PayloadEvent>();
+			ES->RegisterGlobalListener<PayloadEvent>([this](const PayloadEvent& event) {
+				m_sum += event.name.Size() + event.text.size() + event.values.size();
+			});
+			m_name = InternedString("BenchPayload");
+		}
+
+		std::uint64_t Run(Engine& engine) override
+		{
+			MEMORY_SCOPE(Memory::MemoryTag::EVENTS);
+
+			// Counted up to the start of this frame, so every ProcessEvents since settling is included
+			const std::uint64_t allocations = Memory::MemoryTracker::Get().GetStats(Memory::MemoryTag::EVENTS).totalAllocations;
+			if (++m_runs == s_settleFrames)
+			{
+				m_settledAllocations = allocations;
+			}
+			else if (m_runs > s_settleFrames)
+			{
+				m_steadyAllocations = allocations - m_settledAllocations;
+			}
+
+			std::shared_ptr<EventSystem> ES = engine.GetSystem<EventSystem>();
+			for (std::size_t i = 0; i < s_eventsPerFrame; i++)
+			{
+				PayloadEvent event;
+				event.name = m_name;
+				event.text = ES->CopyPayloadText("payload text carried by reference");
+				event.values = ES->AllocatePayloadArray<float>(s_valuesPerEvent);
+				ES->PostEvent(event);
+			}
+			return s_eventsPerFrame;
+		}
+
+		std::string GetFailure() const override
+		{
+			if (!Memory::MemoryTracker::IsTrackingEnabled() || m_steadyAllocations == 0)
+			{
+				return {};
+			}
+			return std::format("{} event heap allocations after the first {} frames", m_steadyAllocations, s_settleFrames);
+		}
+
+	private:
+		InternedString m_name;
+		std::uint64_t m_sum = 0;
+		std::uint64_t m_runs = 0;
+		std::uint64_t m_settledAllocations = 0;
+		std::uint64_t m_steadyAllocations = 0;
+	};
+
+	// Swaps components out on a fixed population of entities
+	class ChurnComponentsScenario : public Scenario
+	{
+	public:
+		static constexpr std::size_t s_entities = 100000;
+		static constexpr std::size_t s_churnPerFrame = 4096;
+
+		std::string_view GetName() const override { return "churn_components"; }
+		std::string_view GetUnit() const override { return "swaps/s"; }
+
+		void Setup(Engine& engine) override
+		{
+			std::shared_ptr<WorldSystem> WS = engine.GetSystem<WorldSystem>();
+			for (std::size_t i = 0; i < s_entities; i++)
+			{
+				const EntityHandle handle = WS->CreateEntity().m_handle;
+				m_slots.push_back({ handle, WS->AddComponent<TransformComponent>(handle)->m_handle });
+			}
+		}
+
+		std::uint64_t Run(Engine& engine) override
+		{
+			std::shared_ptr<WorldSystem> WS = engine.GetSystem<WorldSystem>();
+			for (std::size_t i = 0; i < s_churnPerFrame; i++)
+			{
+				Slot& slot = m_slots[Globals::g_rand.GetInt(0, static_cast<int>(m_slots.size()) - 1)];
+				WS->RemoveComponent(slot.entity, slot.component);
+
+				TransformComponent* transform = WS->AddComponent<TransformComponent>(slot.entity);
+				transform->SetPosition(glm::vec3(Globals::g_rand.GetFloat(-100.f, 100.f), 0.f, 0.f));
+				slot.component = transform->m_handle;
+			}
+			return s_churnPerFrame;
+		}
+
+	private:
+		struct Slot
+		{
+			EntityHandle entity;
+			ComponentHandle component;
+		};
+		std::vector<Slot> m_slots;
+	};
+
+	// Streams meshes through the resource system, parsed on the workers and handed back on the main
+	// thread. Headless has no GL to upload to, so this loads the geometry alone.
+	class LoadMeshesScenario : public Scenario
+	{
+	public:
+		static constexpr std::size_t s_meshFiles = 64;
+		static constexpr std::size_t s_gridSize = 64;
+		static constexpr std::size_t s_requestsPerFrame = 16;
+
+		~LoadMeshesScenario()
+		{
+			if (!m_directory.empty())
+			{
+				std::error_code error;
+				std::filesystem::remove_all(m_directory, error);
+			}
+		}
+
+		std::string_view GetName() const override { return "load_meshes"; }
+		std::string_view GetUnit() const override { return "meshes/s"; }
+
+		void Setup(Engine& engine) override
+		{
+			m_directory = std::filesystem::temp_directory_path() / "EngineBench";
+			std::filesystem::create_directories(m_directory);
+			for (std::size_t i = 0; i < s_meshFiles; i++)
+			{
+				m_paths.push_back(m_directory / std::format("grid{}.obj", i));
+				WriteGrid(m_paths.back(), s_gridSize + i);
+			}
+		}
+
+		std::uint64_t Run(Engine& engine) override
+		{
+			std::shared_ptr<ResourceSystem> RS = engine.GetSystem<ResourceSystem>();
+			for (std::size_t i = 0; i < s_requestsPerFrame; i++)
+			{
+				const std::filesystem::path& path = m_paths[m_nextPath++ % m_paths.size()];
+				RS->RequestResource<MeshData>(path, [this](std::shared_ptr<MeshData> mesh) {
+					m_loaded += mesh ? 1 : 0;
+				});
+			}
+
+			// Counted as they come back, which is on the main thread during the engine's update
+			return std::exchange(m_loaded, 0);
+		}
+
+	private:
+		std::filesystem::path m_directory;
+		std::vector<std::filesystem::path> m_paths;
+		std::size_t m_nextPath = 0;
+		std::uint64_t m_loaded = 0;
+
+		// A flat grid of quads split into triangles, every corner with its own texcoord and normal
+		static void WriteGrid(const std::filesystem::path& path, std::size_t size)
+		{
+			std::ofstream file(path);
+			for (std::size_t y = 0; y <= size; y++)
+			{
+				for (std::size_t x = 0; x <= size; x++)
+				{
+					const float u = static_cast<float>(x) / size;
+					const float v = static_cast<float>(y) / size;
+					file << "v " << u << " 0 " << v << "\n";
+					file << "vt " << u << " " << v << "\n";
+					file << "vn 0 1 0\n";
+				}
+			}
+
+			auto corner = [size](std::size_t x, std::size_t y) {
+				const std::size_t index = y * (size + 1) + x + 1;
+				return std::format("{0}/{0}/{0}", index);
+			};
+
+			for (std::size_t y = 0; y < size; y++)
+			{
+				for (std::size_t x = 0; x < size; x++)
+				{
+					file << "f " << corner(x, y) << " " << corner(x + 1, y) << " " << corner(x + 1, y + 1) << "\n";
+					file << "f " << corner(x, y) << " " << corner(x + 1, y + 1) << " " << corner(x, y + 1) << "\n";
+				}
+			}
+		}
+	};
+
+	// Formatted log lines at a high rate, kept off stdout so the terminal isn't what gets measured
+	class LogSpamScenario : public Scenario
+	{
+	public:
+		static constexpr std::size_t s_linesPerFrame = 2000;
+
+		std::string_view GetName() const override { return "log_spam"; }
+		std::string_view GetUnit() const override { return "lines/s"; }
+
+		void Setup(Engine& engine) override
+		{
+			m_bLogToCout = g_log->m_bLogToCout;
+			g_log->m_bLogToCout = false;
+		}
+
+		void Teardown(Engine& engine) override
+		{
+			g_log->m_bLogToCout = m_bLogToCout;
+		}
+
+		std::uint64_t Run(Engine& engine) override
+		{
+			for (std::size_t i = 0; i < s_linesPerFrame; i++)
+			{
+				const float value = static_cast<float>(i) * 0.5f;
+				LOG_INFO(ENGINE, "Bench line {} with value {:.2f}", i, value);
+			}
+			return s_linesPerFrame;
+		}
+
+	private:
+		bool m_bLogToCout = true;
+	};
+
+	//
+	// Baseline files
+	//
+	// Written and read only by this tool, so reading just looks up each scenario's object and pulls
+	// numbers out of it by key rather than parsing JSON in general.
+	//
+	bool WriteBaseline(const std::filesystem::path& path, const std::vector<ScenarioResult>& results)
+	{
+		std::ofstream file(path);
+		if (!file)
+		{
+			std::cerr << "Failed to write baseline " << path << std::endl;
+			return false;
+		}
+
+		file << std::setprecision(6) << "{\n\t\"scenarios\": {\n";
+		for (std::size_t i = 0; i < results.size(); i++)
+		{
+			const ScenarioResult& r = results[i];
+			file << "\t\t\"" << r.name << "\": { "
+				<< "\"unit\": \"" << r.unit << "\", "
+				<< "\"mean\": " << r.mean << ", "
+				<< "\"p50\": " << r.p50 << ", "
+				<< "\"p95\": " << r.p95 << ", "
+				<< "\"p99\": " << r.p99 << ", "
+				<< "\"max\": " << r.max << ", "
+				<< "\"throughput\": " << r.throughput << " }"
+				<< (i + 1 < results.size() ? "," : "") << "\n";
+		}
+		file << "\t}\n}\n";
+		return true;
+	}
+
+	std::optional<ScenarioResult> FindBaseline(const std::string& json, const std::string& name)
+	{
+		// With the colon so a name that is a prefix of another, or a string value, can't match
+		const std::size_t key = json.find("\"" + name + "\":");
+		const std::size_t open = json.find('{', key);
+		const std::size_t close = json.find('}', open);
+		if (key == std::string::npos || open == std::string::npos || close == std::string::npos)
+		{
+			return std::nullopt;
+		}
+		const std::string_view object(json.data() + open, close - open);
+
+		auto number = [object](std::string_view field) {
+			double value = 0.0;
+			const std::size_t at = object.find("\"" + std::string(field) + "\":");
+			if (at != std::string_view::npos)
+			{
+				std::size_t start = at + field.size() + 3;
+				while (start < object.size() && object[start] == ' ') { start++; }
+				std::from_chars(object.data() + start, object.data() + object.size(), value);
+			}
+			return value;
+		};
+
+		ScenarioResult result;
+		result.name = name;
+		result.mean = number("mean");
+		result.p50 = number("p50");
+		result.p95 = number("p95");
+		result.p99 = number("p99");
+		result.max = number("max");
+		result.throughput = number("throughput");
+		return result;
+	}
+
+	// The whole value has to be a number, a typo shouldn't quietly run with zero
+	template <typename T>
+	bool ParseNumber(std::string_view text, T& value)
+	{
+		const std::from_chars_result result = std::from_chars(text.data(), text.data() + text.size(), value);
+		return result.ec == std::errc() && result.ptr == text.data() + text.size();
+	}
+
+	double Change(double value, double baseline)
+	{
+		return baseline > 0.0 ? (value - baseline) / baseline : 0.0;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::uint64_t frames = 600;
+	std::uint64_t warmup = 60;
+	double tolerance = 0.1;
+	std::string only;
+	std::filesystem::path baselinePath;
+	std::filesystem::path writeBaselinePath;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string_view arg = argv[i];
+		const bool bKnown = arg == "--frames" || arg == "--warmup" || arg == "--tolerance"
+			|| arg == "--only" || arg == "--baseline" || arg == "--write-baseline";
+		if (!bKnown)
+		{
+			std::cerr << "Unknown argument " << arg << "\n" << s_usage << std::endl;
+			return 1;
+		}
+
+		// Every option takes a value, running on with the default would hide a dropped baseline
+		if (i + 1 >= argc)
+		{
+			std::cerr << "Missing value for " << arg << "\n" << s_usage << std::endl;
+			return 1;
+		}
+
+		const std::string_view value = argv[++i];
+		bool bValid = true;
+		if (arg == "--frames") { bValid = ParseNumber(value, frames) && frames > 0; }
+		else if (arg == "--warmup") { bValid = ParseNumber(value, warmup); }
+		else if (arg == "--tolerance") { bValid = ParseNumber(value, tolerance) && std::isfinite(tolerance) && tolerance >= 0.0; }
+		else if (arg == "--only") { only = value; }
+		else if (arg == "--baseline") { baselinePath = value; }
+		else if (arg == "--write-baseline") { writeBaselinePath = value; }
+
+		if (!bValid)
+		{
+			std::cerr << "Invalid value " << value << " for " << arg << "\n" << s_usage << std::endl;
+			return 1;
+		}
+	}
+
+	std::vector<std::unique_ptr<Scenario>> scenarios;
+	scenarios.push_back(std::make_unique<SpawnEntitiesScenario>());
+	scenarios.push_back(std::make_unique<PostEventsScenario>());
+	scenarios.push_back(std::make_unique<EventPayloadsScenario>());
+	scenarios.push_back(std::make_unique<ChurnComponentsScenario>());
+	scenarios.push_back(std::make_unique<LoadMeshesScenario>());
+	scenarios.push_back(std::make_unique<LogSpamScenario>());
+
+	std::vector<ScenarioResult> results;
+	for (const std::unique_ptr<Scenario>& scenario : scenarios)
+	{
+		if (only.empty() || scenario->GetName() == only)
+		{
+			results.push_back(scenario->Measure(warmup, frames));
+		}
+	}
+
+	if (results.empty())
+	{
+		std::cerr << "No scenario named " << only << std::endl;
+		return 1;
+	}
+
+	std::string baselineJson;
+	if (!baselinePath.empty())
+	{
+		std::ifstream file(baselinePath);
+		if (!file)
+		{
+			std::cerr << "Failed to read baseline " << baselinePath << std::endl;
+			return 1;
+		}
+		baselineJson.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	bool bRegressed = false;
+
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << "EngineBench: " << frames << " frames after " << warmup << " warmup" << std::endl;
+	for (const ScenarioResult& r : results)
+	{
+		std::cout << "  " << r.name << ": mean " << r.mean << "ms, p50 " << r.p50 << "ms, p95 " << r.p95
+			<< "ms, p99 " << r.p99 << "ms, max " << r.max << "ms, " << std::setprecision(0) << r.throughput
+			<< " " << r.unit << std::setprecision(3) << std::endl;
+
+		if (!r.failure.empty())
+		{
+			std::cout << "    " << r.failure << "  FAILED" << std::endl;
+			bRegressed = true;
+		}
+
+		if (baselineJson.empty())
+		{
+			continue;
+		}
+
+		const std::optional<ScenarioResult> baseline = FindBaseline(baselineJson, r.name);
+		if (!baseline)
+		{
+			std::cout << "    no baseline" << std::endl;
+			continue;
+		}
+
+		// Slower frames or less work done are what count, the other direction is an improvement
+		const double p95Change = Change(r.p95, baseline->p95);
+		const double throughputChange = Change(r.throughput, baseline->throughput);
+		const bool bSlower = p95Change > tolerance || -throughputChange > tolerance;
+		bRegressed |= bSlower;
+
+		std::cout << "    vs baseline: p95 " << std::showpos << p95Change * 100.0 << "%, throughput "
+			<< throughputChange * 100.0 << "%" << std::noshowpos << (bSlower ? "  REGRESSED" : "  ok") << std::endl;
+	}
+
+	if (!writeBaselinePath.empty() && !WriteBaseline(writeBaselinePath, results))
+	{
+		return 1;
+	}
+
+	return bRegressed ? 1 : 0;
+}
@@ -0,0 +1,145 @@
+#include "Jobs/JobScheduler.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+
+//
+// JobBench
+// 
+// Scheduler throughput for tiny jobs (overhead bound) and a large ParallelFor (bandwidth bound)
+// compared against running the same work serially on one thread.
+// 
+// Usage: JobBench [workers=hardware-1]
+//
+
+using namespace CE::Jobs;
+using Clock = std::chrono::steady_clock;
+using Milliseconds = std::chrono::duration<double, std::milli>;
+
+namespace
+{
+	void BenchTinyJobs(JobScheduler& scheduler)
+	{
+		constexpr std::size_t jobCount = 1'000'000;
+		constexpr std::size_t waveSize = 1024;
+
+		std::atomic<std::uint64_t> sum{ 0 };
+
+		auto start = Clock::now();
+		for (std::size_t wave = 0; wave < jobCount; wave += waveSize)
+		{
+			JobCounter counter;
+			for (std::size_t i = 0; i < waveSize; i++)
+			{
+				scheduler.Run([&sum, i]() { sum.fetch_add(i, std::memory_order_relaxed); }, &counter);
+			}
+			scheduler.Wait(counter);
+		}
+		const double ms = Milliseconds(Clock::now() - start).count();
+
+		std::cout << "  tiny jobs: " << jobCount << " in " << ms << "ms, "
+			<< (jobCount / ms) / 1000.0 << "M jobs/s, "
+			<< (ms * 1'000'000.0) / jobCount << "ns/job" << std::endl;
+	}
+
+	void BenchNestedJobs(JobScheduler& scheduler)
+	{
+		// Jobs spawning jobs, exercises workers pushing to their own deques and stealing from each other
+		constexpr std::size_t parents = 256;
+		constexpr std::size_t children = 1024;
+
+		std::atomic<std::uint64_t> sum{ 0 };
+
+		auto start = Clock::now();
+		JobCounter counter;
+		for (std::size_t p = 0; p < parents; p++)
+		{
+			scheduler.Run([&scheduler, &sum, &counter]() {
+				for (std::size_t c = 0; c < children; c++)
+				{
+					scheduler.Run([&sum]() { sum.fetch_add(1, std::memory_order_relaxed); }, &counter);
+				}
+			}, &counter);
+		}
+		scheduler.Wait(counter);
+		const double ms = Milliseconds(Clock::now() - start).count();
+
+		const std::size_t total = parents * children;
+		std::cout << "  nested jobs: " << total << " in " << ms << "ms, "
+			<< (total / ms) / 1000.0 << "M jobs/s, sum " << sum.load() << std::endl;
+	}
+
+	void BenchParallelFor(JobScheduler& scheduler)
+	{
+		constexpr std::size_t count = 1 << 24;
+
+		std::vector<float> values(count);
+		for (std::size_t i = 0; i < count; i++)
+		{
+			values[i] = static_cast<float>(i % 1000);
+		}
+
+		auto work = [&values](std::size_t begin, std::size_t end) {
+			for (std::size_t i = begin; i < end; i++)
+			{
+				values[i] = std::sqrt(values[i] * 1.5f + 2.f) * std::sin(values[i]);
+			}
+		};
+
+		auto serialStart = Clock::now();
+		work(0, count);
+		const double serialMs = Milliseconds(Clock::now() - serialStart).count();
+
+		auto parallelStart = Clock::now();
+		scheduler.ParallelFor(count, 0, work);
+		const double parallelMs = Milliseconds(Clock::now() - parallelStart).count();
+
+		std::cout << "  parallel for: " << count << " items, serial " << serialMs << "ms, parallel "
+			<< parallelMs << "ms, speedup " << serialMs / parallelMs << "x" << std::endl;
+	}
+
+	void CheckDependencies(JobScheduler& scheduler)
+	{
+		// Second stage must only ever see the first stage's results
+		std::vector<int> stageOne(4096, 0);
+		std::atomic<int> mismatches{ 0 };
+
+		JobCounter first;
+		JobCounter second;
+		for (std::size_t i = 0; i < stageOne.size(); i++)
+		{
+			scheduler.Run([&stageOne, i]() { stageOne[i] = static_cast<int>(i); }, &first);
+		}
+		for (std::size_t i = 0; i < stageOne.size(); i++)
+		{
+			scheduler.Run([&stageOne, &mismatches, i]() {
+				if (stageOne[i] != static_cast<int>(i)) { mismatches.fetch_add(1); }
+			}, &second, &first);
+		}
+		scheduler.Wait(second);
+
+		std::cout << "  dependencies: " << (mismatches.load() == 0 ? "ok" : "FAILED") << std::endl;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const std::size_t workers = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 0;
+
+	JobScheduler scheduler(workers);
+
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << "JobBench: " << scheduler.GetWorkerCount() << " workers" << std::endl;
+
+	BenchTinyJobs(scheduler);
+	BenchNestedJobs(scheduler);
+	BenchParallelFor(scheduler);
+	CheckDependencies(scheduler);
+
+	const SchedulerStats stats = scheduler.GetStats();
+	std::cout << "  executed " << stats.executed << ", stolen " << stats.stolen
+		<< ", heap fallbacks " << stats.heapAllocated << std::endl;
+
+	return 0;
+}
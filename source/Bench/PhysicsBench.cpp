@@ -0,0 +1,127 @@
+#include "Physics/PhysicsScene.h"
+#include "Jobs/JobScheduler.h"
+
+#include <cstdlib>
+#include <iomanip>
+
+//
+// PhysicsBench
+// 
+// Drops a block of mixed spheres and boxes onto a static floor with a few static pillars and
+// times every step. Runs without any engine systems so numbers are the scene alone, island solves
+// go wide over a job scheduler the same way PhysicsSystem sets it up.
+// 
+// Usage: PhysicsBench [bodies=20000] [steps=600] [workers=hardware-1]
+//
+
+using namespace CE::Physics;
+
+namespace
+{
+	void BuildScene(PhysicsScene& scene, std::size_t bodyCount)
+	{
+		std::mt19937 rng(1337);
+		std::uniform_real_distribution<float> jitter(-0.05f, 0.05f);
+
+		BodyDesc floor;
+		floor.shape = ShapeType::BOX;
+		floor.position = glm::vec3(0.f, -1.f, 0.f);
+		floor.halfExtents = glm::vec3(200.f, 1.f, 200.f);
+		floor.mass = 0.f;
+		scene.AddBody(floor);
+
+		for (int pillar = 0; pillar < 16; pillar++)
+		{
+			BodyDesc desc;
+			desc.shape = ShapeType::BOX;
+			desc.position = glm::vec3((pillar % 4) * 20.f - 30.f, 2.f, (pillar / 4) * 20.f - 30.f);
+			desc.halfExtents = glm::vec3(1.f, 2.f, 1.f);
+			desc.mass = 0.f;
+			scene.AddBody(desc);
+		}
+
+		// Square layers spaced so nothing starts overlapping
+		const std::size_t side = 50;
+		const float spacing = 1.5f;
+		for (std::size_t i = 0; i < bodyCount; i++)
+		{
+			const std::size_t layer = i / (side * side);
+			const std::size_t cell = i % (side * side);
+
+			BodyDesc desc;
+			desc.shape = (i % 2 == 0) ? ShapeType::SPHERE : ShapeType::BOX;
+			desc.radius = 0.5f;
+			desc.halfExtents = glm::vec3(0.5f);
+			desc.position = glm::vec3(
+				(cell % side) * spacing - side * spacing * 0.5f + jitter(rng),
+				2.f + layer * spacing,
+				(cell / side) * spacing - side * spacing * 0.5f + jitter(rng));
+			scene.AddBody(desc);
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const std::size_t bodyCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000;
+	const std::size_t steps = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 600;
+	const std::size_t workers = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 0;
+	const float deltaTime = 1.f / 60.f;
+
+	CE::Jobs::JobScheduler scheduler(workers);
+
+	PhysicsScene scene;
+	scene.m_parallelFor = [&scheduler](std::size_t count, const std::function<void(std::size_t)>& function) {
+		scheduler.ParallelFor(count, 0, [&function](std::size_t begin, std::size_t end) {
+			for (std::size_t i = begin; i < end; i++)
+			{
+				function(i);
+			}
+		});
+	};
+	BuildScene(scene, bodyCount);
+
+	std::vector<double> stepMs;
+	stepMs.reserve(steps);
+	double broadphaseMs = 0.0;
+	double narrowphaseMs = 0.0;
+	double solveMs = 0.0;
+	std::size_t peakContacts = 0;
+
+	for (std::size_t step = 0; step < steps; step++)
+	{
+		scene.Step(deltaTime);
+
+		const SceneStats& stats = scene.GetStats();
+		stepMs.push_back(stats.totalMs);
+		broadphaseMs += stats.broadphaseMs;
+		narrowphaseMs += stats.narrowphaseMs;
+		solveMs += stats.solveMs;
+		peakContacts = std::max(peakContacts, stats.contacts);
+	}
+
+	if (stepMs.empty()) { return 0; }
+
+	std::vector<double> sorted = stepMs;
+	std::sort(sorted.begin(), sorted.end());
+	double total = 0.0;
+	for (double ms : stepMs) { total += ms; }
+
+	const double count = static_cast<double>(stepMs.size());
+	const SceneStats& stats = scene.GetStats();
+
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << "PhysicsBench: " << bodyCount << " bodies, " << steps << " steps, " << scheduler.GetWorkerCount() << " workers" << std::endl;
+	std::cout << "  step avg " << total / count << "ms"
+		<< "  p50 " << sorted[sorted.size() / 2] << "ms"
+		<< "  p95 " << sorted[(sorted.size() * 95) / 100] << "ms"
+		<< "  max " << sorted.back() << "ms" << std::endl;
+	std::cout << "  broadphase avg " << broadphaseMs / count << "ms"
+		<< "  narrowphase avg " << narrowphaseMs / count << "ms"
+		<< "  solve avg " << solveMs / count << "ms" << std::endl;
+	std::cout << "  peak contacts " << peakContacts
+		<< "  final awake " << stats.awake << "/" << stats.bodies
+		<< "  islands " << stats.islands << " (" << stats.sleepingIslands << " sleeping)" << std::endl;
+
+	return 0;
+}
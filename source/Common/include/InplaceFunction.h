@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template<typename _Signature, std::size_t _Capacity = 32ULL>
+class InplaceFunction;
+
+//
+// InplaceFunction
+//
+// Move-only stand in for std::function that keeps the callable in a fixed buffer inside itself and
+// never touches the heap. Anything too big for the buffer is a compile error rather than a silent
+// allocation, either capture less or raise the capacity at the declaration.
+//
+// Calling goes through one function pointer, moving and destroying through a small static table
+// per stored type, so an empty or moved-from function costs nothing to hold onto.
+//
+template<typename _Return, typename... _Args, std::size_t _Capacity>
+class InplaceFunction<_Return(_Args...), _Capacity>
+{
+public:
+	static constexpr std::size_t Capacity = _Capacity;
+	static constexpr std::size_t Alignment = alignof(std::max_align_t);
+
+	InplaceFunction() = default;
+	InplaceFunction(std::nullptr_t) {}
+
+	template<typename _Callable>
+	requires (!std::is_same_v<std::decay_t<_Callable>, InplaceFunction>) && std::is_invocable_r_v<_Return, std::decay_t<_Callable>&, _Args...>
+	InplaceFunction(_Callable&& callable)
+	{
+		using Stored = std::decay_t<_Callable>;
+		static_assert(sizeof(Stored) <= _Capacity, "Callable does not fit, capture less or raise the InplaceFunction capacity");
+		static_assert(alignof(Stored) <= Alignment, "Callable is over aligned for InplaceFunction storage");
+		static_assert(std::is_nothrow_move_constructible_v<Stored>, "InplaceFunction callables must be nothrow movable");
+
+		// Null function pointers stay empty, same as std::function
+		if constexpr (std::is_pointer_v<Stored> || std::is_member_pointer_v<Stored>)
+		{
+			if (callable == nullptr) { return; }
+		}
+
+		new (m_storage) Stored(std::forward<_Callable>(callable));
+		m_invoke = &Invoke<Stored>;
+		m_ops = &s_ops<Stored>;
+	}
+
+	InplaceFunction(InplaceFunction&& other) noexcept
+	{
+		MoveFrom(other);
+	}
+
+	InplaceFunction& operator=(InplaceFunction&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Reset();
+			MoveFrom(other);
+		}
+		return *this;
+	}
+
+	InplaceFunction& operator=(std::nullptr_t) noexcept
+	{
+		Reset();
+		return *this;
+	}
+
+	InplaceFunction(const InplaceFunction&) = delete;
+	InplaceFunction& operator=(const InplaceFunction&) = delete;
+
+	~InplaceFunction() { Reset(); }
+
+	// Const like std::function, the stored callable itself may still change its own state
+	_Return operator()(_Args... args) const
+	{
+		assert(m_invoke != nullptr);
+		return m_invoke(m_storage, std::forward<_Args>(args)...);
+	}
+
+	explicit operator bool() const { return m_invoke != nullptr; }
+
+	void Reset()
+	{
+		if (m_ops != nullptr)
+		{
+			m_ops->destroy(m_storage);
+			m_ops = nullptr;
+			m_invoke = nullptr;
+		}
+	}
+
+private:
+	struct Ops
+	{
+		void (*move)(void* destination, void* source);
+		void (*destroy)(void* storage);
+	};
+
+	template<typename _Stored>
+	static _Return Invoke(void* storage, _Args&&... args)
+	{
+		return std::invoke(*static_cast<_Stored*>(storage), std::forward<_Args>(args)...);
+	}
+
+	template<typename _Stored>
+	static constexpr Ops s_ops = {
+		[](void* destination, void* source) {
+			_Stored* from = static_cast<_Stored*>(source);
+			new (destination) _Stored(std::move(*from));
+			from->~_Stored();
+		},
+		[](void* storage) {
+			static_cast<_Stored*>(storage)->~_Stored();
+		}
+	};
+
+	_Return (*m_invoke)(void*, _Args&&...) = nullptr;
+	const Ops* m_ops = nullptr;
+	alignas(Alignment) mutable std::byte m_storage[_Capacity];
+
+	void MoveFrom(InplaceFunction& other)
+	{
+		if (other.m_ops != nullptr)
+		{
+			other.m_ops->move(m_storage, other.m_storage);
+			m_invoke = other.m_invoke;
+			m_ops = other.m_ops;
+			other.m_invoke = nullptr;
+			other.m_ops = nullptr;
+		}
+	}
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <format>
+#include <functional>
+#include <string_view>
+
+//
+// InternedString
+//
+// Handle to the one shared copy of a piece of text. Interning the same text twice hands back the
+// same copy, so copying, comparing and hashing are all pointer sized and never touch the heap.
+// Interned text lives until shutdown, meant for names, messages and other small vocabularies that
+// come up again and again rather than text built fresh every frame.
+//
+// Interning is safe from any thread. Text seen before is found under a shared lock without
+// allocating, only new text takes the exclusive lock to be copied in.
+//
+class InternedString
+{
+public:
+	// Where the text lives, stable for the life of the program
+	struct Entry
+	{
+		const char* text;
+		std::size_t size;
+	};
+
+	InternedString() = default;
+	explicit InternedString(std::string_view text) : m_entry(Intern(text)) {}
+
+	InternedString& operator=(std::string_view text)
+	{
+		m_entry = Intern(text);
+		return *this;
+	}
+
+	std::string_view View() const { return m_entry ? std::string_view(m_entry->text, m_entry->size) : std::string_view(); }
+
+	// Always null terminated, empty strings included
+	const char* CStr() const { return m_entry ? m_entry->text : ""; }
+
+	std::size_t Size() const { return m_entry ? m_entry->size : 0; }
+	bool IsEmpty() const { return m_entry == nullptr; }
+
+	bool operator==(const InternedString& other) const { return m_entry == other.m_entry; }
+	bool operator!=(const InternedString& other) const { return m_entry != other.m_entry; }
+
+	// Distinct strings interned so far and the bytes their text takes up
+	static std::size_t GetInternedCount();
+	static std::size_t GetInternedBytes();
+
+private:
+	friend struct std::hash<InternedString>;
+
+	// Null for the empty string
+	const Entry* m_entry = nullptr;
+
+	static const Entry* Intern(std::string_view text);
+};
+
+template<>
+struct std::hash<InternedString>
+{
+	std::size_t operator()(const InternedString& string) const noexcept
+	{
+		return std::hash<const void*>()(string.m_entry);
+	}
+};
+
+template<>
+struct std::formatter<InternedString> : std::formatter<std::string_view>
+{
+	auto format(const InternedString& string, std::format_context& context) const
+	{
+		return std::formatter<std::string_view>::format(string.View(), context);
+	}
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+//
+// MappedFile
+// 
+// Read-only memory mapping of a whole file. The OS pages data in on demand so large files
+// can be handed to memcpy without first being read into an intermediate buffer.
+//
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	explicit MappedFile(const std::filesystem::path& path) { Open(path); }
+	~MappedFile() { Close(); }
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool Open(const std::filesystem::path& path);
+	void Close();
+
+	bool IsOpen() const { return m_data != nullptr; }
+
+	const std::byte* Data() const { return m_data; }
+	std::size_t Size() const { return m_size; }
+
+private:
+	const std::byte* m_data = nullptr;
+	std::size_t m_size = 0;
+
+#if defined(_WIN32) || defined(_WIN64)
+	void* m_file = nullptr;
+	void* m_mapping = nullptr;
+#else
+	int m_file = -1;
+#endif
+};
@@ -8,10 +8,22 @@
 #include <cassert>
 #include <limits>
 #include <concepts>
+#include <algorithm>
 #include <array>
 #include <iostream>
-
-
+#include <cstring>
+#include <cstddef>
+#include <memory>
+
+
+//
+// ObjectPool
+// 
+// Fixed capacity pool handing out generational handles. Entries are allocated a page at a time as
+// the pool fills, so a large capacity costs nothing until it is used, and an entry never moves once
+// created. Slots that have never been used sit past the high water mark, destroyed ones are chained
+// into a freelist through their handles and reused first.
+//
 template<typename _ObjectType, std::size_t _MaxItems = 1024ULL, typename _HandleType = GenericHandle>
 requires ValidHandleType<_HandleType>
 class ObjectPool
@@ -32,32 +44,29 @@ public:
 		}
 		PoolEntry(HandleType h, ObjectType obj) : handle(h), object(std::move(obj)) {}
 
-		~PoolEntry() {}
+		// Defaulted so pools of trivially copyable objects can be copied around as raw memory
+		~PoolEntry() = default;
 	};
 
-	ObjectPool() : m_freelistHead(0) 
+	// Written ahead of any raw pool data so a reader can validate it matches this pool's layout
+	struct RawHeader
 	{
-		// Allocate our pool, don't bother clearing data
-		m_objects = new PoolEntry[_MaxItems];
+		std::uint64_t capacity;
+		std::uint64_t entrySize;
+		std::uint64_t count;
+		std::uint64_t freelistHead;
+		std::uint64_t used;
+	};
 
-		// Iterate populate freelist handles, m_objects invalid initialized
-		for (std::size_t i = 0; i < _MaxItems - 1; i++)
-		{
-			UnderlyingHandleType nextIndex = i + 1;
-			m_objects[i].handle = HandleType(nextIndex, 0, false);
-		}
+	static constexpr std::size_t PageSize = _MaxItems < 1024 ? _MaxItems : 1024;
 
-		// Last element special, end of free list
-		m_objects[_MaxItems - 1].handle = HandleType::INVALID;
-	}
+	ObjectPool() : m_freelistHead(s_endOfList) {}
 
-	~ObjectPool()
-	{
-		if (m_objects != nullptr)
-		{
-			delete[] m_objects;
-		}
-	}
+	// Pool owns its pages, copying would double free them
+	ObjectPool(const ObjectPool&) = delete;
+	ObjectPool& operator=(const ObjectPool&) = delete;
+
+	~ObjectPool() = default;
 
 	template<typename... Args>
 	HandleType Create(Args&&... args)
@@ -74,20 +83,28 @@ public:
 			return HandleType::INVALID;
 		}
 
-		// Get index/generation from freelistHead
-		auto& freePool = m_objects[m_freelistHead];
+		// Reuse the most recently freed slot, otherwise take the next one never used
 		UnderlyingHandleType index = m_freelistHead;
-		UnderlyingHandleType generation = freePool.handle.GetGeneration();
-
-		// Update freelistHead with previous in chain
-		m_freelistHead = freePool.handle.GetIndex();
+		if (index != s_endOfList)
+		{
+			m_freelistHead = Entry(index).handle.GetIndex();
+		}
+		else
+		{
+			index = m_used++;
+			if (index / PageSize >= m_pages.size())
+			{
+				AddPage();
+			}
+		}
 
 		// Create handle, stow object
-		HandleType handle = HandleType::Generate(index, generation + 1, true, aFlags, aType);
-		PoolEntry& entry = m_objects[index];
+		PoolEntry& entry = Entry(index);
+		HandleType handle = HandleType::Generate(index, entry.handle.GetGeneration() + 1, true, aFlags, aType);
 		entry.handle = handle;
 
-		// This is a little funky, essentially creates the ObjectType in-place
+		// Every slot holds a constructed object, the last occupant goes before the new one is built in place
+		entry.object.~ObjectType();
 		new (&entry.object) ObjectType(std::forward<Args>(args)...);
 		m_count++;
 
@@ -102,7 +119,7 @@ public:
 		UnderlyingHandleType currentIndex = handle.GetIndex();
 		UnderlyingHandleType currentGen = handle.GetGeneration();
 
-		auto& entry = m_objects[currentIndex];
+		auto& entry = Entry(currentIndex);
 		entry.handle = HandleType::Generate(m_freelistHead, currentGen, false);
 		m_freelistHead = currentIndex;
 		m_count--;
@@ -118,26 +135,212 @@ public:
 		// Validate handle id and gen
 		assert(IsHandleValid(handle));
 
-		return m_objects[handle.GetIndex()].object;
+		return Entry(handle.GetIndex()).object;
+	}
+
+	const ObjectType& Get(const HandleType& handle) const
+	{
+		assert(IsHandleValid(handle));
+
+		return Entry(handle.GetIndex()).object;
 	}
 
-	std::size_t GetFill()
+	bool IsValid(const HandleType& handle) const
+	{
+		return IsHandleValid(handle);
+	}
+
+	std::size_t GetFill() const
 	{
 		return m_count;
 	}
 
-	constexpr std::size_t Capacity()
+	static constexpr std::size_t Capacity()
 	{
 		return _MaxItems;
 	}
 
+	// Slots ever handed out, the part of the pool that has storage behind it
+	std::size_t GetUsed() const
+	{
+		return m_used;
+	}
+
+	// Calls function(handle, object) for every slot below the high water mark, free ones included
+	template <typename Function>
+	void ForEachSlot(Function&& function)
+	{
+		for (std::size_t i = 0; i < m_used; i++)
+		{
+			PoolEntry& entry = Entry(i);
+			function(entry.handle, entry.object);
+		}
+	}
+
+	//
+	// Raw Serialization
+	// 
+	// Every slot below the high water mark is dumped, freelist included, and restored a page per
+	// memcpy. Only available when the objects themselves can be treated as plain bytes.
+	//
+	void WriteRaw(std::ostream& out) const requires std::is_trivially_copyable_v<ObjectType>
+	{
+		RawHeader header{ _MaxItems, sizeof(PoolEntry), m_count, m_freelistHead, m_used };
+		out.write(reinterpret_cast<const char*>(&header), sizeof(RawHeader));
+		for (std::size_t page = 0; page * PageSize < m_used; page++)
+		{
+			const std::size_t count = std::min(PageSize, m_used - page * PageSize);
+			out.write(reinterpret_cast<const char*>(m_pages[page].get()), sizeof(PoolEntry) * count);
+		}
+	}
+
+	bool ReadRaw(const std::byte* data, std::size_t size) requires std::is_trivially_copyable_v<ObjectType>
+	{
+		RawHeader header;
+		if (!ValidateRaw(data, size, false, header)) { return false; }
+
+		Reserve(header.used);
+		const std::byte* entries = data + sizeof(RawHeader);
+		for (std::size_t page = 0; page * PageSize < header.used; page++)
+		{
+			const std::size_t count = std::min<std::size_t>(PageSize, header.used - page * PageSize);
+			std::memcpy(m_pages[page].get(), entries + page * PageSize * sizeof(PoolEntry), sizeof(PoolEntry) * count);
+		}
+		Restore(header);
+		return true;
+	}
+
+	// Handle-only variant for objects that need their own serialization. Restores the handles and
+	// freelist in bulk and leaves the objects as they are, the caller visits every slot with
+	// ForEachSlot afterwards to fill in the active ones and clear the rest.
+	void WriteHandles(std::ostream& out) const
+	{
+		RawHeader header{ _MaxItems, sizeof(HandleType), m_count, m_freelistHead, m_used };
+		out.write(reinterpret_cast<const char*>(&header), sizeof(RawHeader));
+		for (std::size_t i = 0; i < m_used; i++)
+		{
+			out.write(reinterpret_cast<const char*>(&Entry(i).handle), sizeof(HandleType));
+		}
+	}
+
+	bool ReadHandles(const std::byte* data, std::size_t size)
+	{
+		RawHeader header;
+		if (!ValidateRaw(data, size, true, header)) { return false; }
+
+		Reserve(header.used);
+		const std::byte* handles = data + sizeof(RawHeader);
+		for (std::size_t i = 0; i < header.used; i++)
+		{
+			std::memcpy(&Entry(i).handle, handles + i * sizeof(HandleType), sizeof(HandleType));
+		}
+		Restore(header);
+		return true;
+	}
+
+	// Checks a raw or handle-only block without touching the pool: the header matches this pool's
+	// layout, the data is all there and the handles agree with the header. rawBytes is how much of
+	// data the block takes up.
+	static bool ValidateRaw(const std::byte* data, std::size_t size, bool handlesOnly, RawHeader& header, std::size_t* rawBytes = nullptr)
+	{
+		const std::size_t entrySize = handlesOnly ? sizeof(HandleType) : sizeof(PoolEntry);
+		if (data == nullptr || size < sizeof(RawHeader)) { return false; }
+
+		std::memcpy(&header, data, sizeof(RawHeader));
+		if (header.capacity != _MaxItems || header.entrySize != entrySize || header.used > _MaxItems || header.count > header.used)
+		{
+			return false;
+		}
+		if (header.freelistHead != s_endOfList && header.freelistHead >= header.used)
+		{
+			return false;
+		}
+
+		const std::size_t bytes = sizeof(RawHeader) + entrySize * header.used;
+		if (size < bytes) { return false; }
+
+		// The handle leads every entry, active ones have to sit in their own slot and add up to count
+		std::size_t active = 0;
+		for (std::size_t i = 0; i < header.used; i++)
+		{
+			HandleType handle;
+			std::memcpy(&handle, data + sizeof(RawHeader) + i * entrySize, sizeof(HandleType));
+			if (handle.IsActive())
+			{
+				if (handle.GetIndex() != i) { return false; }
+				active++;
+			}
+		}
+		if (active != header.count) { return false; }
+
+		if (rawBytes != nullptr)
+		{
+			*rawBytes = bytes;
+		}
+		return true;
+	}
+
+	// Bytes WriteRaw or WriteHandles puts out for the pool as it is now
+	std::size_t RawSize(bool handlesOnly = false) const
+	{
+		return sizeof(RawHeader) + (handlesOnly ? sizeof(HandleType) : sizeof(PoolEntry)) * m_used;
+	}
+
 
 private:
 
-	PoolEntry* m_objects;
+	// Freelist terminator, never a real index since the pool can't hold more than _MaxItems
+	static constexpr UnderlyingHandleType s_endOfList = _MaxItems;
+
+	std::vector<std::unique_ptr<PoolEntry[]>> m_pages;
 	std::size_t m_count = 0;
+	std::size_t m_used = 0;
 	UnderlyingHandleType m_freelistHead;
 
+	PoolEntry& Entry(std::size_t index)
+	{
+		return m_pages[index / PageSize][index % PageSize];
+	}
+
+	const PoolEntry& Entry(std::size_t index) const
+	{
+		return m_pages[index / PageSize][index % PageSize];
+	}
+
+	void AddPage()
+	{
+		// Generation zero and inactive, the first handle out of each slot is generation one
+		std::unique_ptr<PoolEntry[]>& page = m_pages.emplace_back(std::make_unique<PoolEntry[]>(PageSize));
+		for (std::size_t i = 0; i < PageSize; i++)
+		{
+			page[i].handle = HandleType(0, 0, false);
+		}
+	}
+
+	void Reserve(std::size_t used)
+	{
+		while (m_pages.size() * PageSize < used)
+		{
+			AddPage();
+		}
+	}
+
+	void Restore(const RawHeader& header)
+	{
+		// Slots the snapshot never reached drop whatever they held, so nothing from before outlives it
+		for (std::size_t i = header.used; i < m_used; i++)
+		{
+			PoolEntry& entry = Entry(i);
+			entry.handle = HandleType(0, entry.handle.GetGeneration(), false);
+			entry.object.~ObjectType();
+			new (&entry.object) ObjectType();
+		}
+
+		m_count = header.count;
+		m_used = header.used;
+		m_freelistHead = static_cast<UnderlyingHandleType>(header.freelistHead);
+	}
+
 	bool IsHandleValid(const HandleType& handle) const
 	{
 		if (handle == HandleType::INVALID)
@@ -145,9 +348,9 @@ private:
 			return false;
 		}
 
-		// Index Bounds Checks
+		// Index Bounds Checks, nothing past the high water mark has been handed out
 		UnderlyingHandleType index = handle.GetIndex();
-		if (index < 0 || index >= _MaxItems)
+		if (index >= m_used)
 		{
 			return false;
 		}
@@ -158,9 +361,15 @@ private:
 			return false;
 		}
 
+		// Slot was destroyed and hasn't been reused yet, it keeps its generation until then
+		auto& entry = Entry(index);
+		if (!entry.handle.IsActive())
+		{
+			return false;
+		}
+
 		// Handle generation is outdated
 		UnderlyingHandleType gen = handle.GetGeneration();
-		auto& entry = m_objects[index];
 		UnderlyingHandleType currentGen = entry.handle.GetGeneration();
 
 		if (gen != currentGen)
@@ -181,34 +390,26 @@ private:
 		using Pointer = PoolEntry*;
 		using Reference = PoolEntry&;
 
-		Iterator(Pointer ptr, std::size_t index) : m_ptr(ptr), m_index(index) 
+		Iterator(ObjectPool* pool, std::size_t index) : m_pool(pool), m_index(index) 
 		{
 			// Find actual starting point
-			while ((*m_ptr).handle.IsActive() == false && m_index < _MaxItems)
-			{
-				++(m_ptr);
-				++m_index;
-			}
+			SkipFree();
 		}
 
 		Reference operator*() const
 		{
-			return *m_ptr;
+			return m_pool->Entry(m_index);
 		}
 
 		Pointer operator->()
 		{
-			return m_ptr;
+			return &m_pool->Entry(m_index);
 		}
 
 		Iterator& operator++()
 		{
-			do
-			{
-				++(m_ptr);
-				++m_index;
-			}
-			while ((*m_ptr).handle.IsActive() == false && m_index < _MaxItems);
+			++m_index;
+			SkipFree();
 			return *this;
 		}
 
@@ -221,7 +422,7 @@ private:
 
 		bool operator==(const Iterator& other) const
 		{
-			return m_ptr == other.m_ptr;
+			return m_index == other.m_index;
 		}
 
 		bool operator!=(const Iterator& other) const
@@ -231,8 +432,16 @@ private:
 
 	private:
 
-		Pointer m_ptr;
+		ObjectPool* m_pool;
 		std::size_t m_index;
+
+		void SkipFree()
+		{
+			while (m_index < m_pool->m_used && m_pool->Entry(m_index).handle.IsActive() == false)
+			{
+				++m_index;
+			}
+		}
 	};
 
 public:
@@ -240,11 +449,11 @@ public:
 	Iterator begin()
 	{
 		if (m_count == 0) return end();
-		return Iterator(&m_objects[0], 0);
+		return Iterator(this, 0);
 	}
 
 	Iterator end()
 	{
-		return Iterator(&m_objects[_MaxItems], _MaxItems);
+		return Iterator(this, m_used);
 	}
 };
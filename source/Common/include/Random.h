@@ -1,12 +1,25 @@
 #pragma once
 
+#include <cstdint>
 #include <random>
 
 class Random
 {
 public:
     Random()
-        : m_rng(std::random_device{}()) {}
+        : Random(std::random_device{}()) {}
+
+    explicit Random(std::uint32_t seed)
+        : m_seed(seed), m_rng(seed) {}
+
+    // Restarts the sequence, the same seed always gives the same numbers
+    void Seed(std::uint32_t seed)
+    {
+        m_seed = seed;
+        m_rng.seed(seed);
+    }
+
+    std::uint32_t GetSeed() const { return m_seed; }
 
     int GetInt(int min, int max)
     {
@@ -21,5 +34,6 @@ public:
     }
 
 private:
+    std::uint32_t m_seed;
     std::mt19937 m_rng;
 };
@@ -0,0 +1,105 @@
+#include "InternedString.h"
+
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+	// Text is packed into blocks this size, anything longer gets a block of its own
+	constexpr std::size_t s_blockSize = 16 * 1024;
+
+	struct StringTable
+	{
+		std::shared_mutex mutex;
+		std::unordered_map<std::string_view, const InternedString::Entry*> lookup;
+
+		// Neither moves what it holds once added, handles point straight into them
+		std::deque<InternedString::Entry> entries;
+		std::vector<std::unique_ptr<char[]>> blocks;
+		char* block = nullptr;
+		std::size_t blockUsed = s_blockSize;
+		std::size_t bytes = 0;
+
+		const char* CopyText(std::string_view text)
+		{
+			const std::size_t size = text.size() + 1;
+			char* destination = nullptr;
+			if (size > s_blockSize)
+			{
+				destination = blocks.emplace_back(std::make_unique<char[]>(size)).get();
+			}
+			else
+			{
+				if (blockUsed + size > s_blockSize)
+				{
+					block = blocks.emplace_back(std::make_unique<char[]>(s_blockSize)).get();
+					blockUsed = 0;
+				}
+				destination = block + blockUsed;
+				blockUsed += size;
+			}
+
+			std::memcpy(destination, text.data(), text.size());
+			destination[text.size()] = '\0';
+			bytes += size;
+			return destination;
+		}
+	};
+
+	StringTable& GetTable()
+	{
+		static StringTable table;
+		return table;
+	}
+}
+
+const InternedString::Entry* InternedString::Intern(std::string_view text)
+{
+	if (text.empty())
+	{
+		return nullptr;
+	}
+
+	StringTable& table = GetTable();
+	{
+		std::shared_lock lock(table.mutex);
+		auto it = table.lookup.find(text);
+		if (it != table.lookup.end())
+		{
+			return it->second;
+		}
+	}
+
+	std::unique_lock lock(table.mutex);
+
+	// Someone else may have interned it between the two locks
+	auto it = table.lookup.find(text);
+	if (it != table.lookup.end())
+	{
+		return it->second;
+	}
+
+	const char* copy = table.CopyText(text);
+	const Entry* entry = &table.entries.emplace_back(Entry{ copy, text.size() });
+	table.lookup.emplace(std::string_view(copy, text.size()), entry);
+	return entry;
+}
+
+std::size_t InternedString::GetInternedCount()
+{
+	StringTable& table = GetTable();
+	std::shared_lock lock(table.mutex);
+	return table.entries.size();
+}
+
+std::size_t InternedString::GetInternedBytes()
+{
+	StringTable& table = GetTable();
+	std::shared_lock lock(table.mutex);
+	return table.bytes;
+}
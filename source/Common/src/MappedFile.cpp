@@ -0,0 +1,106 @@
+#include "MappedFile.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+#if defined(_WIN32) || defined(_WIN64)
+
+bool MappedFile::Open(const std::filesystem::path& path)
+{
+	Close();
+
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) { return false; }
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (view == nullptr)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	m_file = file;
+	m_mapping = mapping;
+	m_data = static_cast<const std::byte*>(view);
+	m_size = static_cast<std::size_t>(fileSize.QuadPart);
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (m_data) { UnmapViewOfFile(m_data); }
+	if (m_mapping) { CloseHandle(m_mapping); }
+	if (m_file) { CloseHandle(m_file); }
+
+	m_data = nullptr;
+	m_mapping = nullptr;
+	m_file = nullptr;
+	m_size = 0;
+}
+
+#else
+
+bool MappedFile::Open(const std::filesystem::path& path)
+{
+	Close();
+
+	int file = open(path.c_str(), O_RDONLY);
+	if (file < 0) { return false; }
+
+	struct stat info;
+	if (fstat(file, &info) != 0 || info.st_size == 0)
+	{
+		close(file);
+		return false;
+	}
+
+	void* view = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	if (view == MAP_FAILED)
+	{
+		close(file);
+		return false;
+	}
+
+	// Whole file is about to be copied front to back
+	madvise(view, static_cast<std::size_t>(info.st_size), MADV_WILLNEED);
+
+	m_file = file;
+	m_data = static_cast<const std::byte*>(view);
+	m_size = static_cast<std::size_t>(info.st_size);
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (m_data) { munmap(const_cast<std::byte*>(m_data), m_size); }
+	if (m_file >= 0) { close(m_file); }
+
+	m_data = nullptr;
+	m_file = -1;
+	m_size = 0;
+}
+
+#endif
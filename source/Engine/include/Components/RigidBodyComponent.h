@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Systems/World/ComponentSubsystem.h"
+#include "Physics/PhysicsScene.h"
+
+namespace CE
+{
+	class RigidBodyComponent : public Component
+	{
+	public:
+		RigidBodyComponent() :
+			m_shape(Physics::ShapeType::SPHERE),
+			m_radius(0.5f),
+			m_halfExtents(0.5f),
+			m_mass(1.f),
+			m_restitution(0.2f),
+			m_friction(0.5f),
+			m_velocity(0.f),
+			m_body(Physics::InvalidBody),
+			m_bDirty(true)
+		{}
+
+		// Body description, write through the setters so the physics system rebuilds the body
+		Physics::ShapeType m_shape;
+		float m_radius;
+		glm::vec3 m_halfExtents;
+		float m_mass; // Zero mass is static
+		float m_restitution;
+		float m_friction;
+
+		// Written back by the physics system every step
+		glm::vec3 m_velocity;
+
+		// Owned by the physics system
+		Physics::BodyID m_body;
+		bool m_bDirty;
+
+		void SetSphere(float radius)
+		{
+			m_shape = Physics::ShapeType::SPHERE;
+			m_radius = radius;
+			m_bDirty = true;
+		}
+
+		void SetBox(const glm::vec3& halfExtents)
+		{
+			m_shape = Physics::ShapeType::BOX;
+			m_halfExtents = halfExtents;
+			m_bDirty = true;
+		}
+
+		void SetMass(float mass)
+		{
+			m_mass = mass;
+			m_bDirty = true;
+		}
+
+		void SetVelocity(const glm::vec3& velocity)
+		{
+			m_velocity = velocity;
+			m_bDirty = true;
+		}
+	};
+}
@@ -4,24 +4,36 @@
 
 namespace CE
 {
+	class WorldSystem;
+
 	class TransformComponent : public Component
 	{
 	public:
-		TransformComponent() : m_transform(glm::mat4(1.0)) {}
-
-		glm::mat4 m_transform;
+		TransformComponent() : m_transform(glm::mat4(1.0)), m_bDirty(false), m_dirtyList(nullptr) {}
 
 		void SetPosition(glm::vec3 pos)
 		{
 			m_transform[3] = glm::vec4(pos, 1.f);
+			MarkDirty();
+		}
+
+		void SetTransform(const glm::mat4& transform)
+		{
+			m_transform = transform;
+			MarkDirty();
+		}
+
+		const glm::mat4& GetTransform() const
+		{
+			return m_transform;
 		}
 
-		glm::vec3 GetPosition()
+		glm::vec3 GetPosition() const
 		{
 			return m_transform[3];
 		}
 
-		glm::vec3 GetScale()
+		glm::vec3 GetScale() const
 		{
 			glm::vec3 scale;
 			scale.x = glm::length(glm::vec3(m_transform[0]));
@@ -30,5 +42,31 @@ namespace CE
 			return scale;
 		}
 
+		// Everything renders as the unit cube for now, so bound that
+		float GetBoundingRadius() const
+		{
+			glm::vec3 scale = GetScale();
+			return std::max({ scale.x, scale.y, scale.z }) * 1.7320508f;
+		}
+
+		// Queues the transform for its world's spatial index, once until the world next syncs it
+		void MarkDirty()
+		{
+			if (!m_bDirty && m_dirtyList)
+			{
+				m_bDirty = true;
+				m_dirtyList->push_back(m_handle);
+			}
+		}
+
+	private:
+		friend class WorldSystem;
+
+		glm::mat4 m_transform;
+		bool m_bDirty;
+
+		// The owning world's queue, set when the world adds the component. A plain pointer keeps pools
+		// trivially copyable for snapshots, the world points loaded transforms back at its own queue.
+		std::vector<ComponentHandle>* m_dirtyList;
 	};
-}
\ No newline at end of file
+}
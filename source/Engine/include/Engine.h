@@ -14,10 +14,20 @@
 #include "stdlibincl.h"
 #include "Globals.h"
 #include "Mesh.h"
+#include "EngineConfig.h"
+#include "FramePacer.h"
+#include "Replay/ReplayFile.h"
+
+#include <cmath>
+#include <mutex>
+#include <thread>
 
 struct GLFWwindow;
 class FrameCounter;
 
+namespace CE { class ProfilerWindow; }
+namespace CE { class MemoryWindow; }
+
 namespace CE
 {
 	class ITickEventSubscriber
@@ -27,13 +37,21 @@ namespace CE
 		virtual void OnTick() = 0;
 	};
 
+	struct SystemStartupTiming
+	{
+		std::string name;
+		double beginMs = 0.0;		// From the start of system initialization
+		double durationMs = 0.0;
+		bool bMainThread = true;
+	};
+
 	template <typename T>
 	concept IsSystem = std::is_base_of_v<EngineSystem, T>;
 
 	class Engine
 	{
 	public:
-		Engine();
+		Engine(const EngineConfig& config = {});
 		~Engine();
 
 		//
@@ -56,9 +74,11 @@ namespace CE
 		template<IsSystem System>
 		std::shared_ptr<System> GetSystem()
 		{
-			if (m_systems.contains(typeid(System)))
+			// Read only lookup, systems call this from each other's startup on the job workers
+			auto it = m_systems.find(typeid(System));
+			if (it != m_systems.end())
 			{
-				return std::dynamic_pointer_cast<System>(m_systems[typeid(System)]);
+				return std::dynamic_pointer_cast<System>(it->second);
 			}
 #ifdef CDEBUG
 			assert(false);
@@ -66,22 +86,97 @@ namespace CE
 			return nullptr;
 		}
 
-		// Dangerous handing out free pointers to our window object
+		// Dangerous handing out free pointers to our window object, always null when headless
 		GLFWwindow* GetWindow() { return m_window; }
 
+		const EngineConfig& GetConfig() const { return m_config; }
+
+		// Ticked once a frame ahead of any system update
+		void Subscribe(ITickEventSubscriber* sub);
+		void Unsubscribe(ITickEventSubscriber* sub);
+
+		// How long each system took to start and when, in the order they started
+		const std::vector<SystemStartupTiming>& GetStartupTimings() const { return m_startupTimings; }
+
+		// No window, GL or ImGui, systems needing them should check this before touching any
+		bool IsHeadless() const { return m_config.bHeadless; }
+
+		//
+		// Fixed Step Simulation
+		// 
+		// When enabled the world simulates in fixed increments no matter the display rate and
+		// rendering interpolates between the last two ticks. Disabled, it steps once per frame.
+		// 
+		// A step that isn't positive and finite would stall the accumulator loop, so it is refused
+		// and the current step kept. Steps shorter than s_minFixedTimeStep are clamped up to it.
+		//
+		static constexpr double s_minFixedTimeStep = 1.0 / 1000.0;
+
+		void SetFixedStepEnabled(bool bEnabled) { m_bFixedStep = bEnabled; }
+		bool SetFixedTimeStep(double seconds)
+		{
+			if (!std::isfinite(seconds) || seconds <= 0.0)
+			{
+				return false;
+			}
+			m_fixedDeltaTime = std::max(seconds, s_minFixedTimeStep);
+			return true;
+		}
+		double GetFixedTimeStep() const { return m_fixedDeltaTime; }
+
+		//
+		// Frame Pacing
+		// 
+		// Frames are held to the target rate on top of whatever vsync does, zero leaves them uncapped.
+		// In low latency mode the wait moves to the start of the frame, right before input is polled.
+		//
+		void SetFrameRate(double hz) { m_pacer.SetTargetRate(hz); }
+		void SetLowLatency(bool bLowLatency) { m_pacer.SetLowLatency(bLowLatency); }
+		const FramePacer& GetFramePacer() const { return m_pacer; }
+
 	private:
 
+		EngineConfig m_config;
+
 		GLFWwindow* m_window;
 		
-		// Create necessary glfw window
+		// Opens the recording or replay if asked for and seeds random numbers to match
+		bool OpenReplay();
+
+		// Create necessary glfw window, skipped entirely when headless
 		bool Initialize();
 
 		// Add individual systems here regardless of dependency order
 		void AddSystems();
 
-		// Systems are initialized and ready to use
+		// Constructed under the system's own memory tag, so whatever its constructor allocates is charged
+		// to it rather than the engine. The tag has to match what the system reports for itself.
+		template<IsSystem System>
+		void AddSystem(Memory::MemoryTag tag)
+		{
+			MEMORY_SCOPE(tag);
+			std::shared_ptr<EngineSystem> system = std::make_shared<System>(this);
+			assert(system->GetMemoryTag() == tag);
+			if (m_systems.contains(typeid(System)) == false)
+			{
+				m_registrationOrder.push_back(typeid(System));
+			}
+			m_systems[typeid(System)] = std::move(system);
+		}
+
+		//
+		// SystemInitialize
+		// 
+		// Starts systems in dependency order. The job system and whatever it needs start inline, then
+		// everything else runs as jobs as soon as its dependencies are up, main thread only systems
+		// included through the main thread queue. Returns once every system is ready to use.
+		//
 		void SystemInitialize();
 
+		// Fallback when there are no workers or the dependencies don't form a graph
+		void StartSystemsInOrder(const std::vector<EngineSystem*>& order);
+		void ReportStartupTimings();
+
 #ifdef CDEBUG
 		// Some debug only test code during system development
 		void TestSystems();
@@ -91,15 +186,55 @@ namespace CE
 
 		void ShutdownSystems();
 
+		// Startup and shutdown allocations count against the system's memory tag
+		void StartupSystem(EngineSystem& system);
+		void ShutdownSystem(EngineSystem& system);
+
 		std::unordered_map<std::type_index, std::shared_ptr<EngineSystem>> m_systems;
 
+		// The order AddSystems registered them in, the map above has none
+		std::vector<std::type_index> m_registrationOrder;
+
+		// Filled in as systems finish starting, shutdown walks it backwards
+		std::vector<EngineSystem*> m_startedSystems;
+		std::vector<SystemStartupTiming> m_startupTimings;
+		std::chrono::steady_clock::time_point m_startupBegin;
+		std::thread::id m_mainThread;
+		std::mutex m_startupMutex;
+
 		bool m_exit = false;
 
 		void CoreLoop();
-		void Update();
-		void Render();
+		void Update(double deltaTime);
+		void Render(float alpha);
 		void ProcessInput();
 
+		// Runs as many fixed steps as the frame time covers, returns how far we are into the next one
+		float Simulate(double frameTime);
+		void FixedUpdate(double deltaTime);
+
+		bool m_bFixedStep = true;
+		double m_fixedDeltaTime = 1.0 / 60.0;
+		double m_accumulator = 0.0;
+		std::chrono::steady_clock::time_point m_previousTime;
+
+		FramePacer m_pacer;
+		std::uint64_t m_frameIndex = 0;
+
+		std::vector<ITickEventSubscriber*> m_tickSubscribers;
+
+		// Writes the frame out when recording, checks it against the recording when replaying
+		void RecordFrame(double simulateTime, bool bInputFirst, std::uint32_t eventsPosted);
+
+		Replay::ReplayWriter m_recorder;
+		Replay::ReplayReader m_replay;
+		Replay::ReplayFrame m_replayFrame;
+		bool m_bReplayDiverged = false;
+
 		FrameCounter* m_frameCounter;
+
+		// Debug windows, left null in builds without them
+		ProfilerWindow* m_profilerWindow = nullptr;
+		MemoryWindow* m_memoryWindow = nullptr;
 	};
 }
\ No newline at end of file
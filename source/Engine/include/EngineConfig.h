@@ -0,0 +1,55 @@
+#pragma once
+
+#include "stdlibincl.h"
+#include "Memory/MemoryTracker.h"
+
+#include <optional>
+
+namespace CE
+{
+	//
+	// EngineConfig
+	// 
+	// Startup options for the engine, fill in directly or parse from the command line.
+	//
+	//	--headless		No window, GL context or ImGui. Rendering is skipped and input is never polled.
+	//	--frames N		Stop after N frames, zero runs until something calls Engine::Stop.
+	//	--rate HZ		Frame rate limit. Zero is uncapped, headless runs then step exactly one fixed tick
+	//					per frame as fast as the CPU allows instead of following the wall clock.
+	//	--low-latency	Start each paced frame as late as possible so input is sampled close to display.
+	//	--no-vsync		Don't wait on the swap, leaving pacing to the frame rate limit.
+	//	--tick HZ		Fixed simulation rate.
+	//	--hitch MS		Frames with more work than this, pacing waits aside, are logged and keep their profile. Zero disables.
+	//	--stats PATH	Where frame stats are written at shutdown, an empty path skips writing them.
+	//	--budget TAG=MB	Warn when a memory tag holds more than this, tags are named as in the memory window.
+	//	--seed N		Seed for the global random generator, zero picks one at random.
+	//	--record PATH	Write every frame's inputs and timing out so the session can be replayed.
+	//	--replay PATH	Play a recording back headless as fast as possible, stopping where it ends.
+	//
+	struct EngineConfig
+	{
+		bool bHeadless = false;
+
+		int windowWidth = 1920;
+		int windowHeight = 1080;
+
+		std::uint64_t maxFrames = 0;
+		double frameRate = 0.0;
+		double tickRate = 60.0;
+		bool bLowLatency = false;
+		bool bVSync = true;
+
+		double hitchBudgetMs = 1000.0 / 30.0;
+		std::filesystem::path statsPath = "frame_stats.json";
+
+		// Bytes per memory tag, zero is unbudgeted
+		std::array<std::size_t, Memory::s_tagCount> memoryBudgets{};
+
+		std::uint32_t seed = 0;
+		std::filesystem::path recordPath;
+		std::filesystem::path replayPath;
+
+		// Empty when an option is unknown, missing its value or given a bad one, each reported on stderr
+		static std::optional<EngineConfig> FromCommandLine(int argc, char** argv);
+	};
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "stdlibincl.h"
+
+namespace CE
+{
+	struct FramePacerStats
+	{
+		double lastWaitMs = 0.0;
+		double lastSpinMs = 0.0;
+		double sleepCostMs = 0.0;
+		double workEstimateMs = 0.0;
+		std::uint64_t missedFrames = 0;
+	};
+
+	//
+	// FramePacer
+	//
+	// Holds frames to a target rate on the steady clock. OS sleeps are coarse and overshoot, so the
+	// pacer sleeps in short steps while it is comfortably early, learning how late those sleeps wake,
+	// then spins out the last stretch to land on the deadline.
+	//
+	// Windows sleeps in whole scheduler ticks of around 15.6ms by default, so the pacer asks for 1ms
+	// timer resolution for as long as it exists. Whatever sleeps still cost, including the odd long
+	// one, is measured and kept as spin margin ahead of the deadline.
+	//
+	// Low latency mode expects Wait to be called right before input is sampled. It then starts the
+	// frame as late as it can while still finishing by the deadline, going by how long recent frames
+	// took, so input is as fresh as possible when the frame lands.
+	//
+	class FramePacer
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		FramePacer();
+		~FramePacer();
+
+		FramePacer(const FramePacer&) = delete;
+		FramePacer& operator=(const FramePacer&) = delete;
+
+		// Zero leaves frames unpaced
+		void SetTargetRate(double hz);
+		double GetTargetRate() const { return m_targetRate; }
+		bool IsLimiting() const { return m_period > Clock::duration::zero(); }
+
+		void SetLowLatency(bool bLowLatency) { m_bLowLatency = bLowLatency; }
+		bool IsLowLatency() const { return m_bLowLatency; }
+
+		// Blocks until the next frame should start, call once a frame
+		void Wait();
+
+		const FramePacerStats& GetStats() const { return m_stats; }
+
+	private:
+		double m_targetRate = 0.0;
+		bool m_bLowLatency = false;
+		Clock::duration m_period = Clock::duration::zero();
+
+		// Deadline the frame being worked on should finish by, unset until the first Wait
+		Clock::time_point m_deadline{};
+		Clock::time_point m_workStart{};
+
+		// Running estimate of how late a short sleep wakes, seeded pessimistically until measured
+		double m_sleepMeanMs = 1.0;
+		double m_sleepVarianceMs = 1.0;
+
+		// Decaying peak of what sleeps cost, so one rare long wake keeps the margin up for a while
+		double m_sleepPeakMs = 1.0;
+
+		// Decaying peak of recent frame work, low latency mode starts this far ahead of the deadline
+		double m_workEstimateMs = 0.0;
+
+		FramePacerStats m_stats;
+
+		void SleepUntil(Clock::time_point target);
+	};
+}
@@ -5,6 +5,7 @@
 #include <vector>
 #include <unordered_map>
 #include <functional>
+#include <mutex>
 
 #include "DebugGUI.h"
 #include "Systems/EngineSystem.h"
@@ -24,6 +25,8 @@ namespace CE
 		/* EngineSystem Interface */
 	public:
 		virtual std::string Name() const override { return "Debug System"; }
+		virtual Memory::MemoryTag GetMemoryTag() const override { return Memory::MemoryTag::DEBUG; }
+		virtual SystemDependencies GetDependencies() const override;
 	protected:
 		friend class Engine;
 		virtual void Startup() override;
@@ -51,5 +54,8 @@ namespace CE
 		};
 
 		std::vector<DebugView> m_debugSubscribers;
+
+		// Systems subscribe from their startup, which may be running on a worker
+		std::mutex m_subscribeMutex;
 	};
 }
\ No newline at end of file
@@ -1,60 +1,114 @@
 #pragma once
 
-class FrameCounter
+#include "stdlibincl.h"
+#include "GUI/DebugGUI.h"
+#include "Profiling/Profiler.h"
+
+//
+// FrameCounter
+//
+// Times every frame and the engine phases inside it. Keeps a rolling history for percentiles and
+// graphs, plus a whole session histogram that gets written out at shutdown so runs can be compared
+// offline. Frames whose work, everything but the WAIT phase, runs over the hitch budget are logged
+// and, with profiling compiled in, keep a copy of that frame's profiler scopes.
+//
+class FrameCounter : public CE::IDebugGUI
 {
 	using TimePoint = std::chrono::steady_clock::time_point;
 
 	inline static const double targetFrameDuration = 1000.0 / 60.f;
 
 public:
-	FrameCounter() : m_fps(0), m_frameCount(0), m_totalTime(0), m_frameStart(), m_frameEnd() {}
+	// TOTAL is the whole frame, the rest are marked off in order as the frame runs
+	enum class Phase : std::uint8_t
+	{
+		TOTAL,
+		UPDATE,
+		SIMULATE,
+		RENDER,
+		INPUT,
+		WAIT,
+		COUNT
+	};
+
+	static constexpr std::size_t s_phaseCount = static_cast<std::size_t>(Phase::COUNT);
+	static constexpr std::size_t s_historySize = 600;
+	static constexpr std::size_t s_maxHitches = 32;
+
+	// Session histogram, anything past the last bucket lands in it
+	static constexpr double s_bucketMs = 0.25;
+	static constexpr std::size_t s_bucketCount = 400;
 
-	void FrameStart()
+	struct Percentiles
 	{
-		m_frameStart = std::chrono::high_resolution_clock::now();
-	}
+		double mean = 0.0;
+		double p50 = 0.0;
+		double p95 = 0.0;
+		double p99 = 0.0;
+		double max = 0.0;
+	};
 
-	double FrameEnd()
+	struct Hitch
 	{
-		m_frameEnd = std::chrono::high_resolution_clock::now();
+		std::uint64_t frame = 0;
+		std::array<double, s_phaseCount> phaseMs{};
+#ifdef CE_PROFILING
+		CE::Profiling::FrameRecord profile;
+#endif
+	};
 
-		std::chrono::duration<double, std::milli> frameDuration = m_frameEnd - m_frameStart;
+	explicit FrameCounter(double hitchBudgetMs = 1000.0 / 30.0);
 
-		m_deltaTime = frameDuration.count();
-		m_fps = 1000.f / m_deltaTime;
+	void FrameStart();
 
-		if (frameDuration.count() < targetFrameDuration)
-		{
-			return targetFrameDuration - frameDuration.count();
-		}
-		return 0;
-	}
+	// Closes the given phase, timed from the previous mark or the frame start
+	void MarkPhase(Phase phase);
 
-	virtual void OnDrawGUI()
-	{
-		ImGuiWindowFlags statsFlags = 0;
-		statsFlags |= ImGuiWindowFlags_NoCollapse;
-		statsFlags |= ImGuiWindowFlags_NoResize;
-		statsFlags |= ImGuiWindowFlags_NoDocking;
-		statsFlags |= ImGuiWindowFlags_NoSavedSettings;
+	void FrameEnd();
+
+	Percentiles GetRecentStats(Phase phase) const;
+	Percentiles GetSessionStats(Phase phase) const;
+
+	const std::vector<Hitch>& GetHitches() const { return m_hitches; }
 
-		ImGui::SetNextWindowPos(ImVec2(10, 30));
-		ImGui::SetNextWindowSize(ImVec2(160, 70));
-		ImGui::Begin("Stats", 0, statsFlags);
+	void SetHitchBudget(double ms) { m_hitchBudgetMs = ms; }
+	double GetHitchBudget() const { return m_hitchBudgetMs; }
 
-		ImGui::Text("FPS: %d", m_fps);
-		ImGui::Text("DeltaTime: %.2fms", m_deltaTime);
+	// Session stats as JSON, also exports captured hitch profiles next to it when there are any
+	bool WriteStats(const std::filesystem::path& path) const;
 
-		ImGui::End();
-	}
+	virtual void OnDrawGUI() override;
+	virtual std::string_view GetDebugMenuName() override { return "FPS"; }
 
-	virtual std::string_view GetDebugMenuName() { return "FPS"; }
+	static std::string_view GetPhaseName(Phase phase);
 
 private:
 	int m_fps;
-	int m_frameCount;
+	std::uint64_t m_frameCount;
 	double m_totalTime;
 	double m_deltaTime;
+	double m_hitchBudgetMs;
 	TimePoint m_frameStart;
 	TimePoint m_frameEnd;
-};
\ No newline at end of file
+	TimePoint m_phaseStart;
+
+	// Per phase rolling history, column per phase
+	std::array<double, s_phaseCount> m_current{};
+	std::vector<std::array<double, s_phaseCount>> m_history;
+	std::size_t m_historyHead = 0;
+
+	// Whole session, never reset
+	std::array<std::array<std::uint64_t, s_bucketCount + 1>, s_phaseCount> m_buckets{};
+	std::array<double, s_phaseCount> m_sessionSum{};
+	std::array<double, s_phaseCount> m_sessionMax{};
+
+	// Oldest first, the oldest drops off once full
+	std::vector<Hitch> m_hitches;
+
+	bool m_bShowSession = false;
+
+	double GetWorkMs() const { return m_current[static_cast<std::size_t>(Phase::TOTAL)] - m_current[static_cast<std::size_t>(Phase::WAIT)]; }
+
+	void RecordHitch();
+	void DrawPhaseTable(bool bSession) const;
+};
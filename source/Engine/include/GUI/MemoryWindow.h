@@ -0,0 +1,25 @@
+#pragma once
+
+#if defined(CDEBUG) && defined(CE_MEMORY_TRACKING)
+
+#include "GUI/DebugGUI.h"
+
+namespace CE
+{
+	//
+	// MemoryWindow
+	//
+	// Live bytes, peaks and allocation churn per memory tag, with editable budgets.
+	//
+	class MemoryWindow : public IDebugGUI
+	{
+	public:
+		MemoryWindow() = default;
+		~MemoryWindow() override = default;
+
+		void OnDrawGUI() override;
+		std::string_view GetDebugMenuName() override { return "Memory"; }
+	};
+}
+
+#endif
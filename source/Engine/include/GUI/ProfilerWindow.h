@@ -0,0 +1,34 @@
+#pragma once
+
+#if defined(CDEBUG) && defined(CE_PROFILING)
+
+#include "GUI/DebugGUI.h"
+
+namespace CE
+{
+	//
+	// ProfilerWindow
+	//
+	// Flame graph of one recorded frame per thread, with the frame time history above it to pick
+	// out spikes. Also where traces get exported from.
+	//
+	class ProfilerWindow : public IDebugGUI
+	{
+	public:
+		ProfilerWindow() = default;
+		~ProfilerWindow() override = default;
+
+		void OnDrawGUI() override;
+		std::string_view GetDebugMenuName() override { return "Profiler"; }
+
+	private:
+		// Frames back from the newest, zero follows the latest frame
+		int m_frameOffset = 0;
+		float m_zoom = 1.f;
+		char m_exportPath[256] = "trace.json";
+
+		void DrawFlameGraph(std::size_t frameIndex);
+	};
+}
+
+#endif
@@ -271,6 +271,7 @@ namespace CE
 		void SetAxis(AxisType a, float v)
 		{
 			type = InputEventType::AXIS;
+			axisInfo.axis = a;
 			axisInfo.value = v;
 		}
 
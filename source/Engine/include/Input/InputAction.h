@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Input/Input.h"
+#include "InplaceFunction.h"
 
 #include "stdlibincl.h"
 
@@ -8,8 +9,8 @@ namespace CE
 {
 	class InputAction {
 	public:
-		using Callback = std::function<void()>;
-		using CallbackFloat = std::function<void(float)>;
+		using Callback = InplaceFunction<void()>;
+		using CallbackFloat = InplaceFunction<void(float)>;
 
 		virtual ~InputAction() = default;
 
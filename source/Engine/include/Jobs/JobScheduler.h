@@ -0,0 +1,156 @@
+#pragma once
+
+#include "stdlibincl.h"
+#include "Jobs/WorkStealingQueue.h"
+#include "InplaceFunction.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace CE::Jobs
+{
+	// Stored in place so scheduling never allocates, room for a this pointer and two shared_ptrs
+	using JobFunction = InplaceFunction<void(), 48>;
+
+	struct Job;
+	class JobScheduler;
+
+	//
+	// JobCounter
+	// 
+	// Counts outstanding jobs. Every job scheduled against a counter bumps it and the job finishing
+	// drops it again, so zero means everything is done. Jobs can be made to wait on a counter, they
+	// are held back and scheduled by whichever job takes the counter to zero.
+	// 
+	// Only destroy a counter after Wait on it has returned.
+	//
+	class JobCounter
+	{
+	public:
+		JobCounter() = default;
+
+		JobCounter(const JobCounter&) = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+
+		bool IsDone() const { return m_value.load(std::memory_order_acquire) == 0; }
+		int GetValue() const { return m_value.load(std::memory_order_acquire); }
+
+	private:
+		friend class JobScheduler;
+
+		std::atomic<int> m_value{ 0 };
+		std::mutex m_waitersMutex;
+		std::vector<Job*> m_waiters;
+	};
+
+	struct Job
+	{
+		JobFunction function;
+		JobCounter* counter = nullptr;
+		bool bHeap = false;
+		std::atomic<bool> bFinished{ true };
+	};
+
+	struct SchedulerStats
+	{
+		std::uint64_t executed = 0;
+		std::uint64_t stolen = 0;
+		std::uint64_t heapAllocated = 0;
+	};
+
+	//
+	// JobScheduler
+	// 
+	// One worker thread per core (minus the creating thread) each owning a work-stealing deque.
+	// Idle workers steal from random victims, then sleep until new work shows up. The creating thread
+	// counts as thread zero with its own deque and helps out whenever it waits on a counter.
+	// 
+	// Jobs come from a per-thread ring so scheduling doesn't allocate, a ring slot still in use by an
+	// unfinished job falls back to the heap. Threads the scheduler doesn't know about go through a
+	// locked injection queue.
+	// 
+	// Main-thread jobs queue separately and only run when the main thread calls ProcessMainThreadJobs
+	// or waits on a counter.
+	//
+	class JobScheduler
+	{
+	public:
+		// Zero picks hardware threads minus one
+		explicit JobScheduler(std::size_t workerCount = 0);
+		~JobScheduler();
+
+		JobScheduler(const JobScheduler&) = delete;
+		JobScheduler& operator=(const JobScheduler&) = delete;
+
+		// Counter is bumped before returning. With a dependency the job is held until it reaches zero.
+		void Run(JobFunction function, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+		void RunOnMainThread(JobFunction function, JobCounter* counter = nullptr);
+
+		// Runs other jobs on the calling thread until the counter reaches zero
+		void Wait(JobCounter& counter);
+		void WaitIdle();
+
+		//
+		// ParallelFor
+		// 
+		// Splits [0, count) into batches and calls function(begin, end) for each across all threads,
+		// returns once every batch is done. A batch size of zero picks one from the thread count.
+		//
+		void ParallelFor(std::size_t count, std::size_t batchSize, const std::function<void(std::size_t, std::size_t)>& function);
+
+		void ProcessMainThreadJobs();
+
+		std::size_t GetWorkerCount() const { return m_workers.size(); }
+		std::size_t GetThreadCount() const { return m_threads.size(); }
+		bool IsMainThread() const;
+
+		// 0 on the main thread, 1 to the worker count on workers, -1 on threads this scheduler doesn't own
+		int GetThreadIndex() const;
+
+		SchedulerStats GetStats() const;
+
+	private:
+		static constexpr std::size_t RingSize = 4096;
+
+		struct alignas(64) ThreadState
+		{
+			WorkStealingQueue<Job*, RingSize> queue;
+			std::array<Job, RingSize> jobs;
+			std::uint32_t nextJob = 0;
+			std::uint32_t randomState = 0;
+
+			std::atomic<std::uint64_t> executed{ 0 };
+			std::atomic<std::uint64_t> stolen{ 0 };
+			std::atomic<std::uint64_t> heapAllocated{ 0 };
+		};
+
+		std::vector<std::unique_ptr<ThreadState>> m_threads;
+		std::vector<std::thread> m_workers;
+		std::thread::id m_mainThread;
+
+		std::mutex m_injectionMutex;
+		std::deque<Job*> m_injected;
+		std::atomic<std::size_t> m_injectedCount{ 0 };
+
+		std::mutex m_mainThreadMutex;
+		std::vector<Job*> m_mainThreadJobs;
+
+		std::mutex m_sleepMutex;
+		std::condition_variable m_wakeCondition;
+		std::atomic<int> m_pending{ 0 };
+		std::atomic<int> m_sleepers{ 0 };
+		std::atomic<int> m_active{ 0 };
+		std::atomic<bool> m_bExit{ false };
+
+		Job* AllocateJob(int threadIndex);
+		void Submit(Job* job, int threadIndex);
+		bool TryRunJob(int threadIndex);
+		Job* FindJob(int threadIndex);
+		void Execute(Job* job, int threadIndex);
+		void Finish(Job* job, int threadIndex);
+		void WorkerLoop(int threadIndex);
+	};
+}
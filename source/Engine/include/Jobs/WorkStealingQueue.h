@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+namespace CE::Jobs
+{
+	//
+	// WorkStealingQueue
+	// 
+	// Fixed capacity Chase-Lev deque. The owning thread pushes and pops at the bottom (LIFO, keeps
+	// caches warm), any other thread steals from the top (FIFO, takes the oldest and usually largest
+	// work). Memory orderings follow Le et al. "Correct and Efficient Work-Stealing for Weak Memory
+	// Models". Push fails when full instead of growing, callers fall back to another queue.
+	//
+	template <typename T, std::size_t _Capacity>
+	class WorkStealingQueue
+	{
+		static_assert((_Capacity & (_Capacity - 1)) == 0, "Capacity must be a power of two");
+		static constexpr std::int64_t Mask = static_cast<std::int64_t>(_Capacity) - 1;
+
+	public:
+		WorkStealingQueue() = default;
+
+		WorkStealingQueue(const WorkStealingQueue&) = delete;
+		WorkStealingQueue& operator=(const WorkStealingQueue&) = delete;
+
+		// Owner only
+		bool Push(T item)
+		{
+			const std::int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+			const std::int64_t top = m_top.load(std::memory_order_acquire);
+			if (bottom - top >= static_cast<std::int64_t>(_Capacity))
+			{
+				return false;
+			}
+
+			// Release on bottom rather than a standalone fence, same cost on x86 and sanitizers understand it
+			m_items[bottom & Mask].store(item, std::memory_order_relaxed);
+			m_bottom.store(bottom + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Owner only
+		bool Pop(T& out)
+		{
+			const std::int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+			m_bottom.store(bottom, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			std::int64_t top = m_top.load(std::memory_order_relaxed);
+
+			if (top > bottom)
+			{
+				// Empty
+				m_bottom.store(bottom + 1, std::memory_order_relaxed);
+				return false;
+			}
+
+			out = m_items[bottom & Mask].load(std::memory_order_relaxed);
+			if (top != bottom)
+			{
+				return true;
+			}
+
+			// Last item, race any thieves for it
+			const bool bWon = m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+			m_bottom.store(bottom + 1, std::memory_order_relaxed);
+			return bWon;
+		}
+
+		// Any thread
+		bool Steal(T& out)
+		{
+			std::int64_t top = m_top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			const std::int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+			if (top >= bottom)
+			{
+				return false;
+			}
+
+			T item = m_items[top & Mask].load(std::memory_order_relaxed);
+			if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			{
+				return false;
+			}
+
+			out = item;
+			return true;
+		}
+
+		// Racy, only good for stats and heuristics
+		std::size_t ApproximateSize() const
+		{
+			const std::int64_t size = m_bottom.load(std::memory_order_relaxed) - m_top.load(std::memory_order_relaxed);
+			return size > 0 ? static_cast<std::size_t>(size) : 0;
+		}
+
+		static constexpr std::size_t Capacity() { return _Capacity; }
+
+	private:
+		alignas(64) std::atomic<std::int64_t> m_top{ 0 };
+		alignas(64) std::atomic<std::int64_t> m_bottom{ 0 };
+		alignas(64) std::array<std::atomic<T>, _Capacity> m_items{};
+	};
+}
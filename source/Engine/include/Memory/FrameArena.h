@@ -0,0 +1,78 @@
+#pragma once
+
+#include "stdlibincl.h"
+
+#include <span>
+
+namespace CE::Memory
+{
+	//
+	// FrameArena
+	//
+	// Bump allocator for memory that only has to last until the next Reset. Allocating moves an
+	// offset along a block, Reset hands everything back at once and keeps the blocks, so once the
+	// arena has grown to what a frame needs it stops going to the heap. Allocations bigger than a
+	// block get a block of their own, kept for reuse like the rest.
+	//
+	// Nothing placed in the arena is destroyed, it only takes trivially destructible types.
+	// Not thread safe, one owner allocates and resets.
+	//
+	class FrameArena
+	{
+	public:
+		explicit FrameArena(std::size_t blockSize = 64 * 1024) : m_blockSize(blockSize) {}
+
+		FrameArena(const FrameArena&) = delete;
+		FrameArena& operator=(const FrameArena&) = delete;
+
+		void* Allocate(std::size_t size, std::size_t alignment);
+
+		template <typename T, typename... Args>
+		T* New(Args&&... args)
+		{
+			static_assert(std::is_trivially_destructible_v<T>, "FrameArena never runs destructors");
+			return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+		}
+
+		// Value initialised
+		template <typename T>
+		std::span<T> NewArray(std::size_t count)
+		{
+			static_assert(std::is_trivially_destructible_v<T>, "FrameArena never runs destructors");
+			if (count == 0) { return {}; }
+
+			T* data = static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+			std::uninitialized_value_construct_n(data, count);
+			return { data, count };
+		}
+
+		// Null terminated copy, so it can be handed to C APIs as well
+		std::string_view CopyString(std::string_view text);
+
+		// Everything allocated so far is gone, the blocks stay for the next frame
+		void Reset();
+
+		// Whether the pointer lands in one of the arena's blocks, live allocation or not
+		bool Owns(const void* pointer) const;
+
+		std::size_t GetUsedBytes() const { return m_used; }
+		std::size_t GetPeakBytes() const { return m_peak; }
+		std::size_t GetCapacity() const { return m_capacity; }
+
+	private:
+		struct Block
+		{
+			std::unique_ptr<std::byte[]> data;
+			std::size_t size = 0;
+		};
+
+		std::vector<Block> m_blocks;
+		std::size_t m_blockSize;
+		std::size_t m_current = 0;
+		std::size_t m_offset = 0;
+
+		std::size_t m_used = 0;
+		std::size_t m_peak = 0;
+		std::size_t m_capacity = 0;
+	};
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "stdlibincl.h"
+
+#include <atomic>
+
+namespace CE::Memory
+{
+	// Add new tags here, one per system plus anything worth tracking on its own
+	enum class MemoryTag : std::uint8_t
+	{
+		UNTAGGED,
+		ENGINE,
+		LOG,
+		JOBS,
+		RESOURCES,
+		RENDER,
+		EVENTS,
+		INPUT,
+		WORLD,
+		PHYSICS,
+		DEBUG,
+		PROFILER,
+		COUNT
+	};
+
+	constexpr std::size_t s_tagCount = static_cast<std::size_t>(MemoryTag::COUNT);
+
+	constexpr const char* GetMemoryTagName(MemoryTag tag)
+	{
+		switch (tag)
+		{
+		case MemoryTag::UNTAGGED: return "Untagged";
+		case MemoryTag::ENGINE: return "Engine";
+		case MemoryTag::LOG: return "Log";
+		case MemoryTag::JOBS: return "Jobs";
+		case MemoryTag::RESOURCES: return "Resources";
+		case MemoryTag::RENDER: return "Render";
+		case MemoryTag::EVENTS: return "Events";
+		case MemoryTag::INPUT: return "Input";
+		case MemoryTag::WORLD: return "World";
+		case MemoryTag::PHYSICS: return "Physics";
+		case MemoryTag::DEBUG: return "Debug";
+		case MemoryTag::PROFILER: return "Profiler";
+		default: return "";
+		}
+	}
+
+	// Case sensitive match against GetMemoryTagName, COUNT when nothing matches
+	MemoryTag FindMemoryTag(std::string_view name);
+
+	struct TagStats
+	{
+		std::int64_t liveBytes = 0;
+		std::int64_t liveAllocations = 0;
+		std::int64_t peakBytes = 0;
+		std::uint64_t totalAllocations = 0;
+		std::uint64_t frameAllocations = 0;
+		std::size_t budget = 0;
+	};
+
+	//
+	// MemoryTracker
+	//
+	// Attributes every heap allocation to the tag active on the allocating thread. The global
+	// operator new and delete are replaced when CE_MEMORY_TRACKING is defined, each block carries
+	// a small header with its size and tag so frees land on the tag that allocated them. The engine
+	// tags each system's calls, MEMORY_SCOPE narrows that further inside a system.
+	//
+	class MemoryTracker
+	{
+	public:
+		static MemoryTracker& Get();
+
+		// Tag for new allocations on this thread, prefer MEMORY_SCOPE over setting it by hand
+		static MemoryTag GetThreadTag();
+		static void SetThreadTag(MemoryTag tag);
+
+		// Called from the allocation hooks, safe from any thread
+		void OnAllocate(MemoryTag tag, std::size_t size);
+		void OnFree(MemoryTag tag, std::size_t size);
+
+		// Zero means no budget
+		void SetBudget(MemoryTag tag, std::size_t bytes);
+		std::size_t GetBudget(MemoryTag tag) const;
+
+		// Samples per frame allocation counts and warns once for each tag that crosses its budget,
+		// call once a frame from the thread driving frames
+		void EndFrame();
+
+		TagStats GetStats(MemoryTag tag) const;
+
+		static constexpr bool IsTrackingEnabled()
+		{
+#ifdef CE_MEMORY_TRACKING
+			return true;
+#else
+			return false;
+#endif
+		}
+
+	private:
+		constexpr MemoryTracker() = default;
+
+		// Own cache line each so threads hammering different tags don't contend
+		struct alignas(64) TagCounters
+		{
+			std::atomic<std::int64_t> liveBytes = 0;
+			std::atomic<std::int64_t> liveAllocations = 0;
+			std::atomic<std::int64_t> peakBytes = 0;
+			std::atomic<std::uint64_t> totalAllocations = 0;
+			std::atomic<std::size_t> budget = 0;
+		};
+
+		std::array<TagCounters, s_tagCount> m_counters;
+
+		// Frame thread only
+		std::array<std::uint64_t, s_tagCount> m_lastTotals{};
+		std::array<std::uint64_t, s_tagCount> m_frameAllocations{};
+		std::array<bool, s_tagCount> m_bOverBudget{};
+	};
+
+	class MemoryScope
+	{
+	public:
+		explicit MemoryScope(MemoryTag tag) :
+			m_previous(MemoryTracker::GetThreadTag())
+		{
+			MemoryTracker::SetThreadTag(tag);
+		}
+
+		~MemoryScope()
+		{
+			MemoryTracker::SetThreadTag(m_previous);
+		}
+
+		MemoryScope(const MemoryScope&) = delete;
+		MemoryScope& operator=(const MemoryScope&) = delete;
+
+	private:
+		MemoryTag m_previous;
+	};
+}
+
+//
+// MEMORY_SCOPE
+//
+// Attributes allocations made until the end of the enclosing scope to the given tag. Compiles away
+// unless CE_MEMORY_TRACKING is defined.
+//
+#ifdef CE_MEMORY_TRACKING
+#define MEMORY_CONCAT_INNER(a, b) a##b
+#define MEMORY_CONCAT(a, b) MEMORY_CONCAT_INNER(a, b)
+#define MEMORY_SCOPE(tag) ::CE::Memory::MemoryScope MEMORY_CONCAT(memoryScope, __LINE__)(tag)
+#else
+#define MEMORY_SCOPE(tag)
+#endif
@@ -0,0 +1,190 @@
+#pragma once
+
+#include "stdlibincl.h"
+#include "Handle.h"
+
+#include <glm/glm.hpp>
+
+namespace CE::Physics
+{
+	enum class ShapeType : std::uint8_t
+	{
+		SPHERE,
+		BOX
+	};
+
+	using BodyID = std::uint32_t;
+	constexpr BodyID InvalidBody = std::numeric_limits<BodyID>::max();
+
+	struct BodyDesc
+	{
+		ShapeType shape = ShapeType::SPHERE;
+		glm::vec3 position = glm::vec3(0.f);
+		glm::vec3 velocity = glm::vec3(0.f);
+
+		// Spheres use radius, boxes use halfExtents. Boxes are always axis aligned.
+		float radius = 0.5f;
+		glm::vec3 halfExtents = glm::vec3(0.5f);
+
+		// Zero mass makes the body static
+		float mass = 1.f;
+		float restitution = 0.2f;
+		float friction = 0.5f;
+
+		ComponentHandle user = ComponentHandle::INVALID;
+	};
+
+	struct Contact
+	{
+		std::uint32_t a;
+		std::uint32_t b;
+		glm::vec3 normal; // Points from a to b
+		float depth;
+	};
+
+	struct SceneStats
+	{
+		std::size_t bodies = 0;
+		std::size_t awake = 0;
+		std::size_t pairs = 0;
+		std::size_t contacts = 0;
+		std::size_t islands = 0;
+		std::size_t sleepingIslands = 0;
+
+		double broadphaseMs = 0.0;
+		double narrowphaseMs = 0.0;
+		double solveMs = 0.0;
+		double totalMs = 0.0;
+	};
+
+	//
+	// PhysicsScene
+	//	- Linear rigid body dynamics only, bodies never rotate
+	//	- Body data lives in parallel arrays (SoA) indexed densely, BodyIDs are stable and map to
+	//	  dense slots through an indirection table so removal can swap-remove
+	//	- Broadphase is sweep and prune along X over a persistently sorted order (insertion sort,
+	//	  frame to frame coherence keeps it near linear), Y/Z overlap tests are SIMD where available
+	//	- Bodies touching through contacts form islands, islands solve independently and in
+	//	  parallel, and fall asleep together once everything in them has come to rest
+	// 
+	// No engine dependencies, runs fine headless.
+	//
+	class PhysicsScene
+	{
+	public:
+		PhysicsScene() = default;
+
+		BodyID AddBody(const BodyDesc& desc);
+		void RemoveBody(BodyID id);
+		void Clear();
+
+		bool IsValid(BodyID id) const;
+		std::size_t GetBodyCount() const { return m_posX.size(); }
+
+		glm::vec3 GetPosition(BodyID id) const;
+		glm::vec3 GetVelocity(BodyID id) const;
+		ComponentHandle GetUser(BodyID id) const;
+		bool IsAsleep(BodyID id) const;
+		bool IsStatic(BodyID id) const;
+
+		void SetPosition(BodyID id, const glm::vec3& position);
+		void SetVelocity(BodyID id, const glm::vec3& velocity);
+		void ApplyImpulse(BodyID id, const glm::vec3& impulse);
+		void Wake(BodyID id);
+
+		template <typename Function>
+		void ForEachBody(Function&& function) const
+		{
+			for (BodyID id : m_denseToId)
+			{
+				function(id);
+			}
+		}
+
+		void Step(float deltaTime);
+
+		const SceneStats& GetStats() const { return m_stats; }
+
+		glm::vec3 m_gravity = glm::vec3(0.f, -9.81f, 0.f);
+		int m_solverIterations = 8;
+		float m_sleepVelocity = 0.05f;
+		float m_timeToSleep = 0.5f;
+
+		// Set to spread island solves over a job scheduler, called with the island count and a
+		// function to invoke once per island index. Runs serially when unset.
+		std::function<void(std::size_t, const std::function<void(std::size_t)>&)> m_parallelFor;
+
+	private:
+		// Body storage, every array is indexed by dense slot
+		std::vector<float> m_posX, m_posY, m_posZ;
+		std::vector<float> m_velX, m_velY, m_velZ;
+		std::vector<float> m_extX, m_extY, m_extZ;
+		std::vector<float> m_radius;
+		std::vector<float> m_invMass;
+		std::vector<float> m_restitution;
+		std::vector<float> m_friction;
+		std::vector<float> m_sleepTimer;
+		std::vector<ShapeType> m_shape;
+		std::vector<std::uint8_t> m_awake;
+		std::vector<ComponentHandle> m_user;
+
+		std::vector<BodyID> m_denseToId;
+		std::vector<std::uint32_t> m_idToDense;
+		std::vector<BodyID> m_freeIds;
+
+		// Broadphase, sorted arrays are padded so SIMD loads can run off the end safely
+		std::vector<std::uint32_t> m_order;
+		bool m_bOrderDirty = true;
+		std::vector<float> m_minX, m_maxX, m_minY, m_maxY, m_minZ, m_maxZ;
+		std::vector<float> m_sortedMinX, m_sortedMaxX, m_sortedMinY, m_sortedMaxY, m_sortedMinZ, m_sortedMaxZ;
+		std::vector<std::uint8_t> m_sortedActive;
+		std::vector<std::pair<std::uint32_t, std::uint32_t>> m_pairs;
+
+		// Narrowphase and solver
+		struct ContactConstraint
+		{
+			float normalMass;
+			float bias;
+			float restitutionTarget;
+			float friction;
+			float normalImpulse;
+			float tangentImpulse1;
+			float tangentImpulse2;
+		};
+
+		std::vector<Contact> m_contacts;
+		std::vector<ContactConstraint> m_constraints;
+
+		// Islands, bodies and contacts grouped back to back with ranges per island
+		struct Island
+		{
+			std::uint32_t bodyBegin, bodyEnd;
+			std::uint32_t contactBegin, contactEnd;
+			bool bAwake;
+		};
+
+		std::vector<std::uint32_t> m_parent;
+		std::vector<std::uint32_t> m_islandOf;
+		std::vector<Island> m_islands;
+		std::vector<std::uint32_t> m_islandBodies;
+		std::vector<std::uint32_t> m_islandContacts;
+
+		SceneStats m_stats;
+
+		bool IsDynamic(std::uint32_t index) const { return m_invMass[index] > 0.f; }
+		bool IsActive(std::uint32_t index) const { return m_invMass[index] > 0.f && m_awake[index]; }
+
+		void IntegrateVelocities(float deltaTime);
+		void UpdateBounds();
+		void SortAxis();
+		void FindPairs();
+		void FindContacts();
+		void BuildIslands();
+		void SolveIsland(const Island& island, float deltaTime);
+		void IntegratePositions(float deltaTime);
+		void UpdateSleep(float deltaTime);
+
+		std::uint32_t FindRoot(std::uint32_t index);
+		void WakeDense(std::uint32_t index);
+	};
+}
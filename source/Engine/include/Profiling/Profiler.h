@@ -0,0 +1,172 @@
+#pragma once
+
+#include "stdlibincl.h"
+
+#include <atomic>
+#include <mutex>
+
+namespace CE::Profiling
+{
+	// Nanoseconds since the profiler started
+	using Timestamp = std::int64_t;
+
+	struct ScopeEvent
+	{
+		// Must outlive the profiler, scopes are expected to be string literals
+		const char* name = nullptr;
+		Timestamp begin = 0;
+		Timestamp end = 0;
+		std::uint32_t depth = 0;
+		std::uint32_t thread = 0;
+	};
+
+	struct FrameRecord
+	{
+		std::uint64_t index = 0;
+		Timestamp begin = 0;
+		Timestamp end = 0;
+		std::uint32_t thread = 0;
+		std::vector<ScopeEvent> events;
+
+		double GetDurationMs() const { return static_cast<double>(end - begin) / 1000000.0; }
+	};
+
+	//
+	// Profiler
+	//
+	// Collects timed scopes from every thread. Each thread writes into its own ring buffer without
+	// locking, the thread driving frames drains them all at EndFrame into a short history of frames
+	// which the flame graph window draws and ExportChromeTrace writes out for chrome://tracing.
+	// A full ring drops new scopes rather than blocking, see GetDroppedEvents.
+	//
+	class Profiler
+	{
+	public:
+		static constexpr std::size_t s_threadCapacity = 1 << 14;
+		static constexpr std::size_t s_historySize = 300;
+
+		static Profiler& Get();
+
+		Profiler(const Profiler&) = delete;
+		Profiler& operator=(const Profiler&) = delete;
+
+		// Runtime switch, a disabled profiler costs one relaxed load per scope
+		void SetEnabled(bool bEnabled) { m_bEnabled.store(bEnabled, std::memory_order_relaxed); }
+		bool IsEnabled() const { return m_bEnabled.load(std::memory_order_relaxed); }
+
+		// Frames keep draining while paused so buffers never fill, they just aren't kept
+		void SetPaused(bool bPaused) { m_bPaused = bPaused; }
+		bool IsPaused() const { return m_bPaused; }
+
+		// Shows up in the flame graph and as the thread name in exported traces
+		void SetThreadName(std::string name);
+
+		void BeginFrame();
+		void EndFrame();
+
+		Timestamp Now() const;
+
+		// Scope recording for the calling thread, BeginScope returns the depth to hand back to EndScope
+		std::uint32_t BeginScope();
+		void EndScope(const char* name, Timestamp begin, std::uint32_t depth);
+
+		// Zero is the oldest kept frame, GetFrameCount() - 1 the newest
+		std::size_t GetFrameCount() const { return m_frameCount; }
+		const FrameRecord& GetFrame(std::size_t index) const;
+
+		std::vector<std::string> GetThreadNames() const;
+		std::uint64_t GetDroppedEvents() const;
+
+		// Everything in the history, or just the given frames
+		bool ExportChromeTrace(const std::filesystem::path& path) const;
+		bool ExportChromeTrace(const std::filesystem::path& path, const std::vector<const FrameRecord*>& frames) const;
+
+	private:
+		Profiler();
+
+		struct ThreadBuffer
+		{
+			std::unique_ptr<ScopeEvent[]> events;
+			std::atomic<std::uint64_t> head = 0;
+			std::atomic<std::uint64_t> tail = 0;
+			std::atomic<std::uint64_t> dropped = 0;
+			std::uint32_t index = 0;
+			std::uint32_t depth = 0;
+			std::string name;
+			bool bRetired = false;
+		};
+
+		// Hands the calling thread's buffer back when it exits so short lived threads don't pile up buffers
+		struct ThreadRetirer
+		{
+			bool bRegistered = false;
+			~ThreadRetirer();
+		};
+
+		ThreadBuffer& GetThreadBuffer();
+		void RetireThreadBuffer();
+		static thread_local ThreadBuffer* t_buffer;
+		static thread_local ThreadRetirer t_retirer;
+
+		std::chrono::steady_clock::time_point m_epoch;
+		std::atomic<bool> m_bEnabled = true;
+		bool m_bPaused = false;
+
+		// Buffers live as long as the profiler, a thread that exits leaves its buffer for the next new thread
+		mutable std::mutex m_threadsMutex;
+		std::vector<std::unique_ptr<ThreadBuffer>> m_threads;
+
+		std::vector<FrameRecord> m_frames;
+		std::size_t m_frameHead = 0;
+		std::size_t m_frameCount = 0;
+		std::uint64_t m_frameIndex = 0;
+		Timestamp m_frameBegin = 0;
+	};
+
+	class ScopedTimer
+	{
+	public:
+		explicit ScopedTimer(const char* name)
+		{
+			Profiler& profiler = Profiler::Get();
+			if (profiler.IsEnabled())
+			{
+				m_name = name;
+				m_depth = profiler.BeginScope();
+				m_begin = profiler.Now();
+			}
+		}
+
+		~ScopedTimer()
+		{
+			if (m_name != nullptr)
+			{
+				Profiler::Get().EndScope(m_name, m_begin, m_depth);
+			}
+		}
+
+		ScopedTimer(const ScopedTimer&) = delete;
+		ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+	private:
+		const char* m_name = nullptr;
+		Timestamp m_begin = 0;
+		std::uint32_t m_depth = 0;
+	};
+}
+
+//
+// PROFILE_SCOPE
+//
+// Times the enclosing scope under the given name, which must be a string literal. Compiles away
+// entirely unless CE_PROFILING is defined.
+//
+#ifdef CE_PROFILING
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ::CE::Profiling::ScopedTimer PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__func__)
+#else
+#define PROFILE_SCOPE(name)
+#define PROFILE_FUNCTION()
+#endif
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "stdlibincl.h"
+#include "Input/Input.h"
+
+namespace CE::Replay
+{
+	struct ReplayHeader
+	{
+		std::uint32_t seed = 0;
+		double tickRate = 60.0;
+
+		// Patched in when the recording is closed, zero if it never was
+		std::uint64_t frameCount = 0;
+	};
+
+	struct ReplayFrame
+	{
+		// Exactly what Engine::Simulate was handed
+		double deltaTime = 0.0;
+
+		// Input was processed at the start of the frame rather than the end, see Engine::CoreLoop
+		bool bInputFirst = false;
+
+		// What the simulation posted, replays compare against this to catch divergence
+		std::uint32_t eventsPosted = 0;
+
+		std::vector<InputEvent> inputs;
+	};
+
+	//
+	// ReplayWriter
+	//
+	// Streams frames out to a compact little endian binary file as they happen. Everything the
+	// simulation doesn't produce itself is in there, inputs, frame times and the random seed, so
+	// playing it back runs the same frames no matter how fast the machine is.
+	//
+	class ReplayWriter
+	{
+	public:
+		ReplayWriter() = default;
+		~ReplayWriter();
+
+		ReplayWriter(const ReplayWriter&) = delete;
+		ReplayWriter& operator=(const ReplayWriter&) = delete;
+
+		bool Open(const std::filesystem::path& path, const ReplayHeader& header);
+		void Close();
+		bool IsOpen() const { return m_file.is_open(); }
+
+		// Fails without writing anything if the frame has more inputs than the format can count, or
+		// on a write error. The frames written before it still make a valid recording.
+		bool WriteFrame(const ReplayFrame& frame);
+
+		std::uint64_t GetFrameCount() const { return m_frameCount; }
+
+	private:
+		std::ofstream m_file;
+		std::uint64_t m_frameCount = 0;
+	};
+
+	//
+	// ReplayReader
+	//
+	// Reads back what ReplayWriter wrote, a frame at a time.
+	//
+	class ReplayReader
+	{
+	public:
+		bool Open(const std::filesystem::path& path);
+		void Close();
+		bool IsOpen() const { return m_file.is_open(); }
+
+		const ReplayHeader& GetHeader() const { return m_header; }
+
+		// False once the recording runs out or the file is cut short
+		bool ReadFrame(ReplayFrame& frame);
+
+		std::uint64_t GetFrameIndex() const { return m_frameIndex; }
+
+	private:
+		std::ifstream m_file;
+		ReplayHeader m_header;
+		std::uint64_t m_frameIndex = 0;
+	};
+}
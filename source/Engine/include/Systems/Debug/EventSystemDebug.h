@@ -18,6 +18,14 @@ namespace CE
 		/* IDebugGUISubscriber Interface */
 		void OnDrawGUI() override;
 		std::string_view GetDebugMenuName() override { return "Events"; }
+
+#ifdef CE_EVENT_STATS
+	private:
+		char m_exportPath[256] = "event_stats.json";
+
+		void DrawQueueStats();
+		void DrawListenerStats();
+#endif
 	};
 }
 #endif
\ No newline at end of file
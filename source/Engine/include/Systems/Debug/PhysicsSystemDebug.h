@@ -0,0 +1,24 @@
+#pragma once
+
+#ifdef CDEBUG
+
+#include "GUI/DebugGUI.h"
+
+namespace CE
+{
+	class PhysicsSystem;
+
+	class PhysicsSystemDebug : public IDebugGUI
+	{
+		PhysicsSystem* m_owner;
+
+	public:
+		PhysicsSystemDebug(PhysicsSystem* owner) : m_owner(owner) {}
+		~PhysicsSystemDebug() override = default;
+
+		void OnDrawGUI() override;
+		std::string_view GetDebugMenuName() override { return "Physics"; }
+	};
+}
+
+#endif
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "stdlibincl.h"
+#include "Memory/MemoryTracker.h"
 
 namespace CE
 {
@@ -10,6 +11,14 @@ namespace CE
 	class IDebugGUI;
 #endif
 
+	using SystemDependencies = std::vector<std::type_index>;
+
+	//
+	// EngineSystem
+	//
+	// Systems declare which others must be started before them and the engine starts everything
+	// else concurrently on the job workers, shutting down in the reverse of the order they came up.
+	//
 	class EngineSystem
 	{
 	protected:
@@ -29,6 +38,15 @@ namespace CE
 
 		virtual std::string Name() const = 0;
 
+		// Systems that have to finish starting before this one starts, declared by type
+		virtual SystemDependencies GetDependencies() const { return {}; }
+
+		// Startup touches something only the main thread may, like the GL context or window callbacks
+		virtual bool RequiresMainThread() const { return false; }
+
+		// Allocations made during this system's startup, shutdown and per frame calls are counted here
+		virtual Memory::MemoryTag GetMemoryTag() const { return Memory::MemoryTag::ENGINE; }
+
 		Engine* m_engine;
 	};
 }
\ No newline at end of file
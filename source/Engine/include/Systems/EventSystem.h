@@ -32,27 +32,24 @@
 
 #include "Systems/EngineSystem.h"
 #include "Systems/LogSystem.h"
+#include "Systems/Events/EventQueue.h"
+#include "Memory/FrameArena.h"
 
-#include "ObjectPool.h"
+#include "InternedString.h"
 #include "stdlibincl.h"
 
+#include <cstring>
+
 
 namespace CE
 {
-	
-	// Used for compile-time assurance of events
-	struct Event { };
-
-	template <typename T>
-	concept IsEvent = std::is_base_of_v<Event, T>;
-
 	struct TestEvent : Event
 	{
 		TestEvent() : someData(10), moreData(2.f), someString("Test") {}
 
 		int someData;
 		float moreData;
-		std::string someString;
+		InternedString someString;
 	};
 
 	struct GameplayEvent : Event
@@ -60,146 +57,258 @@ namespace CE
 		int message;
 	};
 
-	template <IsEvent EType>
-	class Listener
+#ifdef CDEBUG
+	class EventSystemDebug;
+#endif
+
+	class EventSystem final : public EngineSystem
 	{
 	public:
-		explicit Listener(std::function<void(const EType&)> callable) : m_callable(callable) {}
-		~Listener() {}
+		explicit EventSystem(Engine* engine);
+
+		/* EngineSystem Interface */
+	public:
+		std::string Name() const override { return "Event System"; }
+		Memory::MemoryTag GetMemoryTag() const override { return Memory::MemoryTag::EVENTS; }
+		SystemDependencies GetDependencies() const override;
+	protected:
+		void Startup() override;
+		void Shutdown() override;
+		friend class Engine;
+
+#ifdef CDEBUG
+		friend class EventSystemDebug;
+#endif
 
-		void Fire(const EType& e)
+		/* Event System API */
+	public:
+		// Main thread only, add queues up front, before any worker could be posting. Lower priorities
+		// dispatch first each pass, queues with the same priority go in the order they were added.
+		template <typename EType>
+		EventQueue<EType>* AddQueue(int priority = 0)
 		{
-			if (m_callable)
+			const EventTypeID id = GetEventTypeID<EType>();
+			if (id >= m_queues.size())
 			{
-				m_callable(e);
+				m_queues.resize(id + 1);
 			}
+
+			QueueSlot& slot = m_queues[id];
+			if (slot.queue == nullptr)
+			{
+				EventQueue<EType>* queue = new EventQueue<EType>();
+				queue->SetScheduler(m_scheduler);
+				slot.queue = queue;
+				slot.priority = priority;
+				slot.order = m_queueCount++;
+				RebuildDispatchOrder();
+			}
+			return static_cast<EventQueue<EType>*>(slot.queue);
 		}
 
-		std::function<void(const EType&)> m_callable;
-	};
+		// Null if the queue was never added, posting and registering log the miss themselves
+		template <typename EType>
+		EventQueue<EType>* GetQueue()
+		{
+			const EventTypeID id = GetEventTypeID<EType>();
+			return id < m_queues.size() ? static_cast<EventQueue<EType>*>(m_queues[id].queue) : nullptr;
+		}
 
-	class IEventQueue
-	{
-	public:
-		virtual void Process() = 0;
-		virtual std::string_view GetQueueName() = 0;
-	};
+		template <typename EType>
+		void SetQueuePriority(int priority)
+		{
+			const EventTypeID id = GetEventTypeID<EType>();
+			if (id < m_queues.size() && m_queues[id].queue)
+			{
+				m_queues[id].priority = priority;
+				RebuildDispatchOrder();
+			}
+		}
 
-	template <IsEvent EType>
-	class EventQueue : public IEventQueue
-	{
-	public:
-		EventQueue() : m_queue(), m_listeners()
+		// Frame memory for what an event points at, text or arrays too big to carry by value. Lasts
+		// through the ProcessEvents that dispatches the event, even when a cascade overflow holds it
+		// over to the next one. Main thread only and only for immediate or deferred events, delayed
+		// ones outlive it and posting one that points here asserts. Text that repeats belongs in an
+		// InternedString.
+		template <typename T, typename... Args>
+		T* AllocatePayload(Args&&... args)
 		{
-			m_name = typeid(EType).name();
+			assert(IsMainThread() && "Frame payloads are main thread only");
+			return GetFrameArena().New<T>(std::forward<Args>(args)...);
 		}
-		~EventQueue() {}
 
-		void PostEvent(EType event)
+		template <typename T>
+		std::span<T> AllocatePayloadArray(std::size_t count)
 		{
-			// Copy event into queue
-			m_queue.push(std::move(event));
+			assert(IsMainThread() && "Frame payloads are main thread only");
+			return GetFrameArena().NewArray<T>(count);
 		}
 
-		void RegisterGlobalListener(std::function<void(const EType&)> callback)
+		std::string_view CopyPayloadText(std::string_view text)
 		{
-			// Create listener, return handle?
-			m_listeners.emplace_back(Listener<EType>(callback));
+			assert(IsMainThread() && "Frame payloads are main thread only");
+			return GetFrameArena().CopyString(text);
 		}
 
-		template <typename Instance>
-		void RegisterGlobalListener(Instance* instance, void (Instance::*memberFunc)(const EType&))
+		// Passes ProcessEvents may run for events posted during dispatch, the rest wait for next frame
+		void SetCascadeBudget(std::uint32_t passes) { m_cascadeBudget = std::max(passes, 1u); }
+
+		// Safe from job workers as well as the main thread
+		template <typename Posted>
+		void PostEvent(Posted&& event)
 		{
-			auto callback = [instance, memberFunc](const EType& event) {
-				(instance->*memberFunc)(event);
-				};
-			RegisterGlobalListener(callback);
+			using EType = std::remove_cvref_t<Posted>;
+			auto queue = GetQueue<EType>();
+			if (queue)
+			{
+				assert((queue->GetDelivery() != EventDelivery::DELAYED || !HoldsFramePayload(event)) && "Delayed events outlive frame payloads, copy or intern what they point at");
+				queue->PostEvent(std::forward<Posted>(event));
+				m_postedCount.fetch_add(1, std::memory_order_relaxed);
+			}
+			else
+			{
+				LOG_ERROR(EVENTS, "Failed to post event! Could not find Queue type.");
+#if CDEBUG
+				throw std::runtime_error("No queue found for this event type.");
+#endif
+			}
 		}
 
-		void Process() override
+		// Overrides the queue's delivery for this one post
+		template <typename Posted> requires IsEvent<std::remove_cvref_t<Posted>>
+		void PostEvent(Posted&& event, EventDelivery delivery)
 		{
-			while (!m_queue.empty())
+			if (auto queue = GetQueueToPost<std::remove_cvref_t<Posted>>())
 			{
-				auto top = m_queue.front();
-				m_queue.pop();
+				assert((delivery != EventDelivery::DELAYED || !HoldsFramePayload(event)) && "Delayed events outlive frame payloads, copy or intern what they point at");
+				queue->PostEvent(std::forward<Posted>(event), delivery);
+				m_postedCount.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
 
-				for (auto listener : m_listeners)
-				{
-					listener.Fire(top);
-				}
+		// Delivered on the first ProcessEvents at least this many seconds of simulation time from now
+		template <typename Posted> requires IsEvent<std::remove_cvref_t<Posted>>
+		void PostEventAfter(Posted&& event, double seconds)
+		{
+			if (auto queue = GetQueueToPost<std::remove_cvref_t<Posted>>())
+			{
+				assert(!HoldsFramePayload(event) && "Delayed events outlive frame payloads, copy or intern what they point at");
+				queue->PostEventAfter(std::forward<Posted>(event), seconds);
+				m_postedCount.fetch_add(1, std::memory_order_relaxed);
 			}
 		}
 
-		std::string_view GetQueueName() override
+		// How posts without a delivery of their own reach this type's listeners, deferred by default
+		template <typename EType>
+		void SetDelivery(EventDelivery delivery, double delaySeconds = 0.0)
 		{
-			return m_name;
+			if (auto queue = GetQueue<EType>())
+			{
+				queue->SetDelivery(delivery, delaySeconds);
+			}
 		}
 
-	private:
-		std::queue<EType> m_queue;
-		std::vector<Listener<EType>> m_listeners;
-		std::string_view m_name;
-	};
+		// Constructs the event directly in its queue, null if there is no queue for it
+		template <typename EType, typename... Args>
+		EType* EmplaceEvent(Args&&... args)
+		{
+			auto queue = GetQueue<EType>();
+			if (queue)
+			{
+				m_postedCount.fetch_add(1, std::memory_order_relaxed);
+				return &queue->EmplaceEvent(std::forward<Args>(args)...);
+			}
 
-#ifdef CDEBUG
-	class EventSystemDebug;
+			LOG_ERROR(EVENTS, "Failed to post event! Could not find Queue type.");
+#if CDEBUG
+			throw std::runtime_error("No queue found for this event type.");
 #endif
+			return nullptr;
+		}
 
-	class EventSystem final : public EngineSystem
-	{
-	public:
-		explicit EventSystem(Engine* engine);
-
-		/* EngineSystem Interface */
-	public:
-		std::string Name() const override { return "Event System"; }
-	protected:
-		void Startup() override;
-		void Shutdown() override;
-		friend class Engine;
-
-#ifdef CDEBUG
-		friend class EventSystemDebug;
+		template <typename EType>
+		ListenerHandle RegisterGlobalListener(typename Listener<EType>::Callable callback, std::source_location location = std::source_location::current())
+		{
+			auto queue = GetQueue<EType>();
+			if (queue)
+			{
+				return queue->RegisterGlobalListener(std::move(callback), location);
+			}
+			else
+			{
+				LOG_ERROR(EVENTS, "Failed to Register Listener! Could not find Queue type.");
+#if CDEBUG
+				throw std::runtime_error("No queue found for this event type.");
 #endif
+			}
+			return ListenerHandle::INVALID;
+		}
 
-		/* Event System API */
-	public:
-		template <typename EType>
-		EventQueue<EType>* AddQueue()
+		template <typename EType, typename Instance>
+		ListenerHandle RegisterGlobalListener(Instance* instance, void (Instance::* memberFunc)(const EType&), std::source_location location = std::source_location::current())
 		{
-			auto typeIndex = std::type_index(typeid(EType));
-			
-			EventQueue<EType>* queue = GetQueue<EType>();
-			if (queue == nullptr)
+			auto queue = GetQueue<EType>();
+			if (queue)
 			{
-				queue = new EventQueue<EType>();
-				m_queues[typeIndex] = queue;
+				return queue->RegisterGlobalListener(instance, memberFunc, location);
 			}
-			return queue;
+			else
+			{
+				LOG_ERROR(EVENTS, "Failed to Register Listener! Could not find Queue type.");
+#if CDEBUG
+				throw std::runtime_error("No queue found for this event type.");
+#endif
+			}
+			return ListenerHandle::INVALID;
 		}
 
 		template <typename EType>
-		EventQueue<EType>* GetQueue()
+		ListenerHandle RegisterBatchListener(typename BatchListener<EType>::Callable callback, std::source_location location = std::source_location::current())
 		{
-			auto typeIndex = std::type_index(typeid(EType));
-			auto it = m_queues.find(typeIndex);
-			if (it != m_queues.end())
+			auto queue = GetQueue<EType>();
+			if (queue)
 			{
-				return static_cast<EventQueue<EType>*>(it->second);
+				return queue->RegisterBatchListener(std::move(callback), location);
+			}
+			else
+			{
+				LOG_ERROR(EVENTS, "Failed to Register Listener! Could not find Queue type.");
+#if CDEBUG
+				throw std::runtime_error("No queue found for this event type.");
+#endif
 			}
+			return ListenerHandle::INVALID;
+		}
 
-			LOG_WARN(EVENTS, "Failed to GetQueue");
-			//LOG_WARN(EVENTS, "Failed to GetQueue of type {}", typeid(EType).name());
-			return nullptr;
+		template <typename EType, typename Instance>
+		ListenerHandle RegisterBatchListener(Instance* instance, void (Instance::* memberFunc)(std::span<const EType>), std::source_location location = std::source_location::current())
+		{
+			auto queue = GetQueue<EType>();
+			if (queue)
+			{
+				return queue->RegisterBatchListener(instance, memberFunc, location);
+			}
+			else
+			{
+				LOG_ERROR(EVENTS, "Failed to Register Listener! Could not find Queue type.");
+#if CDEBUG
+				throw std::runtime_error("No queue found for this event type.");
+#endif
+			}
+			return ListenerHandle::INVALID;
 		}
 
-		template <typename EType>
-		void PostEvent(const EType& event)
+		// Only reaches listeners registered against the target, not the global ones
+		template <typename Posted>
+		void PostEvent(const EntityHandle& target, Posted&& event)
 		{
+			using EType = std::remove_cvref_t<Posted>;
 			auto queue = GetQueue<EType>();
 			if (queue)
 			{
-				queue->PostEvent(event);
+				assert((queue->GetDelivery() != EventDelivery::DELAYED || !HoldsFramePayload(event)) && "Delayed events outlive frame payloads, copy or intern what they point at");
+				queue->PostEvent(target, std::forward<Posted>(event));
+				m_postedCount.fetch_add(1, std::memory_order_relaxed);
 			}
 			else
 			{
@@ -210,13 +319,52 @@ namespace CE
 			}
 		}
 
+		template <typename Posted> requires IsEvent<std::remove_cvref_t<Posted>>
+		void PostEvent(const EntityHandle& target, Posted&& event, EventDelivery delivery)
+		{
+			if (auto queue = GetQueueToPost<std::remove_cvref_t<Posted>>())
+			{
+				assert((delivery != EventDelivery::DELAYED || !HoldsFramePayload(event)) && "Delayed events outlive frame payloads, copy or intern what they point at");
+				queue->PostEvent(target, std::forward<Posted>(event), delivery);
+				m_postedCount.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+
+		template <typename Posted> requires IsEvent<std::remove_cvref_t<Posted>>
+		void PostEventAfter(const EntityHandle& target, Posted&& event, double seconds)
+		{
+			if (auto queue = GetQueueToPost<std::remove_cvref_t<Posted>>())
+			{
+				assert(!HoldsFramePayload(event) && "Delayed events outlive frame payloads, copy or intern what they point at");
+				queue->PostEventAfter(target, std::forward<Posted>(event), seconds);
+				m_postedCount.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+
+		template <typename EType, typename... Args>
+		EType* EmplaceTargetedEvent(const EntityHandle& target, Args&&... args)
+		{
+			auto queue = GetQueue<EType>();
+			if (queue)
+			{
+				m_postedCount.fetch_add(1, std::memory_order_relaxed);
+				return &queue->EmplaceTargetedEvent(target, std::forward<Args>(args)...);
+			}
+
+			LOG_ERROR(EVENTS, "Failed to post event! Could not find Queue type.");
+#if CDEBUG
+			throw std::runtime_error("No queue found for this event type.");
+#endif
+			return nullptr;
+		}
+
 		template <typename EType>
-		void RegisterGlobalListener(std::function<void(const EType&)> callback)
+		ListenerHandle RegisterTargetedListener(const EntityHandle& target, typename Listener<EType>::Callable callback, std::source_location location = std::source_location::current())
 		{
 			auto queue = GetQueue<EType>();
 			if (queue)
 			{
-				queue->RegisterGlobalListener(callback);
+				return queue->RegisterTargetedListener(target, std::move(callback), location);
 			}
 			else
 			{
@@ -225,15 +373,16 @@ namespace CE
 				throw std::runtime_error("No queue found for this event type.");
 #endif
 			}
+			return ListenerHandle::INVALID;
 		}
 
 		template <typename EType, typename Instance>
-		void RegisterGlobalListener(Instance* instance, void (Instance::* memberFunc)(const EType&))
+		ListenerHandle RegisterTargetedListener(const EntityHandle& target, Instance* instance, void (Instance::* memberFunc)(const EType&), std::source_location location = std::source_location::current())
 		{
 			auto queue = GetQueue<EType>();
 			if (queue)
 			{
-				queue->RegisterGlobalListener(instance, memberFunc);
+				return queue->RegisterTargetedListener(target, instance, memberFunc, location);
 			}
 			else
 			{
@@ -242,15 +391,137 @@ namespace CE
 				throw std::runtime_error("No queue found for this event type.");
 #endif
 			}
+			return ListenerHandle::INVALID;
 		}
 
-		void ProcessEvents();
+		template <typename EType>
+		ListenerHandle RegisterTargetedBatchListener(const EntityHandle& target, typename BatchListener<EType>::Callable callback, std::source_location location = std::source_location::current())
+		{
+			auto queue = GetQueue<EType>();
+			if (queue)
+			{
+				return queue->RegisterTargetedBatchListener(target, std::move(callback), location);
+			}
+			else
+			{
+				LOG_ERROR(EVENTS, "Failed to Register Listener! Could not find Queue type.");
+#if CDEBUG
+				throw std::runtime_error("No queue found for this event type.");
+#endif
+			}
+			return ListenerHandle::INVALID;
+		}
+
+		// Safe at any time, including from inside the listener being removed
+		template <typename EType>
+		bool UnregisterListener(const ListenerHandle& handle)
+		{
+			auto queue = GetQueue<EType>();
+			return queue ? queue->UnregisterListener(handle) : false;
+		}
+
+		// Drops every listener targeting the entity across all queues, call when it is destroyed
+		void UnregisterTarget(const EntityHandle& target)
+		{
+			for (EventTypeID id : m_dispatchOrder)
+			{
+				m_queues[id].queue->UnregisterTarget(target);
+			}
+		}
+
+		// Delayed events count down in the simulation time passed in here
+		void ProcessEvents(double deltaTime);
 		void TestEventSystem();
 
+#ifdef CE_EVENT_STATS
+		// Queue totals and every live listener's counts and timings, as JSON
+		bool ExportStats(const std::filesystem::path& path) const;
+#endif
+
+		// Frames that still had events pending after the last cascade pass
+		std::uint64_t GetCascadeOverflowCount() const { return m_cascadeOverflows; }
+
+		// Events posted since startup, across every queue
+		std::uint64_t GetPostedCount() const { return m_postedCount.load(std::memory_order_relaxed); }
+
+		// Simulation time ProcessEvents has advanced to
+		double GetTime() const { return m_time; }
+
 	private:
 		void OnTestEvent(const TestEvent& e);
 
-		std::unordered_map<std::type_index, IEventQueue*> m_queues;
+		bool IsMainThread() const { return m_scheduler == nullptr || m_scheduler->GetThreadIndex() == 0; }
+
+		template <typename EType>
+		EventQueue<EType>* GetQueueToPost()
+		{
+			auto queue = GetQueue<EType>();
+			if (!queue)
+			{
+				LOG_ERROR(EVENTS, "Failed to post event! Could not find Queue type.");
+#if CDEBUG
+				throw std::runtime_error("No queue found for this event type.");
+#endif
+			}
+			return queue;
+		}
+
+		struct QueueSlot
+		{
+			IEventQueue* queue = nullptr;
+			int priority = 0;
+			std::uint32_t order = 0;
+		};
+
+		// Indexed by EventTypeID, holes for types that never got a queue
+		std::vector<QueueSlot> m_queues;
+		std::vector<EventTypeID> m_dispatchOrder;
+		std::uint32_t m_queueCount = 0;
+
+		double m_time = 0.0;
+		std::uint32_t m_cascadeBudget = 8;
+
+		// Payload memory, this frame's events allocate from one arena while the other keeps last
+		// frame's. Events a cascade overflow leaves pending go out on the first pass of the next
+		// ProcessEvents, before their arena comes round to be reset, so neither arena ever has to
+		// skip a reset however long an event storm lasts.
+		std::array<Memory::FrameArena, 2> m_frameArenas;
+		std::uint32_t m_frameArenaIndex = 0;
+
+		Memory::FrameArena& GetFrameArena() { return m_frameArenas[m_frameArenaIndex]; }
+
+		// Debug check for delayed events, which outlive frame memory. Every pointer sized word of the
+		// event is looked at, so a pointer, span or string_view into either arena is caught wherever
+		// it sits. Workers never allocate payloads and the arenas are the main thread's, they skip it.
+		template <typename EType>
+		bool HoldsFramePayload(const EType& event) const
+		{
+			if (!IsMainThread())
+			{
+				return false;
+			}
+
+			const std::byte* bytes = reinterpret_cast<const std::byte*>(&event);
+			for (std::size_t offset = 0; offset + sizeof(void*) <= sizeof(EType); offset += alignof(void*))
+			{
+				const void* word = nullptr;
+				std::memcpy(&word, bytes + offset, sizeof(word));
+				for (const Memory::FrameArena& arena : m_frameArenas)
+				{
+					if (arena.Owns(word))
+					{
+						return true;
+					}
+				}
+			}
+			return false;
+		}
+		std::uint64_t m_cascadeOverflows = 0;
+
+		void RebuildDispatchOrder();
+		void DispatchCascade();
+		std::atomic<std::uint64_t> m_postedCount{ 0 };
+		const Jobs::JobScheduler* m_scheduler = nullptr;
 		
 	};
 }
\ No newline at end of file
@@ -0,0 +1,432 @@
+#pragma once
+
+#include "stdlibincl.h"
+#include "Handle.h"
+#include "ObjectPool.h"
+#include "InplaceFunction.h"
+#include "Systems/Events/EventStats.h"
+
+#include <atomic>
+#include <source_location>
+#include <span>
+
+namespace CE
+{
+	// Used for compile-time assurance of events
+	struct Event { };
+
+	template <typename T>
+	concept IsEvent = std::is_base_of_v<Event, T>;
+
+	// Dense per-type index for event types, handed out the first time each type asks for one
+	using EventTypeID = std::uint16_t;
+
+	namespace Detail
+	{
+		inline std::atomic<EventTypeID> s_nextEventTypeID{ 0 };
+	}
+
+	template <IsEvent EType>
+	EventTypeID GetEventTypeID()
+	{
+		static const EventTypeID id = Detail::s_nextEventTypeID.fetch_add(1, std::memory_order_relaxed);
+		return id;
+	}
+
+	using ListenerHandle = GenericHandle;
+
+	// Kept in a listener handle's type bits so unregistering knows where to look
+	enum class ListenerKind : ListenerHandle::UnderlyingType
+	{
+		EVENT,
+		BATCH,
+		TARGETED_EVENT,
+		TARGETED_BATCH
+	};
+
+	inline ListenerKind GetListenerKind(const ListenerHandle& handle)
+	{
+		return static_cast<ListenerKind>(handle.GetType());
+	}
+
+	template <IsEvent EType>
+	class Listener
+	{
+	public:
+		using Callable = InplaceFunction<void(const EType&)>;
+
+		Listener() = default;
+		explicit Listener(Callable callable, [[maybe_unused]] std::source_location location = std::source_location::current()) :
+			m_callable(std::move(callable))
+		{
+#ifdef CE_EVENT_STATS
+			m_stats.registeredAt = location;
+#endif
+		}
+
+		void Fire(const EType& e) const
+		{
+			if (m_bActive && m_callable)
+			{
+#ifdef CE_EVENT_STATS
+				Events::ScopedListenerTimer timer(m_stats);
+#endif
+				m_callable(e);
+			}
+		}
+
+		Callable m_callable;
+
+#ifdef CE_EVENT_STATS
+		mutable Events::ListenerStats m_stats;
+#endif
+
+		// Cleared on unsubscribe, the listener is skipped until its removal goes through
+		bool m_bActive = true;
+	};
+
+	// Receives every event of its type queued that frame at once, rather than one call per event
+	template <IsEvent EType>
+	class BatchListener
+	{
+	public:
+		using Callable = InplaceFunction<void(std::span<const EType>)>;
+
+		BatchListener() = default;
+		explicit BatchListener(Callable callable, [[maybe_unused]] std::source_location location = std::source_location::current()) :
+			m_callable(std::move(callable))
+		{
+#ifdef CE_EVENT_STATS
+			m_stats.registeredAt = location;
+#endif
+		}
+
+		void Fire(std::span<const EType> events) const
+		{
+			if (m_bActive && m_callable && !events.empty())
+			{
+#ifdef CE_EVENT_STATS
+				Events::ScopedListenerTimer timer(m_stats);
+#endif
+				m_callable(events);
+			}
+		}
+
+		Callable m_callable;
+		bool m_bActive = true;
+
+#ifdef CE_EVENT_STATS
+		mutable Events::ListenerStats m_stats;
+#endif
+	};
+
+	//
+	// ListenerList
+	// 
+	// Listeners live in a pool and fire in the order they registered. Removing one is constant time,
+	// it is deactivated on the spot and its slot freed straight away, or once dispatch is done when
+	// it was removed from inside a listener. Freed handles leave the fire order on the next dispatch.
+	// Dispatch is re-entrant, a listener posting an immediate event runs the list again under itself.
+	//
+	template <typename ListenerType, std::size_t MaxListeners = 1024>
+	class ListenerList
+	{
+	public:
+		ListenerHandle Add(typename ListenerType::Callable callable, ListenerKind kind, std::source_location location)
+		{
+			ListenerHandle handle = m_pool.CreateWithType(static_cast<ListenerHandle::UnderlyingType>(kind), 0, std::move(callable), location);
+			if (handle != ListenerHandle::INVALID)
+			{
+				m_order.push_back(handle);
+				m_count++;
+			}
+			return handle;
+		}
+
+		bool Remove(const ListenerHandle& handle)
+		{
+			if (!m_pool.IsValid(handle) || !m_pool.Get(handle).m_bActive)
+			{
+				return false;
+			}
+
+			m_pool.Get(handle).m_bActive = false;
+			m_count--;
+			if (m_dispatchDepth > 0)
+			{
+				// The callable may be the one running right now, it can't be destroyed under itself
+				m_removed.push_back(handle);
+			}
+			else
+			{
+				Free(handle);
+			}
+			return true;
+		}
+
+		// Calls function(listener) for everything registered before this dispatch began
+		template <typename Function>
+		void Dispatch(Function&& function)
+		{
+			// A listener posting immediately dispatches again under this one, only the outermost compacts
+			if (m_bOrderDirty && m_dispatchDepth == 0)
+			{
+				std::erase_if(m_order, [this](const ListenerHandle& handle) { return !m_pool.IsValid(handle); });
+				m_bOrderDirty = false;
+			}
+
+			m_dispatchDepth++;
+			const std::size_t count = m_order.size();
+			for (std::size_t i = 0; i < count; i++)
+			{
+				function(m_pool.Get(m_order[i]));
+			}
+			m_dispatchDepth--;
+
+			if (m_dispatchDepth == 0)
+			{
+				for (const ListenerHandle& handle : m_removed)
+				{
+					Free(handle);
+				}
+				m_removed.clear();
+			}
+		}
+
+		// Calls function(handle, listener) for every listener still subscribed, in fire order
+		template <typename Function>
+		void ForEach(Function&& function) const
+		{
+			for (const ListenerHandle& handle : m_order)
+			{
+				if (m_pool.IsValid(handle) && m_pool.Get(handle).m_bActive)
+				{
+					function(handle, m_pool.Get(handle));
+				}
+			}
+		}
+
+		std::size_t GetCount() const { return m_count; }
+		bool IsEmpty() const { return m_order.empty(); }
+
+	private:
+		ObjectPool<ListenerType, MaxListeners, ListenerHandle> m_pool;
+		std::vector<ListenerHandle> m_order;
+		std::vector<ListenerHandle> m_removed;
+		std::size_t m_count = 0;
+		std::uint32_t m_dispatchDepth = 0;
+		bool m_bOrderDirty = false;
+
+		void Free(const ListenerHandle& handle)
+		{
+			// The pool doesn't run destructors, drop what the callable captured before handing the slot back
+			m_pool.Get(handle) = ListenerType();
+			m_pool.Destroy(handle);
+			m_bOrderDirty = true;
+		}
+	};
+
+	//
+	// TargetedListeners
+	// 
+	// Listeners subscribed to one entity, indexed by the entity's slot so dispatching to a target
+	// only ever touches that entity's own listeners. Storage is pooled like ListenerList with room for
+	// a listener per entity, the pools add pages as listeners come in so an event type nobody targets
+	// costs nothing. An entity slot taken over by a new entity drops whatever the old one left subscribed.
+	//
+	template <IsEvent EType, std::size_t MaxListeners = 100000>
+	class TargetedListeners
+	{
+	public:
+		ListenerHandle Add(const EntityHandle& target, typename Listener<EType>::Callable callable, std::source_location location)
+		{
+			return AddTo(m_listeners, ListenerKind::TARGETED_EVENT, target, Listener<EType>(std::move(callable), location));
+		}
+
+		ListenerHandle AddBatch(const EntityHandle& target, typename BatchListener<EType>::Callable callable, std::source_location location)
+		{
+			return AddTo(m_batchListeners, ListenerKind::TARGETED_BATCH, target, BatchListener<EType>(std::move(callable), location));
+		}
+
+		bool Remove(const ListenerHandle& handle)
+		{
+			return GetListenerKind(handle) == ListenerKind::TARGETED_BATCH
+				? RemoveFrom(m_batchListeners, handle)
+				: RemoveFrom(m_listeners, handle);
+		}
+
+		// Everything subscribed to the entity, for when it is destroyed
+		void RemoveTarget(const EntityHandle& target)
+		{
+			const std::size_t index = target.GetIndex();
+			if (index < m_targets.size() && m_targets[index].entity == target)
+			{
+				ClearSlot(index);
+			}
+		}
+
+		// Per-event listeners see each event in turn, then batch listeners get them all at once
+		void Dispatch(const EntityHandle& target, std::span<const EType> events)
+		{
+			const std::size_t index = target.GetIndex();
+			if (index >= m_targets.size() || m_targets[index].entity != target)
+			{
+				return;
+			}
+
+			// Indexed rather than held by reference, listeners may subscribe others and grow these
+			m_dispatchDepth++;
+			const std::size_t count = m_targets[index].listeners.size();
+			for (const EType& event : events)
+			{
+				for (std::size_t i = 0; i < count; i++)
+				{
+					m_listeners.Get(m_targets[index].listeners[i]).listener.Fire(event);
+				}
+			}
+
+			const std::size_t batchCount = m_targets[index].batchListeners.size();
+			for (std::size_t i = 0; i < batchCount; i++)
+			{
+				m_batchListeners.Get(m_targets[index].batchListeners[i]).listener.Fire(events);
+			}
+			m_dispatchDepth--;
+
+			if (m_dispatchDepth == 0)
+			{
+				for (const ListenerHandle& handle : m_removed)
+				{
+					GetListenerKind(handle) == ListenerKind::TARGETED_BATCH ? Free(m_batchListeners, handle) : Free(m_listeners, handle);
+				}
+				m_removed.clear();
+			}
+		}
+
+		// Calls function(handle, target, listener) for each listener still subscribed, entity by entity
+		template <typename Function>
+		void ForEach(Function&& function) const
+		{
+			for (const Target& slot : m_targets)
+			{
+				for (const ListenerHandle& handle : slot.listeners)
+				{
+					const Listener<EType>& listener = m_listeners.Get(handle).listener;
+					if (listener.m_bActive) { function(handle, slot.entity, listener); }
+				}
+				for (const ListenerHandle& handle : slot.batchListeners)
+				{
+					const BatchListener<EType>& listener = m_batchListeners.Get(handle).listener;
+					if (listener.m_bActive) { function(handle, slot.entity, listener); }
+				}
+			}
+		}
+
+		std::size_t GetCount() const { return m_count; }
+		bool IsEmpty() const { return m_count == 0; }
+
+	private:
+		template <typename ListenerType>
+		struct Entry
+		{
+			ListenerType listener;
+			EntityHandle target;
+		};
+
+		template <typename ListenerType>
+		using Pool = ObjectPool<Entry<ListenerType>, MaxListeners, ListenerHandle>;
+
+		struct Target
+		{
+			EntityHandle entity;
+			std::vector<ListenerHandle> listeners;
+			std::vector<ListenerHandle> batchListeners;
+		};
+
+		Pool<Listener<EType>> m_listeners;
+		Pool<BatchListener<EType>> m_batchListeners;
+		std::vector<Target> m_targets;
+		std::vector<ListenerHandle> m_removed;
+		std::size_t m_count = 0;
+		std::uint32_t m_dispatchDepth = 0;
+
+		template <typename ListenerType>
+		ListenerHandle AddTo(Pool<ListenerType>& pool, ListenerKind kind, const EntityHandle& target, ListenerType listener)
+		{
+			const std::size_t index = target.GetIndex();
+			if (index >= m_targets.size())
+			{
+				m_targets.resize(index + 1);
+			}
+			if (m_targets[index].entity != target)
+			{
+				ClearSlot(index);
+				m_targets[index].entity = target;
+			}
+
+			ListenerHandle handle = pool.CreateWithType(static_cast<ListenerHandle::UnderlyingType>(kind), 0, Entry<ListenerType>{ std::move(listener), target });
+			if (handle != ListenerHandle::INVALID)
+			{
+				GetSlotList(m_targets[index], kind).push_back(handle);
+				m_count++;
+			}
+			return handle;
+		}
+
+		template <typename ListenerType>
+		bool RemoveFrom(Pool<ListenerType>& pool, const ListenerHandle& handle)
+		{
+			if (!pool.IsValid(handle) || !pool.Get(handle).listener.m_bActive)
+			{
+				return false;
+			}
+
+			pool.Get(handle).listener.m_bActive = false;
+			m_count--;
+			if (m_dispatchDepth > 0)
+			{
+				// The callable may be the one running right now, it can't be destroyed under itself
+				m_removed.push_back(handle);
+			}
+			else
+			{
+				Free(pool, handle);
+			}
+			return true;
+		}
+
+		template <typename ListenerType>
+		void Free(Pool<ListenerType>& pool, const ListenerHandle& handle)
+		{
+			Entry<ListenerType>& entry = pool.Get(handle);
+			const std::size_t index = entry.target.GetIndex();
+			if (index < m_targets.size())
+			{
+				std::erase(GetSlotList(m_targets[index], GetListenerKind(handle)), handle);
+			}
+
+			// The pool doesn't run destructors, drop what the callable captured before handing the slot back
+			entry = Entry<ListenerType>();
+			pool.Destroy(handle);
+		}
+
+		void ClearSlot(std::size_t index)
+		{
+			// Copied out, removing erases from the slot's own lists
+			const std::vector<ListenerHandle> listeners = m_targets[index].listeners;
+			const std::vector<ListenerHandle> batchListeners = m_targets[index].batchListeners;
+			for (const ListenerHandle& handle : listeners)
+			{
+				RemoveFrom(m_listeners, handle);
+			}
+			for (const ListenerHandle& handle : batchListeners)
+			{
+				RemoveFrom(m_batchListeners, handle);
+			}
+		}
+
+		static std::vector<ListenerHandle>& GetSlotList(Target& target, ListenerKind kind)
+		{
+			return kind == ListenerKind::TARGETED_BATCH ? target.batchListeners : target.listeners;
+		}
+	};
+}
@@ -0,0 +1,527 @@
+#pragma once
+
+#include "stdlibincl.h"
+#include "Systems/Events/EventListeners.h"
+#include "Systems/Events/EventStaging.h"
+#include "Systems/Events/TimingWheel.h"
+#include "Jobs/JobScheduler.h"
+
+namespace CE
+{
+	// When a posted event reaches its listeners
+	enum class EventDelivery
+	{
+		IMMEDIATE,	// Right away, inside the post
+		DEFERRED,	// On the next ProcessEvents, or the next cascade pass when posted during dispatch
+		DELAYED		// Once the delay has passed, on the first ProcessEvents after it
+	};
+
+	class IEventQueue
+	{
+	public:
+		virtual ~IEventQueue() = default;
+		virtual void CollectStaged() = 0;
+		virtual void AdvanceTime(double time) = 0;
+		virtual void Process() = 0;
+		virtual bool HasPending() const = 0;
+		virtual std::string_view GetQueueName() = 0;
+		virtual std::size_t GetPendingCount() const = 0;
+		virtual std::size_t GetScheduledCount() const = 0;
+		virtual std::size_t GetListenerCount() const = 0;
+		virtual void UnregisterTarget(const EntityHandle& target) = 0;
+
+#ifdef CE_EVENT_STATS
+		virtual const Events::QueueStats& GetStats() const = 0;
+		virtual void EndStatsFrame() = 0;
+		virtual void CollectListenerStats(std::vector<Events::ListenerStatsRow>& rows) const = 0;
+#endif
+	};
+
+	//
+	// EventQueue
+	// 
+	// Events are constructed straight into a contiguous buffer and dispatched from it by reference.
+	// Two buffers trade places each Process, one taking new posts while the other is dispatched, so
+	// listeners can post freely and the storage is reused from frame to frame once it has grown.
+	// What listeners post goes out on the next Process, which the EventSystem runs as a cascade pass.
+	// 
+	// Per-event listeners see each event in turn, then batch listeners get the whole batch as one
+	// span. Anything tallying up many events should prefer a batch listener, it is one call a frame.
+	// 
+	// Registering hands back a handle to unsubscribe with, which is safe from inside a listener.
+	// Objects registering member functions must unsubscribe before they go away.
+	// 
+	// Events posted to an entity only reach listeners subscribed to that entity, never the global
+	// ones. They are grouped by target at dispatch, keeping post order within each target, so each
+	// entity's listeners run once over a contiguous run of its events.
+	// 
+	// Job workers can post too. Each worker stages its posts in a lock-free buffer of its own, merged
+	// in by CollectStaged after the main thread's posts, worker by worker in thread index order and
+	// each in the order it posted. That keeps one job's posts in order, but not the order between
+	// jobs: which worker runs a job depends on stealing, and jobs the main thread picks up while it
+	// waits post straight into the pending buffer. Listeners that need a stable order across jobs
+	// have to sort on something in the event. Only the main thread emplaces, registers listeners or
+	// processes.
+	// 
+	// Delivery is deferred unless the queue is set otherwise, or a post asks for something else.
+	// Immediate events go to listeners inside the post, even one made from a listener, global ones
+	// to the per-event listeners and then to batch listeners as a batch of one. Delayed events wait on
+	// a timing wheel and join the pending buffer on the first frame past their delay, so they can
+	// arrive up to a frame plus a wheel tick late but never early. Workers never dispatch, their
+	// immediate posts are staged like deferred ones and go out on the next frame.
+	//
+	template <IsEvent EType>
+	class EventQueue : public IEventQueue
+	{
+	public:
+		EventQueue() : m_pending(), m_processing(), m_listeners(), m_batchListeners()
+		{
+			m_name = typeid(EType).name();
+		}
+		~EventQueue() {}
+
+		// How plain posts are delivered, delaySeconds only matters for DELAYED
+		void SetDelivery(EventDelivery delivery, double delaySeconds = 0.0)
+		{
+			m_delivery = delivery;
+			m_delay = delaySeconds;
+		}
+
+		EventDelivery GetDelivery() const { return m_delivery; }
+
+		// Gives each worker of the scheduler a staging buffer, call before any of them post
+		void SetScheduler(const Jobs::JobScheduler* scheduler)
+		{
+			m_scheduler = scheduler;
+			m_staging.clear();
+			if (m_scheduler)
+			{
+				for (std::size_t i = 0; i < m_scheduler->GetWorkerCount(); i++)
+				{
+					m_staging.push_back(std::make_unique<EventStaging<StagedEvent>>());
+				}
+			}
+		}
+
+		// Delivered the way the queue is set to, deferred unless SetDelivery says otherwise
+		void PostEvent(const EType& event) { Post(EntityHandle::INVALID, event, m_delivery, m_delay); }
+		void PostEvent(EType&& event) { Post(EntityHandle::INVALID, std::move(event), m_delivery, m_delay); }
+
+		template <typename Posted> requires std::same_as<std::remove_cvref_t<Posted>, EType>
+		void PostEvent(Posted&& event, EventDelivery delivery)
+		{
+			Post(EntityHandle::INVALID, std::forward<Posted>(event), delivery, m_delay);
+		}
+
+		template <typename Posted> requires std::same_as<std::remove_cvref_t<Posted>, EType>
+		void PostEventAfter(Posted&& event, double seconds)
+		{
+			Post(EntityHandle::INVALID, std::forward<Posted>(event), EventDelivery::DELAYED, seconds);
+		}
+
+		// Builds the event in place, fill it in through the returned reference before the next post.
+		// Main thread only, workers post finished events. Always deferred, whatever the queue is set to.
+		template <typename... Args>
+		EType& EmplaceEvent(Args&&... args)
+		{
+			assert(GetStaging() == nullptr);
+			RecordPosted(1);
+			return m_pending.emplace_back(std::forward<Args>(args)...);
+		}
+
+		void PostEvent(const EntityHandle& target, const EType& event) { Post(target, event, m_delivery, m_delay); }
+		void PostEvent(const EntityHandle& target, EType&& event) { Post(target, std::move(event), m_delivery, m_delay); }
+
+		template <typename Posted> requires std::same_as<std::remove_cvref_t<Posted>, EType>
+		void PostEvent(const EntityHandle& target, Posted&& event, EventDelivery delivery)
+		{
+			Post(target, std::forward<Posted>(event), delivery, m_delay);
+		}
+
+		template <typename Posted> requires std::same_as<std::remove_cvref_t<Posted>, EType>
+		void PostEventAfter(const EntityHandle& target, Posted&& event, double seconds)
+		{
+			Post(target, std::forward<Posted>(event), EventDelivery::DELAYED, seconds);
+		}
+
+		template <typename... Args>
+		EType& EmplaceTargetedEvent(const EntityHandle& target, Args&&... args)
+		{
+			assert(GetStaging() == nullptr);
+			RecordPosted(1);
+			m_pendingTargets.push_back(target);
+			return m_pendingTargeted.emplace_back(std::forward<Args>(args)...);
+		}
+
+		ListenerHandle RegisterGlobalListener(typename Listener<EType>::Callable callback, std::source_location location = std::source_location::current())
+		{
+			return m_listeners.Add(std::move(callback), ListenerKind::EVENT, location);
+		}
+
+		template <typename Instance>
+		ListenerHandle RegisterGlobalListener(Instance* instance, void (Instance::*memberFunc)(const EType&), std::source_location location = std::source_location::current())
+		{
+			auto callback = [instance, memberFunc](const EType& event) {
+				(instance->*memberFunc)(event);
+				};
+			return RegisterGlobalListener(callback, location);
+		}
+
+		ListenerHandle RegisterBatchListener(typename BatchListener<EType>::Callable callback, std::source_location location = std::source_location::current())
+		{
+			return m_batchListeners.Add(std::move(callback), ListenerKind::BATCH, location);
+		}
+
+		template <typename Instance>
+		ListenerHandle RegisterBatchListener(Instance* instance, void (Instance::*memberFunc)(std::span<const EType>), std::source_location location = std::source_location::current())
+		{
+			auto callback = [instance, memberFunc](std::span<const EType> events) {
+				(instance->*memberFunc)(events);
+				};
+			return RegisterBatchListener(callback, location);
+		}
+
+		ListenerHandle RegisterTargetedListener(const EntityHandle& target, typename Listener<EType>::Callable callback, std::source_location location = std::source_location::current())
+		{
+			return m_targetedListeners.Add(target, std::move(callback), location);
+		}
+
+		template <typename Instance>
+		ListenerHandle RegisterTargetedListener(const EntityHandle& target, Instance* instance, void (Instance::*memberFunc)(const EType&), std::source_location location = std::source_location::current())
+		{
+			auto callback = [instance, memberFunc](const EType& event) {
+				(instance->*memberFunc)(event);
+				};
+			return RegisterTargetedListener(target, callback, location);
+		}
+
+		ListenerHandle RegisterTargetedBatchListener(const EntityHandle& target, typename BatchListener<EType>::Callable callback, std::source_location location = std::source_location::current())
+		{
+			return m_targetedListeners.AddBatch(target, std::move(callback), location);
+		}
+
+		// Any kind of listener, false if the handle was already gone
+		bool UnregisterListener(const ListenerHandle& handle)
+		{
+			switch (GetListenerKind(handle))
+			{
+			case ListenerKind::EVENT: return m_listeners.Remove(handle);
+			case ListenerKind::BATCH: return m_batchListeners.Remove(handle);
+			default: return m_targetedListeners.Remove(handle);
+			}
+		}
+
+		void UnregisterTarget(const EntityHandle& target) override
+		{
+			m_targetedListeners.RemoveTarget(target);
+		}
+
+		// Merges in what workers have posted, once a frame before the first Process
+		void CollectStaged() override
+		{
+			// Whatever workers post from here on waits for next frame
+			for (const std::unique_ptr<EventStaging<StagedEvent>>& staging : m_staging)
+			{
+				const std::size_t drained = staging->Drain([this](StagedEvent&& staged) {
+					if (staged.delay >= 0.0)
+					{
+						// Delays count from when the main thread picks the event up
+						m_delayed.Schedule(m_time + staged.delay, std::move(staged));
+					}
+					else
+					{
+						PushPending(staged.target, std::move(staged.event));
+					}
+				});
+				RecordPosted(drained);
+			}
+		}
+
+		// Moves delayed events that are due by time into the pending buffers, before CollectStaged
+		void AdvanceTime(double time) override
+		{
+			m_time = time;
+			m_delayed.Advance(time, [this](StagedEvent&& due) {
+				PushPending(due.target, std::move(due.event));
+			});
+		}
+
+		// Dispatches everything pending as of the call. Events listeners post land in the other
+		// buffer and wait for the next call, the EventSystem decides how many of those a frame gets.
+		void Process() override
+		{
+#ifdef CE_EVENT_STATS
+			m_stats.pendingHighWater = std::max(m_stats.pendingHighWater, m_pending.size() + m_pendingTargeted.size());
+			m_stats.dispatched += m_pending.size() + m_pendingTargeted.size();
+			const std::uint64_t start = Events::NowNs();
+			m_dispatchDepth++;
+#endif
+
+			std::swap(m_pending, m_processing);
+			std::swap(m_pendingTargeted, m_processingTargeted);
+			std::swap(m_pendingTargets, m_processingTargets);
+
+			// Listeners registered mid dispatch start with the next batch
+			if (!m_listeners.IsEmpty())
+			{
+				for (const EType& event : m_processing)
+				{
+					m_listeners.Dispatch([&event](const Listener<EType>& listener) {
+						listener.Fire(event);
+					});
+				}
+			}
+
+			const std::span<const EType> batch(m_processing);
+			m_batchListeners.Dispatch([batch](const BatchListener<EType>& listener) {
+				listener.Fire(batch);
+			});
+
+			if (!m_processingTargeted.empty() && !m_targetedListeners.IsEmpty())
+			{
+				DispatchTargeted();
+			}
+
+			// Keeps the capacity for the next frame
+			m_processing.clear();
+			m_processingTargeted.clear();
+			m_processingTargets.clear();
+
+#ifdef CE_EVENT_STATS
+			m_dispatchDepth--;
+			m_stats.dispatchNs += Events::NowNs() - start;
+#endif
+		}
+
+#ifdef CE_EVENT_STATS
+		const Events::QueueStats& GetStats() const override { return m_stats; }
+		void EndStatsFrame() override { m_stats.EndFrame(); }
+
+		void CollectListenerStats(std::vector<Events::ListenerStatsRow>& rows) const override
+		{
+			m_listeners.ForEach([&](const ListenerHandle& handle, const Listener<EType>& listener) {
+				rows.push_back({ m_name, handle, EntityHandle::INVALID, listener.m_stats });
+			});
+			m_batchListeners.ForEach([&](const ListenerHandle& handle, const BatchListener<EType>& listener) {
+				rows.push_back({ m_name, handle, EntityHandle::INVALID, listener.m_stats });
+			});
+			m_targetedListeners.ForEach([&](const ListenerHandle& handle, const EntityHandle& target, const auto& listener) {
+				rows.push_back({ m_name, handle, target, listener.m_stats });
+			});
+		}
+#endif
+
+		std::string_view GetQueueName() override
+		{
+			return m_name;
+		}
+
+		bool HasPending() const override
+		{
+			return !m_pending.empty() || !m_pendingTargeted.empty();
+		}
+
+		std::size_t GetPendingCount() const override
+		{
+			return m_pending.size() + m_pendingTargeted.size();
+		}
+
+		std::size_t GetScheduledCount() const override
+		{
+			return m_delayed.GetCount();
+		}
+
+		std::size_t GetListenerCount() const override
+		{
+			return m_listeners.GetCount() + m_batchListeners.GetCount() + m_targetedListeners.GetCount();
+		}
+
+	private:
+		// Also what waits on the timing wheel. No target means a global event, a negative delay a deferred one.
+		struct StagedEvent
+		{
+			EntityHandle target;
+			EType event;
+			double delay;
+
+			StagedEvent(const EntityHandle& target, const EType& event, double delay) : target(target), event(event), delay(delay) {}
+			StagedEvent(const EntityHandle& target, EType&& event, double delay) : target(target), event(std::move(event)), delay(delay) {}
+		};
+
+		// One staging buffer per job worker, indexed by thread index - 1 since the main thread posts directly
+		const Jobs::JobScheduler* m_scheduler = nullptr;
+		std::vector<std::unique_ptr<EventStaging<StagedEvent>>> m_staging;
+
+		std::vector<EType> m_pending;
+		std::vector<EType> m_processing;
+		ListenerList<Listener<EType>> m_listeners;
+		ListenerList<BatchListener<EType>> m_batchListeners;
+
+		// Targeted events sit alongside the entity each one is for
+		std::vector<EType> m_pendingTargeted;
+		std::vector<EType> m_processingTargeted;
+		std::vector<EntityHandle> m_pendingTargets;
+		std::vector<EntityHandle> m_processingTargets;
+		TargetedListeners<EType> m_targetedListeners;
+
+		// Scratch for grouping targeted events, reused each dispatch
+		std::vector<std::uint32_t> m_targetOrder;
+		std::vector<EntityHandle> m_groupedTargets;
+		std::vector<EType> m_groupedTargeted;
+
+		EventDelivery m_delivery = EventDelivery::DEFERRED;
+		double m_delay = 0.0;
+
+		// Simulation time as of the last AdvanceTime, delays are scheduled from it
+		TimingWheel<StagedEvent> m_delayed;
+		double m_time = 0.0;
+
+		std::string_view m_name;
+
+#ifdef CE_EVENT_STATS
+		Events::QueueStats m_stats;
+
+		// Immediate dispatches inside a Process are already timed by it
+		std::uint32_t m_dispatchDepth = 0;
+#endif
+
+		void RecordPosted([[maybe_unused]] std::size_t count)
+		{
+#ifdef CE_EVENT_STATS
+			m_stats.posted += count;
+#endif
+		}
+
+		template <typename Posted>
+		void Post(const EntityHandle& target, Posted&& event, EventDelivery delivery, double delay)
+		{
+			if (EventStaging<StagedEvent>* staging = GetStaging())
+			{
+				staging->Push(target, std::forward<Posted>(event), delivery == EventDelivery::DELAYED ? std::max(delay, 0.0) : -1.0);
+				return;
+			}
+
+			RecordPosted(1);
+			switch (delivery)
+			{
+			case EventDelivery::IMMEDIATE:
+				DispatchNow(target, event);
+				break;
+			case EventDelivery::DELAYED:
+				m_delayed.Schedule(m_time + std::max(delay, 0.0), StagedEvent(target, std::forward<Posted>(event), delay));
+				break;
+			default:
+				PushPending(target, std::forward<Posted>(event));
+				break;
+			}
+		}
+
+		template <typename Posted>
+		void PushPending(const EntityHandle& target, Posted&& event)
+		{
+			if (target == EntityHandle::INVALID)
+			{
+				m_pending.push_back(std::forward<Posted>(event));
+			}
+			else
+			{
+				m_pendingTargets.push_back(target);
+				m_pendingTargeted.push_back(std::forward<Posted>(event));
+			}
+		}
+
+		void DispatchNow(const EntityHandle& target, const EType& event)
+		{
+#ifdef CE_EVENT_STATS
+			m_stats.dispatched++;
+			const std::uint64_t start = m_dispatchDepth == 0 ? Events::NowNs() : 0;
+			m_dispatchDepth++;
+#endif
+
+			const std::span<const EType> batch(&event, 1);
+			if (target == EntityHandle::INVALID)
+			{
+				m_listeners.Dispatch([&event](const Listener<EType>& listener) {
+					listener.Fire(event);
+				});
+				m_batchListeners.Dispatch([batch](const BatchListener<EType>& listener) {
+					listener.Fire(batch);
+				});
+			}
+			else
+			{
+				m_targetedListeners.Dispatch(target, batch);
+			}
+
+#ifdef CE_EVENT_STATS
+			m_dispatchDepth--;
+			if (start != 0)
+			{
+				m_stats.dispatchNs += Events::NowNs() - start;
+			}
+#endif
+		}
+
+		// Null on the main thread, which posts straight into the pending buffers
+		EventStaging<StagedEvent>* GetStaging() const
+		{
+			if (m_staging.empty())
+			{
+				return nullptr;
+			}
+
+			const int threadIndex = m_scheduler->GetThreadIndex();
+			assert(threadIndex >= 0 && "Events can only be posted from the main thread or job workers");
+			return threadIndex > 0 ? m_staging[threadIndex - 1].get() : nullptr;
+		}
+
+		void DispatchTargeted()
+		{
+			const std::size_t count = m_processingTargeted.size();
+
+			// Most frames post to targets in runs already, only shuffle the events when they aren't
+			const auto byTarget = [](const EntityHandle& a, const EntityHandle& b) { return a.raw() < b.raw(); };
+			if (std::is_sorted(m_processingTargets.begin(), m_processingTargets.end(), byTarget))
+			{
+				DispatchRuns(m_processingTargets, m_processingTargeted);
+				return;
+			}
+
+			m_targetOrder.resize(count);
+			for (std::uint32_t i = 0; i < count; i++)
+			{
+				m_targetOrder[i] = i;
+			}
+			std::stable_sort(m_targetOrder.begin(), m_targetOrder.end(), [this](std::uint32_t a, std::uint32_t b) {
+				return m_processingTargets[a].raw() < m_processingTargets[b].raw();
+			});
+
+			m_groupedTargets.clear();
+			m_groupedTargeted.clear();
+			for (std::uint32_t index : m_targetOrder)
+			{
+				m_groupedTargets.push_back(m_processingTargets[index]);
+				m_groupedTargeted.push_back(std::move(m_processingTargeted[index]));
+			}
+
+			DispatchRuns(m_groupedTargets, m_groupedTargeted);
+			m_groupedTargeted.clear();
+		}
+
+		void DispatchRuns(const std::vector<EntityHandle>& targets, const std::vector<EType>& events)
+		{
+			std::size_t start = 0;
+			while (start < events.size())
+			{
+				std::size_t end = start + 1;
+				while (end < events.size() && targets[end] == targets[start])
+				{
+					end++;
+				}
+
+				m_targetedListeners.Dispatch(targets[start], std::span<const EType>(events.data() + start, end - start));
+				start = end;
+			}
+		}
+	};
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "stdlibincl.h"
+
+#include <atomic>
+
+namespace CE
+{
+	//
+	// EventStaging
+	//
+	// Unbounded single producer, single consumer queue one worker thread stages its posts in until the
+	// main thread drains them. Items go into fixed size chunks and become visible by bumping the
+	// chunk's published count, a full chunk links on the next one. Neither side ever locks, the
+	// only contended write is handing drained chunks back to the producer for reuse.
+	//
+	// Push only from the owning thread, Drain only from the main thread.
+	//
+	template <typename T>
+	class EventStaging
+	{
+	public:
+		EventStaging()
+		{
+			m_head = m_tail = new Chunk();
+		}
+
+		~EventStaging()
+		{
+			// Anything never drained still has to be destroyed
+			Drain([](T&&) {});
+			DeleteChunks(m_head, &Chunk::next);
+			DeleteChunks(m_spare, &Chunk::nextFree);
+			DeleteChunks(m_recycled.load(std::memory_order_acquire), &Chunk::nextFree);
+		}
+
+		EventStaging(const EventStaging&) = delete;
+		EventStaging& operator=(const EventStaging&) = delete;
+
+		template <typename... Args>
+		void Push(Args&&... args)
+		{
+			if (m_written == ChunkCapacity)
+			{
+				Chunk* chunk = TakeChunk();
+				m_tail->next.store(chunk, std::memory_order_release);
+				m_tail = chunk;
+				m_written = 0;
+			}
+
+			new (m_tail->Slot(m_written)) T(std::forward<Args>(args)...);
+			m_written++;
+			m_tail->published.store(m_written, std::memory_order_release);
+		}
+
+		// Hands everything published so far to function in push order, returns how many there were
+		template <typename Function>
+		std::size_t Drain(Function&& function)
+		{
+			std::size_t count = 0;
+			while (true)
+			{
+				const std::uint32_t published = m_head->published.load(std::memory_order_acquire);
+				for (; m_read < published; m_read++)
+				{
+					T* item = m_head->Slot(m_read);
+					function(std::move(*item));
+					item->~T();
+					count++;
+				}
+
+				if (m_read < ChunkCapacity)
+				{
+					break;
+				}
+
+				// The producer links the next chunk on its next push, until then this one stays put
+				Chunk* next = m_head->next.load(std::memory_order_acquire);
+				if (next == nullptr)
+				{
+					break;
+				}
+
+				Recycle(m_head);
+				m_head = next;
+				m_read = 0;
+			}
+			return count;
+		}
+
+	private:
+		static constexpr std::uint32_t ChunkCapacity = 128;
+
+		struct Chunk
+		{
+			alignas(T) std::byte storage[ChunkCapacity * sizeof(T)];
+			std::atomic<std::uint32_t> published{ 0 };
+			std::atomic<Chunk*> next{ nullptr };
+			Chunk* nextFree = nullptr;
+
+			T* Slot(std::uint32_t index) { return std::launder(reinterpret_cast<T*>(storage) + index); }
+		};
+
+		// Producer side
+		Chunk* m_tail = nullptr;
+		std::uint32_t m_written = 0;
+		Chunk* m_spare = nullptr;
+
+		// Consumer side, kept off the producer's cache line
+		alignas(64) Chunk* m_head = nullptr;
+		std::uint32_t m_read = 0;
+
+		// Drained chunks on their way back to the producer
+		alignas(64) std::atomic<Chunk*> m_recycled{ nullptr };
+
+		Chunk* TakeChunk()
+		{
+			if (m_spare == nullptr)
+			{
+				m_spare = m_recycled.exchange(nullptr, std::memory_order_acquire);
+			}
+			if (m_spare == nullptr)
+			{
+				return new Chunk();
+			}
+
+			Chunk* chunk = m_spare;
+			m_spare = chunk->nextFree;
+			chunk->nextFree = nullptr;
+			chunk->published.store(0, std::memory_order_relaxed);
+			return chunk;
+		}
+
+		void Recycle(Chunk* chunk)
+		{
+			chunk->next.store(nullptr, std::memory_order_relaxed);
+
+			Chunk* head = m_recycled.load(std::memory_order_relaxed);
+			do
+			{
+				chunk->nextFree = head;
+			} while (!m_recycled.compare_exchange_weak(head, chunk, std::memory_order_release, std::memory_order_relaxed));
+		}
+
+		template <typename Link>
+		static void DeleteChunks(Chunk* chunk, Link Chunk::* link)
+		{
+			while (chunk != nullptr)
+			{
+				Chunk* next = chunk->*link;
+				delete chunk;
+				chunk = next;
+			}
+		}
+	};
+}
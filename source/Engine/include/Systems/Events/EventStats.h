@@ -0,0 +1,141 @@
+#pragma once
+
+#include "stdlibincl.h"
+#include "Handle.h"
+
+#include <chrono>
+#include <source_location>
+
+//
+// Event Stats
+//
+// Counts and timings for queues and listeners, compiled in with CE_EVENT_STATS. Queues always
+// count what they post and dispatch and time each dispatch pass. Timing every listener call costs
+// two clock reads a call, so that part waits until something switches it on with
+// SetListenerTiming, usually the event debug window while chasing down an event storm.
+//
+// Listener stats roll over lazily against the frame number the EventSystem bumps each frame,
+// listeners that didn't fire this frame are never touched.
+//
+
+namespace CE::Events
+{
+	struct ListenerStats
+	{
+		std::source_location registeredAt;
+		std::uint64_t calls = 0;
+		std::uint64_t totalNs = 0;
+		std::uint64_t frameNs = 0;
+		std::uint64_t peakFrameNs = 0;
+		std::uint64_t frame = 0;
+	};
+
+	struct QueueStats
+	{
+		static constexpr std::size_t s_historySize = 240;
+
+		// This frame so far
+		std::uint64_t posted = 0;
+		std::uint64_t dispatched = 0;
+		std::uint64_t dispatchNs = 0;
+
+		// Since startup
+		std::uint64_t totalPosted = 0;
+		std::uint64_t totalDispatched = 0;
+		std::uint64_t totalDispatchNs = 0;
+		std::size_t pendingHighWater = 0;
+		std::uint64_t peakDispatched = 0;
+		std::uint64_t peakDispatchNs = 0;
+
+		// Ring of finished frames for the graphs, oldest at historyHead once it has wrapped
+		std::vector<float> postedHistory;
+		std::vector<float> dispatchedHistory;
+		std::vector<float> dispatchMsHistory;
+		std::size_t historyHead = 0;
+
+		void EndFrame()
+		{
+			totalPosted += posted;
+			totalDispatched += dispatched;
+			totalDispatchNs += dispatchNs;
+			peakDispatched = std::max(peakDispatched, dispatched);
+			peakDispatchNs = std::max(peakDispatchNs, dispatchNs);
+
+			const float dispatchMs = static_cast<float>(dispatchNs / 1e6);
+			if (postedHistory.size() < s_historySize)
+			{
+				postedHistory.push_back(static_cast<float>(posted));
+				dispatchedHistory.push_back(static_cast<float>(dispatched));
+				dispatchMsHistory.push_back(dispatchMs);
+			}
+			else
+			{
+				postedHistory[historyHead] = static_cast<float>(posted);
+				dispatchedHistory[historyHead] = static_cast<float>(dispatched);
+				dispatchMsHistory[historyHead] = dispatchMs;
+				historyHead = (historyHead + 1) % s_historySize;
+			}
+
+			posted = 0;
+			dispatched = 0;
+			dispatchNs = 0;
+		}
+	};
+
+	// One row per live listener when the debug window or an export asks for them
+	struct ListenerStatsRow
+	{
+		std::string_view queue;
+		GenericHandle handle;
+		EntityHandle target;
+		ListenerStats stats;
+	};
+
+	inline std::uint64_t s_statsFrame = 0;
+	inline bool s_bTimeListeners = false;
+
+	inline void SetListenerTiming(bool bEnabled) { s_bTimeListeners = bEnabled; }
+	inline bool IsListenerTimingEnabled() { return s_bTimeListeners; }
+
+	inline std::uint64_t NowNs()
+	{
+		return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	// Wraps one listener call, counts it and times it if listener timing is on
+	class ScopedListenerTimer
+	{
+	public:
+		explicit ScopedListenerTimer(ListenerStats& stats) : m_stats(stats)
+		{
+			m_stats.calls++;
+			if (s_bTimeListeners)
+			{
+				m_start = NowNs();
+			}
+		}
+
+		~ScopedListenerTimer()
+		{
+			if (m_start == 0) { return; }
+
+			const std::uint64_t elapsed = NowNs() - m_start;
+			if (m_stats.frame != s_statsFrame)
+			{
+				m_stats.frame = s_statsFrame;
+				m_stats.frameNs = 0;
+			}
+			m_stats.frameNs += elapsed;
+			m_stats.totalNs += elapsed;
+			m_stats.peakFrameNs = std::max(m_stats.peakFrameNs, m_stats.frameNs);
+		}
+
+		ScopedListenerTimer(const ScopedListenerTimer&) = delete;
+		ScopedListenerTimer& operator=(const ScopedListenerTimer&) = delete;
+
+	private:
+		ListenerStats& m_stats;
+		std::uint64_t m_start = 0;
+	};
+}
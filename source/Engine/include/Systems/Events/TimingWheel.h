@@ -0,0 +1,120 @@
+#pragma once
+
+#include "stdlibincl.h"
+
+#include <cmath>
+
+namespace CE
+{
+	//
+	// TimingWheel
+	//
+	// Hashed timing wheel for things due at a point in time. Time is cut into ticks and each tick
+	// hashes onto one of a ring of slots, so scheduling is a push onto the slot's list and advancing
+	// only visits the slots for the ticks that went by, however much is scheduled further out.
+	// Anything more than a lap away shares its slot and sits out the laps until its own tick comes.
+	//
+	// Items are handed out in due order, ties in the order they were scheduled, and never before
+	// their time. They can come up to a tick late, the tick is the resolution.
+	//
+	template <typename T>
+	class TimingWheel
+	{
+	public:
+		explicit TimingWheel(double tickSeconds = 1.0 / 120.0, std::size_t slotCount = 256) :
+			m_slots(slotCount),
+			m_tickSeconds(tickSeconds)
+		{
+			assert(tickSeconds > 0.0 && slotCount > 0);
+		}
+
+		// Absolute time, anything already due goes out on the next tick
+		void Schedule(double time, T item)
+		{
+			const std::uint64_t tick = std::max(TickAtOrAfter(time), m_currentTick + 1);
+			m_slots[tick % m_slots.size()].push_back({ tick, m_nextOrder++, std::move(item) });
+			m_count++;
+		}
+
+		// Calls deliver(item) for everything due by time, in due order
+		template <typename Function>
+		void Advance(double time, Function&& deliver)
+		{
+			const std::uint64_t tick = TickAtOrBefore(time);
+			if (tick <= m_currentTick || m_count == 0)
+			{
+				m_currentTick = std::max(m_currentTick, tick);
+				return;
+			}
+
+			// A long jump only needs one lap, every slot gets looked at once
+			const std::uint64_t laps = std::min<std::uint64_t>(tick - m_currentTick, m_slots.size());
+			for (std::uint64_t i = 1; i <= laps; i++)
+			{
+				std::vector<Entry>& slot = m_slots[(m_currentTick + i) % m_slots.size()];
+				for (std::size_t index = 0; index < slot.size();)
+				{
+					if (slot[index].tick <= tick)
+					{
+						m_due.push_back(std::move(slot[index]));
+						slot[index] = std::move(slot.back());
+						slot.pop_back();
+					}
+					else
+					{
+						index++;
+					}
+				}
+			}
+			m_currentTick = tick;
+
+			std::sort(m_due.begin(), m_due.end(), [](const Entry& a, const Entry& b) {
+				return a.tick != b.tick ? a.tick < b.tick : a.order < b.order;
+			});
+
+			m_count -= m_due.size();
+			for (Entry& entry : m_due)
+			{
+				deliver(std::move(entry.item));
+			}
+			m_due.clear();
+		}
+
+		void Clear()
+		{
+			for (std::vector<Entry>& slot : m_slots)
+			{
+				slot.clear();
+			}
+			m_count = 0;
+		}
+
+		std::size_t GetCount() const { return m_count; }
+		double GetTickSeconds() const { return m_tickSeconds; }
+
+	private:
+		struct Entry
+		{
+			std::uint64_t tick;
+			std::uint64_t order;
+			T item;
+		};
+
+		std::vector<std::vector<Entry>> m_slots;
+		std::vector<Entry> m_due;
+		double m_tickSeconds;
+		std::uint64_t m_currentTick = 0;
+		std::uint64_t m_nextOrder = 0;
+		std::size_t m_count = 0;
+
+		std::uint64_t TickAtOrAfter(double time) const
+		{
+			return time <= 0.0 ? 0 : static_cast<std::uint64_t>(std::ceil(time / m_tickSeconds));
+		}
+
+		std::uint64_t TickAtOrBefore(double time) const
+		{
+			return time <= 0.0 ? 0 : static_cast<std::uint64_t>(std::floor(time / m_tickSeconds));
+		}
+	};
+}
@@ -74,6 +74,9 @@ namespace CE
 		/* CEngineSystem Interface */
 	public:
 		virtual std::string Name() const override { return "Input System"; }
+		virtual Memory::MemoryTag GetMemoryTag() const override { return Memory::MemoryTag::INPUT; }
+		virtual SystemDependencies GetDependencies() const override;
+		virtual bool RequiresMainThread() const override { return true; }
 	protected:
 		virtual void Startup() override;
 		virtual void Shutdown() override;
@@ -114,6 +117,12 @@ namespace CE
 
 		bool RemoveAction(InputActionHandle actionHandle);
 
+		// Queues an event as if it came from the window, processed with the next ProcessActions
+		void InjectEvent(const InputEvent& event) { m_events.push(event); }
+
+		// Every event the last ProcessActions handled, in order
+		const std::vector<InputEvent>& GetProcessedEvents() const { return m_processedEvents; }
+
 	private:
 		GLFWwindow* m_window = nullptr;
 
@@ -142,6 +151,7 @@ namespace CE
 
 		ObjectPool<std::shared_ptr<InputAction>, 128, InputActionHandle> m_actionPool;
 		std::queue<InputEvent> m_events;
+		std::vector<InputEvent> m_processedEvents;
 
 		std::unordered_map<InputActionHandle, std::string> m_actionNames;
 
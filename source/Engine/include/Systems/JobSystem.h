@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Systems/EngineSystem.h"
+#include "Jobs/JobScheduler.h"
+#include "Tasks/Task.h"
+
+#include <variant>
+
+#define JOB_SYSTEM "Job System"
+
+namespace CE
+{
+	namespace Jobs
+	{
+		// Returned by JobSystem::RunAsync, lives in the suspended task's frame until it is resumed
+		template <typename Function>
+		class JobAwaiter
+		{
+		public:
+			using Result = std::invoke_result_t<Function&>;
+
+			JobAwaiter(JobScheduler& scheduler, Function function) :
+				m_scheduler(scheduler),
+				m_function(std::move(function))
+			{}
+
+			bool await_ready() const noexcept { return false; }
+
+			template <typename Promise>
+			void await_suspend(std::coroutine_handle<Promise> handle)
+			{
+				Tasks::TaskScheduler* tasks = handle.promise().GetScheduler();
+				m_scheduler.Run([this, tasks, handle]() {
+					if constexpr (std::is_void_v<Result>)
+					{
+						m_function();
+					}
+					else
+					{
+						m_result.emplace(m_function());
+					}
+					tasks->Resume(handle);
+				});
+			}
+
+			Result await_resume()
+			{
+				if constexpr (!std::is_void_v<Result>)
+				{
+					return std::move(*m_result);
+				}
+			}
+
+		private:
+			JobScheduler& m_scheduler;
+			Function m_function;
+			std::conditional_t<std::is_void_v<Result>, std::monostate, std::optional<Result>> m_result;
+		};
+	}
+
+	class JobSystem final : public EngineSystem
+	{
+	public:
+		JobSystem(Engine* engine) : EngineSystem(engine) {};
+
+		/* EngineSystem Interface */
+	public:
+		virtual std::string Name() const override { return JOB_SYSTEM; }
+		virtual Memory::MemoryTag GetMemoryTag() const override { return Memory::MemoryTag::JOBS; }
+		virtual SystemDependencies GetDependencies() const override;
+	protected:
+		friend class Engine;
+		virtual void Startup() override;
+		virtual void Shutdown() override;
+
+		/* Job System API */
+	public:
+		//
+		// Jobs
+		// 
+		// Thin forwarding onto the scheduler, see JobScheduler for the details. Startup has to run on
+		// the main thread, that thread becomes the one main-thread jobs run on.
+		//
+		void Run(Jobs::JobFunction function, Jobs::JobCounter* counter = nullptr, Jobs::JobCounter* dependency = nullptr)
+		{
+			m_scheduler->Run(std::move(function), counter, dependency);
+		}
+
+		void RunOnMainThread(Jobs::JobFunction function, Jobs::JobCounter* counter = nullptr)
+		{
+			m_scheduler->RunOnMainThread(std::move(function), counter);
+		}
+
+		void Wait(Jobs::JobCounter& counter) { m_scheduler->Wait(counter); }
+
+		void ParallelFor(std::size_t count, std::size_t batchSize, const std::function<void(std::size_t, std::size_t)>& function)
+		{
+			m_scheduler->ParallelFor(count, batchSize, function);
+		}
+
+		//
+		// RunAsync
+		//
+		// Awaitable from a task, runs the function as a job and resumes the task on the main thread
+		// with whatever it returned once it is done.
+		//
+		//		int count = co_await JS->RunAsync([]() { return CountThings(); });
+		//
+		template <typename Function>
+		Jobs::JobAwaiter<Function> RunAsync(Function function)
+		{
+			return Jobs::JobAwaiter<Function>(*m_scheduler, std::move(function));
+		}
+
+		// Called once a frame by the engine
+		void ProcessMainThreadJobs() { m_scheduler->ProcessMainThreadJobs(); }
+
+		Jobs::JobScheduler& GetScheduler() { return *m_scheduler; }
+
+	private:
+		std::unique_ptr<Jobs::JobScheduler> m_scheduler;
+	};
+}
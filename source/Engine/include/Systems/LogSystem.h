@@ -5,6 +5,8 @@
 
 #include "stdlibincl.h"
 
+#include <mutex>
+
 #define DEBUG_BREAK()			\
 	if (CE::Globals::bDebugBreakOnError) {	\
 		PLATFORM_BREAK();		\
@@ -55,6 +57,7 @@ namespace CE
 		GAMEPLAY,
 		WORLD,
 		ENTITY,
+		PHYSICS,
 		MAX
 	};
 
@@ -78,6 +81,7 @@ namespace CE
 		/* EngineSystem Interface */
 	public:
 		virtual std::string Name() const override { return "Log System"; }
+		virtual Memory::MemoryTag GetMemoryTag() const override { return Memory::MemoryTag::LOG; }
 	private:
 		friend class Engine;
 		virtual void Startup() override;
@@ -93,6 +97,7 @@ namespace CE
 		static void Log(LogLevel level, LogChannel channel, std::string msg, Args&&... msgArgs)
 		{
 			assert(g_log != nullptr);
+			MEMORY_SCOPE(Memory::MemoryTag::LOG);
 			std::string message;
 			if constexpr (sizeof...(Args) == 0)
 			{
@@ -146,6 +151,7 @@ namespace CE
 		};
 
 		std::vector<LogElement> m_log;
+		std::mutex m_logMutex;
 
 		void LogImpl(LogLevel level, LogChannel channel, std::string_view message);
 
@@ -176,6 +182,7 @@ namespace CE
 		case LogChannel::GAMEPLAY: return "Gameplay";
 		case LogChannel::ENTITY: return "Entity";
 		case LogChannel::WORLD: return "World";
+		case LogChannel::PHYSICS: return "Physics";
 		default: return "";
 		}
 	}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Systems/EngineSystem.h"
+#include "Physics/PhysicsScene.h"
+#include "Systems/World/WorldQuery.h"
+
+#define PHYSICS_SYSTEM "Physics System"
+
+namespace CE
+{
+	class WorldSystem;
+	class RigidBodyComponent;
+	class TransformComponent;
+
+#ifdef CDEBUG
+	class PhysicsSystemDebug;
+#endif
+
+	class PhysicsSystem final : public EngineSystem
+	{
+	public:
+		PhysicsSystem(Engine* engine) : EngineSystem(engine) {};
+
+		/* EngineSystem Interface */
+	public:
+		virtual std::string Name() const override { return PHYSICS_SYSTEM; }
+		virtual Memory::MemoryTag GetMemoryTag() const override { return Memory::MemoryTag::PHYSICS; }
+		virtual SystemDependencies GetDependencies() const override;
+	protected:
+		friend class Engine;
+		virtual void Startup() override;
+		virtual void Shutdown() override;
+
+		friend class PhysicsSystemDebug;
+
+		/* Physics System API */
+	public:
+		//
+		// FixedUpdate
+		// 
+		// Picks up new and changed RigidBodyComponents, steps the scene and writes positions back to
+		// the owning entity's TransformComponent. Runs before the world publishes its render state.
+		// Bodies need a TransformComponent on the same entity to be simulated. Moving the transform
+		// directly teleports the body there on the next step, keeping its velocity.
+		//
+		void FixedUpdate(float deltaTime);
+
+		Physics::PhysicsScene& GetScene() { return m_scene; }
+		const Physics::SceneStats& GetStats() const { return m_scene.GetStats(); }
+
+	private:
+		Physics::PhysicsScene m_scene;
+		std::shared_ptr<WorldQuery<RigidBodyComponent, TransformComponent>> m_bodies;
+
+		std::vector<Physics::BodyID> m_staleBodies;
+		std::vector<std::uint32_t> m_bodyStamps;
+		std::uint32_t m_syncStamp = 0;
+		std::uint64_t m_snapshotGeneration = 0;
+
+		void SyncBodies(WorldSystem& world);
+		void WriteBack();
+
+		void CreateTestScene();
+		void DropTestBodies(std::size_t amount);
+	};
+}
@@ -19,10 +19,12 @@ namespace CE
 	class RenderSystem final : public EngineSystem
 	{
 	public:
-		void Render();
+		// Alpha is how far between the last two simulation ticks this frame falls
+		void Render(float alpha);
 
 	private:
 		GLFWwindow* m_window = nullptr;
+		float m_alpha = 1.f;
 
 		void BeginFrame();
 		void DoFrame();
@@ -56,6 +58,9 @@ namespace CE
 		/* EngineSystem Interface */
 	public:
 		virtual std::string Name() const override { return "Render System"; }
+		virtual Memory::MemoryTag GetMemoryTag() const override { return Memory::MemoryTag::RENDER; }
+		virtual SystemDependencies GetDependencies() const override;
+		virtual bool RequiresMainThread() const override { return true; }
 		//virtual void DrawGUI() override { return; }
 
 		RenderSystem(Engine* engine) :
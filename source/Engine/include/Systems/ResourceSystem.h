@@ -3,10 +3,15 @@
 #include "Systems/EngineSystem.h"
 
 #include "Systems/LogSystem.h"
+#include "Jobs/JobScheduler.h"
+#include "Tasks/Task.h"
+#include "InplaceFunction.h"
 #include "stdlibincl.h"
 
 #include "Mesh.h"
 
+#include <mutex>
+
 namespace CE
 {
 	/* Resource Type Wizardry */
@@ -29,19 +34,44 @@ namespace CE
 	template <>
 	struct IsResourceType<rl::Mesh> : std::true_type {};
 
+	// Mesh geometry as it comes off disk, before anything is uploaded
+	struct MeshData
+	{
+		std::vector<rl::Vertex> vertices;
+		std::vector<size_t> indices;
+	};
+	template <>
+	struct IsResourceType<MeshData> : std::true_type {};
+
+	// What a resource is loaded into off the main thread, most types are built there completely
+	template<ResourceTypeConcept ResourceType>
+	struct ResourceStaging { using Type = ResourceType; };
+
+	// Meshes parse on a worker and upload on the main thread, which owns the GL context
+	template <>
+	struct ResourceStaging<rl::Mesh> { using Type = MeshData; };
+
+	template<ResourceTypeConcept ResourceType>
+	using StagedResource = typename ResourceStaging<ResourceType>::Type;
+
 
 	template<ResourceTypeConcept ResourceType>
 	struct ResourceRequest
 	{
+		using Callback = InplaceFunction<void(std::shared_ptr<ResourceType>)>;
+
 		std::filesystem::path m_resourcePath;
-		std::function<void(std::shared_ptr<ResourceType>)> m_callback;
+		Callback m_callback;
 
-		ResourceRequest(const std::filesystem::path rPath, std::function<void(std::shared_ptr<ResourceType>)> callback) :
+		ResourceRequest(const std::filesystem::path rPath, Callback callback) :
 			m_resourcePath(rPath),
 			m_callback(std::move(callback))
 		{};
 	};
 
+	template<ResourceTypeConcept ResourceType>
+	class ResourceAwaiter;
+
 	//
 	//	Resource System
 	// 
@@ -73,16 +103,20 @@ namespace CE
 
 	public:
 		// Request Resource
-		// Begins the process of loading a requested resource, adds the request to the queue
+		// Begins the process of loading a requested resource, adds the request to the queue.
+		// Safe from any thread, the callback always runs on the main thread.
 		template<ResourceTypeConcept ResourceType>
-		bool RequestResource(const std::filesystem::path& resourcePath, std::function<void(std::shared_ptr<ResourceType>)> callback)
+		bool RequestResource(const std::filesystem::path& resourcePath, typename ResourceRequest<ResourceType>::Callback callback)
 		{
 			if (!IsValidResourcePath(resourcePath)) {
 				LOG_ERROR(LogChannel::RESOURCES, "Failed loading resource. %s", resourcePath.string());
 				return false;
 			}
 
-			ResourceRequest req(resourcePath, callback);
+			MEMORY_SCOPE(Memory::MemoryTag::RESOURCES);
+			// Shared so the move-only callback can ride along through the load and finish jobs
+			auto req = std::make_shared<ResourceRequest<ResourceType>>(resourcePath, std::move(callback));
+			std::lock_guard<std::mutex> lock(m_requestMutex);
 			m_requests.push([this, req]() {
 				LOG_INFO(LogChannel::RESOURCES, "Processing Resource Request");
 				this->ProcessRequest<ResourceType>(req);
@@ -90,25 +124,66 @@ namespace CE
 			return true;
 		}
 
+		//
+		// Load
+		// 
+		// Awaitable from a task, requests the resource and resumes the task with it once it is ready.
+		// Null if it failed to load, straight away if the path was no good.
+		//
+		//		std::shared_ptr<rl::Mesh> mesh = co_await RS->Load<rl::Mesh>(path);
+		//
+		template<ResourceTypeConcept ResourceType>
+		ResourceAwaiter<ResourceType> Load(const std::filesystem::path& resourcePath)
+		{
+			return ResourceAwaiter<ResourceType>(*this, resourcePath);
+		}
+
 	private:
 		static bool IsValidResourcePath(const std::filesystem::path& rPath);
 
+		// Called once a frame by the engine, hands queued requests to the job system
+		void ProcessRequests();
+
+		// Disk reads and parsing, runs on a worker
 		template<ResourceTypeConcept ResourceType>
-		std::shared_ptr<ResourceType> LoadResource(const std::filesystem::path& resourcePath);
+		std::shared_ptr<StagedResource<ResourceType>> LoadResource(const std::filesystem::path& resourcePath);
 
+		// Whatever has to happen on the main thread to make the loaded resource usable
 		template<ResourceTypeConcept ResourceType>
-		void ProcessRequest(const ResourceRequest<ResourceType>& request)
+		std::shared_ptr<ResourceType> FinishResource(std::shared_ptr<StagedResource<ResourceType>> staged);
+
+		template<ResourceTypeConcept ResourceType>
+		void ProcessRequest(const std::shared_ptr<ResourceRequest<ResourceType>>& request)
 		{
 			// TODO Check for already loaded resources here
-			std::shared_ptr<ResourceType> loadedResource = std::move(LoadResource<ResourceType>(request.m_resourcePath));
-			request.m_callback(loadedResource);
+			m_jobs->Run([this, request]() {
+				MEMORY_SCOPE(Memory::MemoryTag::RESOURCES);
+				std::shared_ptr<StagedResource<ResourceType>> staged = LoadResource<ResourceType>(request->m_resourcePath);
+
+				m_jobs->RunOnMainThread([this, request, staged]() {
+					MEMORY_SCOPE(Memory::MemoryTag::RESOURCES);
+					std::shared_ptr<ResourceType> loadedResource = staged ? FinishResource<ResourceType>(staged) : nullptr;
+					if (request->m_callback)
+					{
+						request->m_callback(loadedResource);
+					}
+				}, &m_loads);
+			}, &m_loads);
 		}
 
-		std::queue<std::function<void()>> m_requests;
+		std::mutex m_requestMutex;
+		std::queue<InplaceFunction<void()>> m_requests;
+
+		Jobs::JobScheduler* m_jobs = nullptr;
+
+		// Every load in flight, from the worker job through to the main thread callback
+		Jobs::JobCounter m_loads;
 
 	public:
 		/* EngineSystem Interface */
 		virtual std::string Name() const override { return "Resource System"; }
+		virtual Memory::MemoryTag GetMemoryTag() const override { return Memory::MemoryTag::RESOURCES; }
+		virtual SystemDependencies GetDependencies() const override;
 
 		ResourceSystem(Engine* engine) : EngineSystem(engine) {};
 	
@@ -120,4 +195,35 @@ namespace CE
 		void Startup() override;
 		void Shutdown() override;
 	};
-}
\ No newline at end of file
+
+	// Returned by ResourceSystem::Load, lives in the suspended task's frame until it is resumed
+	template<ResourceTypeConcept ResourceType>
+	class ResourceAwaiter
+	{
+	public:
+		ResourceAwaiter(ResourceSystem& resources, const std::filesystem::path& resourcePath) :
+			m_resources(resources),
+			m_resourcePath(resourcePath)
+		{}
+
+		bool await_ready() const noexcept { return false; }
+
+		// Carries straight on with nothing if the request was turned down
+		template <typename Promise>
+		bool await_suspend(std::coroutine_handle<Promise> handle)
+		{
+			Tasks::TaskScheduler* tasks = handle.promise().GetScheduler();
+			return m_resources.RequestResource<ResourceType>(m_resourcePath, [this, tasks, handle](std::shared_ptr<ResourceType> resource) {
+				m_resource = std::move(resource);
+				tasks->Resume(handle);
+			});
+		}
+
+		std::shared_ptr<ResourceType> await_resume() { return std::move(m_resource); }
+
+	private:
+		ResourceSystem& m_resources;
+		std::filesystem::path m_resourcePath;
+		std::shared_ptr<ResourceType> m_resource;
+	};
+}
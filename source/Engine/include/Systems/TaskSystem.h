@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Systems/EngineSystem.h"
+#include "Tasks/Task.h"
+
+namespace CE
+{
+	class TaskSystem final : public EngineSystem
+	{
+	public:
+		TaskSystem(Engine* engine) : EngineSystem(engine) {};
+
+		/* EngineSystem Interface */
+	public:
+		virtual std::string Name() const override { return "Task System"; }
+		virtual SystemDependencies GetDependencies() const override;
+	protected:
+		friend class Engine;
+		virtual void Startup() override;
+		virtual void Shutdown() override;
+
+		/* Task System API */
+	public:
+		//
+		// Tasks
+		// 
+		// Spawned tasks run straight away up to their first await and are resumed by the engine from
+		// then on, see Tasks::Task. The scheduler lives for as long as the engine does, so tasks can be
+		// spawned before systems are up and start running with the first frame.
+		//
+		void Spawn(Tasks::Task<> task) { m_scheduler.Spawn(task.Release(m_scheduler)); }
+
+		// Called once a frame by the engine with the time the simulation is about to step
+		void Update(double deltaTime) { m_scheduler.Update(deltaTime); }
+
+		Tasks::TaskScheduler& GetScheduler() { return m_scheduler; }
+
+	private:
+		Tasks::TaskScheduler m_scheduler;
+	};
+}
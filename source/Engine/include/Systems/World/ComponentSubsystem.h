@@ -3,6 +3,7 @@
 #include "ObjectPool.h"
 #include "Globals.h"
 #include "Systems/LogSystem.h"
+#include "Systems/World/WorldSnapshot.h"
 
 #include <glm/glm.hpp>
 
@@ -11,9 +12,10 @@ namespace CE
 	class Component
 	{
 	public:
-		Component() : m_handle(ComponentHandle::INVALID) {}
+		Component() : m_handle(ComponentHandle::INVALID), m_owner(EntityHandle::INVALID) {}
 
 		ComponentHandle m_handle;
+		EntityHandle m_owner;
 	};
 
 	struct PoolInfo
@@ -30,15 +32,25 @@ namespace CE
 		virtual ~IComponentPool() = default;
 		virtual PoolInfo GetPoolInfo() { return PoolInfo(); }
 		virtual void Remove(const ComponentHandle& handle) = 0;
+		virtual bool IsValid(const ComponentHandle& handle) const = 0;
+
+		// Snapshots, only trivially copyable components can be written as raw blocks
+		virtual bool CanSnapshot() const { return false; }
+		virtual void WriteSnapshot(std::ostream& out) {}
+		virtual bool ValidateSnapshot(const std::byte* data, std::size_t size) const { return false; }
+		virtual bool ReadSnapshot(const std::byte* data, std::size_t size) { return false; }
 	};
 
+	// Per component type, pools only allocate storage as they fill
+	constexpr std::size_t s_maxComponentsPerType = 1 << 17;
+
 	template <typename ComponentType>
 	class ComponentPool : public IComponentPool
 	{
-		using ComponentPoolType = ObjectPool<ComponentType, 2048, ComponentHandle>;
+		using ComponentPoolType = ObjectPool<ComponentType, s_maxComponentsPerType, ComponentHandle>;
 
 	public:
-		ComponentPool(std::uint8_t cID) : m_pool({})
+		ComponentPool(std::uint8_t cID) : m_pool()
 		{
 			m_componentID = cID;
 		}
@@ -69,6 +81,11 @@ namespace CE
 			return &(m_pool.Get(handle));
 		}
 
+		bool IsValid(const ComponentHandle& handle) const override
+		{
+			return m_pool.IsValid(handle);
+		}
+
 		void ForEach(std::function<void(ComponentType*)> function)
 		{
 			for (auto& [handle, comp] : m_pool)
@@ -77,6 +94,38 @@ namespace CE
 			}
 		}
 
+		bool CanSnapshot() const override
+		{
+			return std::is_trivially_copyable_v<ComponentType>;
+		}
+
+		void WriteSnapshot(std::ostream& out) override
+		{
+			if constexpr (std::is_trivially_copyable_v<ComponentType>)
+			{
+				m_pool.WriteRaw(out);
+			}
+		}
+
+		bool ValidateSnapshot(const std::byte* data, std::size_t size) const override
+		{
+			if constexpr (std::is_trivially_copyable_v<ComponentType>)
+			{
+				typename ComponentPoolType::RawHeader header;
+				return ComponentPoolType::ValidateRaw(data, size, false, header);
+			}
+			return false;
+		}
+
+		bool ReadSnapshot(const std::byte* data, std::size_t size) override
+		{
+			if constexpr (std::is_trivially_copyable_v<ComponentType>)
+			{
+				return m_pool.ReadRaw(data, size);
+			}
+			return false;
+		}
+
 	private:
 		ComponentPoolType m_pool;
 		std::uint8_t m_componentID;
@@ -129,6 +178,35 @@ namespace CE
 			}
 		}
 		
+		bool IsValid(const ComponentHandle& handle)
+		{
+			if (!handle.IsValid() || handle.GetType() >= m_componentIDs.size()) { return false; }
+			return m_componentStorage[m_componentIDs[handle.GetType()]]->IsValid(handle);
+		}
+
+		// Components of this type that can still be added before the pool is full, zero if unregistered
+		template<typename T>
+		std::size_t GetFreeCount()
+		{
+			auto it = m_componentStorage.find(typeid(T));
+			if (it == m_componentStorage.end()) { return 0; }
+
+			const PoolInfo info = it->second->GetPoolInfo();
+			return info.maxCount - info.currentCount;
+		}
+
+		// Returns -1 for types that were never registered
+		template<typename T>
+		int GetComponentID() const
+		{
+			const std::type_index cType = typeid(T);
+			for (std::size_t id = 0; id < m_componentIDs.size(); id++)
+			{
+				if (m_componentIDs[id] == cType) { return static_cast<int>(id); }
+			}
+			return -1;
+		}
+
 		template<typename T>
 		T* GetComponent(const ComponentHandle& handle)
 		{
@@ -153,11 +231,25 @@ namespace CE
 
 		void DrawComponentPools();
 
+		// False if any registered pool can't be written, logging each one. A snapshot missing a pool
+		// would restore entities pointing at components that were never saved, so saving refuses.
+		bool CanSnapshot();
+		void WriteSnapshot(Snapshot::Writer& writer);
+
+		// Checks a section against the registered pools without changing anything
+		bool ValidateSnapshot(const Snapshot::Section& section);
+		bool ReadSnapshot(const Snapshot::Section& section);
+
+		std::size_t GetComponentTypeCount() const { return m_componentIDs.size(); }
+
 	private:
 		std::vector<std::type_index> m_componentIDs;
 		std::vector<std::string> m_componentNames;
 		std::unordered_map<std::type_index, std::shared_ptr<IComponentPool>> m_componentStorage;
 
+		// Null when the section doesn't belong to a registered pool
+		std::shared_ptr<IComponentPool> FindSnapshotPool(const Snapshot::Section& section);
+
 		template<typename T>
 		std::shared_ptr<ComponentPool<T>> GetComponentPool()
 		{
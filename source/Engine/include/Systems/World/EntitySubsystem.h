@@ -4,6 +4,7 @@
 #include "Handle.h"
 #include "ObjectPool.h"
 #include "Systems/LogSystem.h"
+#include "Systems/World/WorldSnapshot.h"
 
 namespace CE
 {
@@ -47,13 +48,25 @@ namespace CE
 			return m_components;
 		}
 
+		// Bulk replaces the component list, used when restoring snapshots
+		void AssignComponents(const ComponentHandle* components, std::size_t count)
+		{
+			m_components.assign(components, components + count);
+		}
+
+		// Keeps the list's storage for whoever takes the slot next
+		void ClearComponents()
+		{
+			m_components.clear();
+		}
+
 	private:
 		std::vector<ComponentHandle> m_components;
 	};
 
 	class EntitySubsystem
 	{
-		using EntityPool = ObjectPool<Entity, 100000, EntityHandle>;
+		using EntityPool = ObjectPool<Entity, 1 << 17, EntityHandle>;
 
 	public:
 		EntitySubsystem()
@@ -74,6 +87,12 @@ namespace CE
 			m_entityPool->Destroy(handle);
 		}
 
+		// Entities that can still be created before the pool is full
+		std::size_t GetFreeCount()
+		{
+			return m_entityPool->Capacity() - m_entityPool->GetFill();
+		}
+
 		Entity& Get(const EntityHandle& handle)
 		{
 			return m_entityPool->Get(handle);
@@ -91,8 +110,22 @@ namespace CE
 			entity.RemoveComponent(component);
 		}
 
+		void ForEachEntity(std::function<void(Entity&)> function)
+		{
+			for (auto& [handle, entity] : *m_entityPool)
+			{
+				function(entity);
+			}
+		}
+
 		void DrawEntityPool();
 
+		void WriteSnapshot(Snapshot::Writer& writer);
+
+		// Checks the whole section without changing anything, every component handle included
+		bool ValidateSnapshot(const Snapshot::Section& section, std::size_t componentTypeCount) const;
+		bool ReadSnapshot(const Snapshot::Section& section);
+
 	private:
 		std::unique_ptr<EntityPool> m_entityPool;
 	};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "stdlibincl.h"
+#include "Handle.h"
+
+#include <glm/glm.hpp>
+
+namespace CE
+{
+	struct RenderInstance
+	{
+		ComponentHandle handle;
+		glm::mat4 transform;
+	};
+
+	// Copy of the renderable world as it stood at the end of one simulation tick
+	struct RenderState
+	{
+		std::vector<RenderInstance> instances;
+		std::uint64_t tick = 0;
+	};
+
+	//
+	// RenderStateBuffer
+	// 
+	// Rendering interpolates between the last two published ticks, so both have to stay untouched
+	// while the simulation writes the next one. That makes it three states in rotation: previous and
+	// current are read-only for the renderer, the write state belongs to the simulation.
+	//
+	class RenderStateBuffer
+	{
+	public:
+		RenderStateBuffer() : m_states(), m_write(0), m_current(2), m_previous(1) {}
+
+		// Simulation side, fill the returned state then publish it
+		RenderState& BeginWrite()
+		{
+			RenderState& state = m_states[m_write];
+			state.instances.clear();
+			return state;
+		}
+
+		void Publish()
+		{
+			m_states[m_write].tick = m_states[m_current].tick + 1;
+
+			std::size_t oldPrevious = m_previous;
+			m_previous = m_current;
+			m_current = m_write;
+			m_write = oldPrevious;
+		}
+
+		const RenderState& GetPrevious() const { return m_states[m_previous]; }
+		const RenderState& GetCurrent() const { return m_states[m_current]; }
+
+		//
+		// Interpolate
+		// 
+		// Walks previous and current together and hands back transforms blended by alpha. Both states
+		// are filled in pool order so instances line up by handle index, anything new this tick has no
+		// previous position and is drawn where it is now.
+		//
+		template <typename Function>
+		void Interpolate(float alpha, Function&& function) const
+		{
+			const std::vector<RenderInstance>& previous = GetPrevious().instances;
+			const std::vector<RenderInstance>& current = GetCurrent().instances;
+
+			std::size_t p = 0;
+			for (const RenderInstance& instance : current)
+			{
+				const std::uint64_t index = instance.handle.GetIndex();
+				while (p < previous.size() && previous[p].handle.GetIndex() < index)
+				{
+					p++;
+				}
+
+				if (p < previous.size() && previous[p].handle == instance.handle)
+				{
+					// Only blend translation, lerping full rotation matrices would shear them
+					glm::mat4 blended = instance.transform;
+					blended[3] = previous[p].transform[3] + (instance.transform[3] - previous[p].transform[3]) * alpha;
+					function(instance.handle, blended);
+				}
+				else
+				{
+					function(instance.handle, instance.transform);
+				}
+			}
+		}
+
+	private:
+		std::array<RenderState, 3> m_states;
+		std::size_t m_write;
+		std::size_t m_current;
+		std::size_t m_previous;
+	};
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "stdlibincl.h"
+#include "Handle.h"
+
+#include <glm/glm.hpp>
+#include <span>
+
+namespace CE
+{
+	struct RangeQuery
+	{
+		glm::vec3 center;
+		float radius;
+	};
+
+	struct Ray
+	{
+		glm::vec3 origin;
+		glm::vec3 direction;
+		float maxDistance;
+	};
+
+	struct RaycastHit
+	{
+		EntityHandle entity;
+		ComponentHandle component;
+		float distance;
+
+		RaycastHit() : entity(EntityHandle::INVALID), component(ComponentHandle::INVALID), distance(0.f) {}
+
+		bool IsHit() const { return entity.IsValid(); }
+	};
+
+	//
+	// SpatialSubsystem
+	//	- Uniform hash grid over transform positions, items are bounding spheres
+	//	- Items live in the cell holding their center, queries widen their search by the
+	//	  largest radius seen so spheres poking into neighbouring cells are still found
+	//	- Moves only touch the grid when an item crosses a cell boundary
+	//	- Positions are clamped to the range cell keys can tell apart, anything further out
+	//	  shares the outermost cells
+	//
+	class SpatialSubsystem
+	{
+	public:
+		explicit SpatialSubsystem(float cellSize = 10.f) :
+			m_cellSize(cellSize),
+			m_invCellSize(1.f / cellSize),
+			m_maxRadius(0.f),
+			m_maxRadiusCount(0)
+		{}
+
+		// Inserts if the component isn't indexed yet
+		void Update(const EntityHandle& entity, const ComponentHandle& component, const glm::vec3& position, float radius);
+		void Remove(const ComponentHandle& component);
+		void Clear();
+
+		std::size_t GetItemCount() const { return m_items.size(); }
+		std::size_t GetCellCount() const { return m_cells.size(); }
+		float GetCellSize() const { return m_cellSize; }
+
+		//
+		// Queries
+		// 
+		// Results are appended to the output containers so callers can reuse them frame to frame.
+		// Batched variants write each query's results back to back, offsets[i] is where query i
+		// starts and offsets has one extra entry marking the end.
+		//
+		void QueryRange(const glm::vec3& center, float radius, std::vector<EntityHandle>& results) const;
+		void QueryRanges(std::span<const RangeQuery> queries, std::vector<EntityHandle>& results, std::vector<std::size_t>& offsets) const;
+
+		// Closest k items by center distance, nearest first
+		void QueryNearest(const glm::vec3& point, std::size_t k, std::vector<EntityHandle>& results) const;
+		void QueryNearestBatch(std::span<const glm::vec3> points, std::size_t k, std::vector<EntityHandle>& results, std::vector<std::size_t>& offsets) const;
+
+		// Ray direction must be normalized
+		RaycastHit Raycast(const Ray& ray) const;
+		void Raycasts(std::span<const Ray> rays, std::vector<RaycastHit>& hits) const;
+
+	private:
+		using CellKey = std::uint64_t;
+
+		struct CellCoord
+		{
+			std::int32_t x, y, z;
+		};
+
+		struct Item
+		{
+			EntityHandle entity;
+			ComponentHandle component;
+			glm::vec3 position;
+			float radius;
+			CellKey cell;
+			std::uint32_t cellSlot;
+		};
+
+		static constexpr std::uint32_t s_invalidItem = std::numeric_limits<std::uint32_t>::max();
+
+		// Cell keys hold 21 bits per axis
+		static constexpr std::int32_t s_maxCellCoord = (1 << 20) - 1;
+
+		float m_cellSize;
+		float m_invCellSize;
+
+		// Largest radius indexed and how many items have it, rescanned only when the last of them
+		// shrinks or leaves
+		float m_maxRadius;
+		std::size_t m_maxRadiusCount;
+
+		// Dense item storage, m_lookup maps component index to position in m_items
+		std::vector<Item> m_items;
+		std::vector<std::uint32_t> m_lookup;
+		std::unordered_map<CellKey, std::vector<std::uint32_t>> m_cells;
+
+		// Bounds of every cell that has ever held an item, caps how far nearest queries search
+		CellCoord m_minCell{ 0, 0, 0 };
+		CellCoord m_maxCell{ 0, 0, 0 };
+		bool m_bHasBounds = false;
+
+		CellCoord ToCell(const glm::vec3& position) const;
+		static CellKey ToKey(const CellCoord& coord);
+
+		std::int32_t GetSearchMargin() const;
+
+		void AddRadius(float radius);
+		void RemoveRadius(float radius);
+
+		void AddToCell(std::uint32_t itemIndex, CellKey cell);
+		void RemoveFromCell(std::uint32_t itemIndex);
+
+		template <typename Function>
+		void ForEachInCell(CellKey cell, Function&& function) const
+		{
+			auto it = m_cells.find(cell);
+			if (it == m_cells.end()) { return; }
+			for (std::uint32_t itemIndex : it->second)
+			{
+				function(m_items[itemIndex]);
+			}
+		}
+	};
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "stdlibincl.h"
+#include "Handle.h"
+#include "Systems/World/ComponentSubsystem.h"
+
+#include <span>
+#include <tuple>
+
+namespace CE
+{
+	class IWorldQuery
+	{
+	public:
+		virtual ~IWorldQuery() = default;
+
+		// Re-evaluates one entity after its component list changed
+		virtual void OnEntityChanged(const EntityHandle& entity, std::span<const ComponentHandle> components, ComponentSubsystem& componentSubsystem) = 0;
+		virtual void OnEntityDestroyed(const EntityHandle& entity) = 0;
+		virtual void Clear() = 0;
+
+		virtual std::string_view GetName() const = 0;
+		virtual std::size_t GetMatchCount() const = 0;
+	};
+
+	//
+	// WorldQuery<ComponentTypes...>
+	// 
+	// Persistent list of every entity that has at least one of each component type, along with
+	// pointers to those components (the first of each type on the entity). The world keeps the list
+	// current as components come and go, so iterating does no matching at all.
+	// 
+	// Component pools never move their storage so the cached pointers stay good until the world
+	// tells the query otherwise. Match order is not stable, removal swaps the last match into place.
+	// Don't add or remove components from inside ForEach.
+	//
+	template <typename... ComponentTypes>
+	class WorldQuery final : public IWorldQuery
+	{
+		static constexpr std::size_t ComponentCount = sizeof...(ComponentTypes);
+
+	public:
+		struct Match
+		{
+			EntityHandle entity;
+			std::tuple<ComponentTypes*...> components;
+		};
+
+		WorldQuery(std::string name, const std::array<int, ComponentCount>& componentIDs) :
+			m_name(std::move(name)),
+			m_componentIDs(componentIDs)
+		{}
+
+		// Calls function(entity, ComponentTypes&...) for every match
+		template <typename Function>
+		void ForEach(Function&& function)
+		{
+			for (Match& match : m_matches)
+			{
+				std::apply([&](ComponentTypes*... components) {
+					function(match.entity, *components...);
+				}, match.components);
+			}
+		}
+
+		std::span<const Match> GetMatches() const { return m_matches; }
+
+		void OnEntityChanged(const EntityHandle& entity, std::span<const ComponentHandle> components, ComponentSubsystem& componentSubsystem) override
+		{
+			Match match{ entity, {} };
+			const bool bMatches = Resolve(components, componentSubsystem, match, std::index_sequence_for<ComponentTypes...>{});
+
+			const std::size_t index = entity.GetIndex();
+			const std::uint32_t slot = index < m_slots.size() ? m_slots[index] : 0;
+
+			if (bMatches)
+			{
+				if (slot != 0)
+				{
+					m_matches[slot - 1] = match;
+					return;
+				}
+
+				if (index >= m_slots.size())
+				{
+					m_slots.resize(index + 1, 0);
+				}
+				m_matches.push_back(match);
+				m_slots[index] = static_cast<std::uint32_t>(m_matches.size());
+			}
+			else if (slot != 0)
+			{
+				RemoveAt(slot - 1);
+			}
+		}
+
+		void OnEntityDestroyed(const EntityHandle& entity) override
+		{
+			const std::size_t index = entity.GetIndex();
+			if (index < m_slots.size() && m_slots[index] != 0)
+			{
+				RemoveAt(m_slots[index] - 1);
+			}
+		}
+
+		void Clear() override
+		{
+			m_matches.clear();
+			m_slots.clear();
+		}
+
+		std::string_view GetName() const override { return m_name; }
+		std::size_t GetMatchCount() const override { return m_matches.size(); }
+
+	private:
+		std::string m_name;
+		std::array<int, ComponentCount> m_componentIDs;
+
+		std::vector<Match> m_matches;
+
+		// Entity index to match index + 1, zero when the entity doesn't match
+		std::vector<std::uint32_t> m_slots;
+
+		void RemoveAt(std::uint32_t matchIndex)
+		{
+			const std::size_t removedEntity = m_matches[matchIndex].entity.GetIndex();
+
+			m_matches[matchIndex] = m_matches.back();
+			m_slots[m_matches[matchIndex].entity.GetIndex()] = matchIndex + 1;
+			m_matches.pop_back();
+
+			m_slots[removedEntity] = 0;
+		}
+
+		template <std::size_t... Indices>
+		bool Resolve(std::span<const ComponentHandle> components, ComponentSubsystem& componentSubsystem, Match& match, std::index_sequence<Indices...>)
+		{
+			return (ResolveOne<Indices>(components, componentSubsystem, match) && ...);
+		}
+
+		template <std::size_t Index>
+		bool ResolveOne(std::span<const ComponentHandle> components, ComponentSubsystem& componentSubsystem, Match& match)
+		{
+			using ComponentType = std::tuple_element_t<Index, std::tuple<ComponentTypes...>>;
+
+			const int componentID = m_componentIDs[Index];
+			if (componentID < 0) { return false; }
+
+			for (const ComponentHandle& handle : components)
+			{
+				if (handle.GetType() == static_cast<ComponentHandle::UnderlyingType>(componentID))
+				{
+					std::get<Index>(match.components) = componentSubsystem.GetComponent<ComponentType>(handle);
+					return true;
+				}
+			}
+			return false;
+		}
+	};
+}
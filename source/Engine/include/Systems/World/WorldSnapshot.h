@@ -0,0 +1,94 @@
+#pragma once
+
+#include "stdlibincl.h"
+
+namespace CE::Snapshot
+{
+	//
+	// World Snapshot File Layout
+	// 
+	// | Header | Section | Section | ... |
+	// 
+	// Each section is a SectionHeader, its name, then its payload. Payloads start on an Alignment
+	// boundary so a memory mapped file can be copied straight into pools without any fixups.
+	//
+	// Bump Version whenever a section payload changes shape, old files are rejected rather than misread.
+	//
+	constexpr std::array<char, 4> Magic = { 'C', 'S', 'N', 'P' };
+	constexpr std::uint32_t Version = 3;
+	constexpr std::size_t Alignment = 16;
+
+	enum class SectionType : std::uint32_t
+	{
+		ENTITIES = 1,
+		COMPONENTS = 2
+	};
+
+	struct Header
+	{
+		std::array<char, 4> magic;
+		std::uint32_t version;
+		std::uint32_t sectionCount;
+		std::uint32_t reserved;
+	};
+
+	struct SectionHeader
+	{
+		SectionType type;
+		std::uint32_t id;
+		std::uint32_t nameLength;
+		std::uint32_t reserved;
+		std::uint64_t payloadSize;
+	};
+
+	struct Section
+	{
+		SectionHeader header;
+		std::string_view name;
+		const std::byte* payload;
+	};
+
+	class Writer
+	{
+	public:
+		explicit Writer(std::ostream& out);
+
+		std::ostream& BeginSection(SectionType type, std::uint32_t id, std::string_view name);
+		void EndSection();
+
+		// Patches the section count in the header, call once all sections are written
+		bool Finish();
+
+	private:
+		void Pad();
+
+		std::ostream& m_out;
+		std::streampos m_sectionStart;
+		std::streampos m_payloadStart;
+		std::uint32_t m_sectionCount;
+	};
+
+	class Reader
+	{
+	public:
+		Reader(const std::byte* data, std::size_t size) : m_data(data), m_size(size), m_offset(0), m_remaining(0) {}
+
+		bool ReadHeader();
+		bool NextSection(Section& section);
+
+		// Sections the header promised that haven't been read, nonzero once NextSection stops means
+		// the file was cut short
+		std::uint32_t GetRemainingSections() const { return m_remaining; }
+
+	private:
+		const std::byte* m_data;
+		std::size_t m_size;
+		std::size_t m_offset;
+		std::uint32_t m_remaining;
+	};
+
+	constexpr std::size_t AlignUp(std::size_t value)
+	{
+		return (value + Alignment - 1) & ~(Alignment - 1);
+	}
+}
@@ -6,6 +6,10 @@
 #include "ObjectPool.h"
 #include "Systems/World/EntitySubsystem.h"
 #include "Systems/World/ComponentSubsystem.h"
+#include "Systems/World/RenderState.h"
+#include "Systems/World/SpatialSubsystem.h"
+#include "Systems/World/WorldQuery.h"
+#include "Components/TransformComponent.h"
 #include "Systems/LogSystem.h"
 
 #define WORLD_SYSTEM "World System"
@@ -26,6 +30,8 @@ namespace CE
 		/* EngineSystem Interface */
 	public:
 		virtual std::string Name() const override { return WORLD_SYSTEM; }
+		virtual Memory::MemoryTag GetMemoryTag() const override { return Memory::MemoryTag::WORLD; }
+		virtual SystemDependencies GetDependencies() const override;
 	protected:
 		friend class Engine;
 		virtual void Startup() override;
@@ -46,6 +52,13 @@ namespace CE
 			ComponentType* component = m_components.AddComponent<ComponentType>();
 			// Add component handle to entity
 			m_entities.AddComponentToEntity(handle, component->m_handle);
+			component->m_owner = handle;
+			if constexpr (std::is_same_v<ComponentType, TransformComponent>)
+			{
+				component->m_dirtyList = &m_dirtyTransforms;
+				component->MarkDirty();
+			}
+			NotifyEntityChanged(handle);
 			return component;
 		}
 
@@ -55,12 +68,44 @@ namespace CE
 			m_entities.RemoveComponentFromEntity(entityHandle, componentHandle);
 			// Remove component from pools
 			m_components.RemoveComponent(componentHandle);
+			m_spatial.Remove(componentHandle);
+			NotifyEntityChanged(entityHandle);
 		}
 
+		// First component of the given type on the entity, null if it has none
 		template <typename ComponentType>
-		ComponentType& GetComponent(const EntityHandle& entityHandle)
+		ComponentType* GetComponent(const EntityHandle& entityHandle)
 		{
-			return ComponentType();
+			const int componentID = m_components.GetComponentID<ComponentType>();
+			if (componentID < 0) { return nullptr; }
+
+			for (const ComponentHandle& handle : m_entities.Get(entityHandle).GetComponentList())
+			{
+				if (handle.GetType() == static_cast<ComponentHandle::UnderlyingType>(componentID))
+				{
+					return m_components.GetComponent<ComponentType>(handle);
+				}
+			}
+			return nullptr;
+		}
+
+		// Entity and component handles share a type, so this can't overload GetComponent
+		template <typename ComponentType>
+		ComponentType* GetComponentByHandle(const ComponentHandle& componentHandle)
+		{
+			if (!m_components.IsValid(componentHandle)) { return nullptr; }
+			return m_components.GetComponent<ComponentType>(componentHandle);
+		}
+
+		// Pools are fixed size, anything adding in bulk checks for room first
+		std::size_t GetFreeEntityCount() { return m_entities.GetFreeCount(); }
+
+		template <typename ComponentType>
+		std::size_t GetFreeComponentCount() { return m_components.GetFreeCount<ComponentType>(); }
+
+		bool IsComponentValid(const ComponentHandle& componentHandle)
+		{
+			return m_components.IsValid(componentHandle);
 		}
 
 		template <typename ComponentType>
@@ -71,15 +116,90 @@ namespace CE
 			m_components.RegisterComponent<ComponentType>();
 		}
 
+		//
+		// CreateQuery<ComponentTypes...>
+		// 
+		// Registers a persistent query over every entity holding all of the given component types.
+		// The world keeps it up to date as components are added and removed, callers iterate it every
+		// frame for free. The world only holds it weakly, drop the last reference to unregister it.
+		// Component types need registering before the query is created.
+		//
+		template <typename... ComponentTypes>
+		std::shared_ptr<WorldQuery<ComponentTypes...>> CreateQuery(std::string name)
+		{
+			const std::array<int, sizeof...(ComponentTypes)> componentIDs{ m_components.GetComponentID<ComponentTypes>()... };
+			if (std::find(componentIDs.begin(), componentIDs.end(), -1) != componentIDs.end())
+			{
+				LOG_WARN(WORLD, "Query {} uses an unregistered component and will never match", name);
+			}
+
+			auto query = std::make_shared<WorldQuery<ComponentTypes...>>(std::move(name), componentIDs);
+			PopulateQuery(*query);
+			m_queries.push_back(query);
+			return query;
+		}
+
 		template <typename ComponentType>
 		void ForEachComponent(std::function<void(ComponentType*)> function)
 		{
 			m_components.ForEachComponent<ComponentType>(std::move(function));
 		}
 
+		//
+		// Snapshots
+		// 
+		// Writes every entity and component pool to a versioned binary file. Loading maps the file
+		// and copies pools back in bulk, components must be registered in the same order as when saved.
+		//
+		bool SaveSnapshot(const std::filesystem::path& path);
+		bool LoadSnapshot(const std::filesystem::path& path);
+
+		// Bumped by every successful load so systems holding world state know to rebuild it
+		std::uint64_t GetSnapshotGeneration() const { return m_snapshotGeneration; }
+
+		//
+		// Simulation
+		// 
+		// Runs after physics each fixed step, bringing the spatial index up to date and publishing the
+		// resulting render state. Rendering only ever reads published states so it never sees a half
+		// simulated world. Nothing in the world is integrated over time here, physics owns that.
+		//
+		void FixedUpdate();
+
+		const RenderStateBuffer& GetRenderState() const { return m_renderState; }
+
+		//
+		// Spatial Queries
+		// 
+		// Range, nearest and raycast queries over transform positions. Transform setters queue the
+		// component and each tick syncs only what was queued, so results lag writes by one step.
+		//
+		const SpatialSubsystem& GetSpatialIndex() const { return m_spatial; }
+
 	private:
 		ComponentSubsystem m_components;
 		EntitySubsystem m_entities;
+		RenderStateBuffer m_renderState;
+		SpatialSubsystem m_spatial;
+		std::uint64_t m_snapshotGeneration = 0;
+
+		// Transforms changed since the last sync, so it only visits the ones that moved. Main thread only.
+		std::vector<ComponentHandle> m_dirtyTransforms;
+
+		std::vector<std::weak_ptr<IWorldQuery>> m_queries;
+
+		void NotifyEntityChanged(const EntityHandle& handle);
+		void NotifyEntityDestroyed(const EntityHandle& handle);
+		void PopulateQuery(IWorldQuery& query);
+		void RebuildQueries();
+
+		// Walks a copy of the reader checking every section, so a load only starts changing the world
+		// once it can't fail part way. The caller's reader is left at the first section.
+		bool ValidateSnapshot(Snapshot::Reader reader);
+
+		void PublishRenderState();
+		void SyncSpatialIndex();
+		void RebuildSpatialIndex();
 
 		void CreateTestComponents(std::size_t amount);
 		void OnAddTestComponents();
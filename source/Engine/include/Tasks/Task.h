@@ -0,0 +1,227 @@
+#pragma once
+
+#include "Tasks/TaskScheduler.h"
+
+#include <coroutine>
+#include <optional>
+#include <utility>
+
+namespace CE::Tasks
+{
+	template <typename T = void>
+	class Task;
+
+	namespace Detail
+	{
+		class PromiseBase
+		{
+		public:
+			std::suspend_always initial_suspend() noexcept { return {}; }
+
+			// Hands straight back to whoever awaited the task, spawned tasks let the scheduler clean up
+			struct FinalAwaiter
+			{
+				bool await_ready() noexcept { return false; }
+
+				template <typename Promise>
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+				{
+					PromiseBase& promise = handle.promise();
+					if (promise.m_continuation)
+					{
+						return promise.m_continuation;
+					}
+					if (promise.m_bSpawned)
+					{
+						promise.m_scheduler->Finish(handle);
+					}
+					return std::noop_coroutine();
+				}
+
+				void await_resume() noexcept {}
+			};
+
+			FinalAwaiter final_suspend() noexcept { return {}; }
+
+			// Built without exceptions in mind, there is nobody sensible to rethrow to
+			void unhandled_exception() noexcept { std::terminate(); }
+
+			TaskScheduler* GetScheduler() const { return m_scheduler; }
+
+		private:
+			template <typename T>
+			friend class Tasks::Task;
+
+			TaskScheduler* m_scheduler = nullptr;
+			std::coroutine_handle<> m_continuation;
+			bool m_bSpawned = false;
+		};
+
+		template <typename T>
+		class Promise : public PromiseBase
+		{
+		public:
+			Task<T> get_return_object() noexcept;
+
+			void return_value(T value) { m_value.emplace(std::move(value)); }
+			T TakeValue() { return std::move(*m_value); }
+
+		private:
+			std::optional<T> m_value;
+		};
+
+		template <>
+		class Promise<void> : public PromiseBase
+		{
+		public:
+			Task<void> get_return_object() noexcept;
+
+			void return_void() noexcept {}
+			void TakeValue() {}
+		};
+	}
+
+	//
+	// Task
+	//
+	// Coroutine return type for gameplay and loading code that has to wait on things without holding
+	// up the frame. A task does nothing until it is either spawned onto the scheduler or awaited by
+	// another task, which then carries on once it returns. Every resume happens on the main thread,
+	// so tasks can touch systems freely between awaits.
+	//
+	//		Tasks::Task<> SpawnWave(Engine& engine)
+	//		{
+	//			auto mesh = co_await engine.GetSystem<ResourceSystem>()->Load<rl::Mesh>(path);
+	//			for (int i = 0; i < 10; i++)
+	//			{
+	//				SpawnEnemy(mesh);
+	//				co_await Tasks::Seconds(0.5);
+	//			}
+	//		}
+	//
+	//		engine.GetSystem<TaskSystem>()->Spawn(SpawnWave(engine));
+	//
+	template <typename T>
+	class [[nodiscard]] Task
+	{
+	public:
+		using promise_type = Detail::Promise<T>;
+		using Handle = std::coroutine_handle<promise_type>;
+
+		Task() = default;
+		explicit Task(Handle handle) : m_handle(handle) {}
+
+		Task(Task&& other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+		Task& operator=(Task&& other) noexcept
+		{
+			if (this != &other)
+			{
+				Reset();
+				m_handle = std::exchange(other.m_handle, nullptr);
+			}
+			return *this;
+		}
+
+		Task(const Task&) = delete;
+		Task& operator=(const Task&) = delete;
+
+		~Task() { Reset(); }
+
+		bool IsValid() const { return static_cast<bool>(m_handle); }
+		bool IsDone() const { return m_handle && m_handle.done(); }
+
+		struct Awaiter
+		{
+			Handle handle;
+
+			bool await_ready() noexcept { return !handle || handle.done(); }
+
+			template <typename Promise>
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> awaiting) noexcept
+			{
+				handle.promise().m_scheduler = awaiting.promise().GetScheduler();
+				handle.promise().m_continuation = awaiting;
+				return handle;
+			}
+
+			T await_resume() { return handle.promise().TakeValue(); }
+		};
+
+		// Awaiting runs the task inline on the awaiting task's scheduler
+		Awaiter operator co_await() && noexcept { return Awaiter{ m_handle }; }
+
+		// Gives the coroutine up to the scheduler, which destroys it once it finishes
+		Handle Release(TaskScheduler& scheduler)
+		{
+			assert(m_handle);
+			m_handle.promise().m_scheduler = &scheduler;
+			m_handle.promise().m_bSpawned = true;
+			return std::exchange(m_handle, nullptr);
+		}
+
+	private:
+		Handle m_handle;
+
+		void Reset()
+		{
+			if (m_handle)
+			{
+				m_handle.destroy();
+				m_handle = nullptr;
+			}
+		}
+	};
+
+	namespace Detail
+	{
+		template <typename T>
+		Task<T> Promise<T>::get_return_object() noexcept
+		{
+			return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+		}
+
+		inline Task<void> Promise<void>::get_return_object() noexcept
+		{
+			return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+		}
+	}
+
+	//
+	// Awaitables
+	//
+	// Only usable from inside a Task, they find the scheduler through the awaiting task's promise.
+	//
+	struct NextFrameAwaiter
+	{
+		bool await_ready() const noexcept { return false; }
+
+		template <typename Promise>
+		void await_suspend(std::coroutine_handle<Promise> handle) const
+		{
+			handle.promise().GetScheduler()->WaitFrame(handle);
+		}
+
+		void await_resume() const noexcept {}
+	};
+
+	struct SecondsAwaiter
+	{
+		double seconds = 0.0;
+
+		bool await_ready() const noexcept { return seconds <= 0.0; }
+
+		template <typename Promise>
+		void await_suspend(std::coroutine_handle<Promise> handle) const
+		{
+			handle.promise().GetScheduler()->WaitSeconds(handle, seconds);
+		}
+
+		void await_resume() const noexcept {}
+	};
+
+	// Resumes at the start of next frame's update
+	inline NextFrameAwaiter NextFrame() { return {}; }
+
+	// Resumes once this much simulation time has passed, so it pauses, slows down and replays with the game
+	inline SecondsAwaiter Seconds(double seconds) { return { seconds }; }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "stdlibincl.h"
+
+#include <coroutine>
+#include <mutex>
+
+namespace CE::Tasks
+{
+	struct TaskStats
+	{
+		std::size_t running = 0;
+		std::size_t waitingFrame = 0;
+		std::size_t waitingTime = 0;
+		std::uint64_t resumed = 0;
+	};
+
+	//
+	// TaskScheduler
+	//
+	// Resumes suspended coroutines from the engine loop, always on the main thread. Tasks wait for the
+	// next frame, for an amount of simulation time, or on something outside the scheduler like a job
+	// or a resource load, which hands the coroutine back through Resume from whatever thread it
+	// finished on. Everything due is resumed once a frame in Update, in the order it became due.
+	//
+	// Spawned tasks are owned here until they finish, anything still suspended when the scheduler is
+	// cleared is destroyed along with the tasks it was waiting inside of.
+	//
+	class TaskScheduler
+	{
+	public:
+		TaskScheduler() = default;
+		~TaskScheduler();
+
+		TaskScheduler(const TaskScheduler&) = delete;
+		TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+		// Takes ownership of a top level task and runs it up to its first suspension
+		void Spawn(std::coroutine_handle<> root);
+
+		// Called by a spawned task as it completes
+		void Finish(std::coroutine_handle<> root);
+
+		void WaitFrame(std::coroutine_handle<> handle);
+		void WaitSeconds(std::coroutine_handle<> handle, double seconds);
+
+		// Safe from any thread, the task picks up on the main thread next Update
+		void Resume(std::coroutine_handle<> handle);
+
+		// Called once a frame with the time the simulation is about to step
+		void Update(double deltaTime);
+
+		// Destroys every task still running without resuming any of them
+		void Clear();
+
+		// Simulation time the scheduler has seen, what Seconds waits count against
+		double GetTime() const { return m_time; }
+
+		TaskStats GetStats() const;
+
+	private:
+		struct Timer
+		{
+			double wakeTime;
+			std::uint64_t order;
+			std::coroutine_handle<> handle;
+
+			// Earliest first, ties broken by who started waiting first
+			bool operator>(const Timer& other) const
+			{
+				return wakeTime != other.wakeTime ? wakeTime > other.wakeTime : order > other.order;
+			}
+		};
+
+		double m_time = 0.0;
+		std::uint64_t m_timerOrder = 0;
+		std::uint64_t m_resumeCount = 0;
+
+		std::vector<std::coroutine_handle<>> m_roots;
+		std::vector<std::coroutine_handle<>> m_nextFrame;
+		std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> m_timers;
+
+		mutable std::mutex m_resumeMutex;
+		std::vector<std::coroutine_handle<>> m_resumed;
+
+		// Reused each Update so resuming doesn't allocate
+		std::vector<std::coroutine_handle<>> m_ready;
+	};
+}
@@ -5,30 +5,74 @@
 #include "Systems/EventSystem.h"
 #include "Systems/RenderSystem.h"
 #include "Systems/WorldSystem.h"
+#include "Systems/PhysicsSystem.h"
 #include "Systems/LogSystem.h"
+#include "Systems/JobSystem.h"
+#include "Systems/TaskSystem.h"
 
 #include "GUI/Editor.h"
 #include "GUI/FrameCounter.h"
+#include "GUI/ProfilerWindow.h"
+#include "GUI/MemoryWindow.h"
+#include "Memory/MemoryTracker.h"
+#include "Profiling/Profiler.h"
+
+#include <atomic>
+#include <thread>
+#include <unordered_set>
 
 
 namespace CE
 {
-	Engine::Engine() :
+	Engine::Engine(const EngineConfig& config) :
+		m_config(config),
 		m_exit(false),
 		m_window(nullptr),
 		m_frameCounter(nullptr)
 	{
 		std::cout << "Good Morning Engine" << std::endl;
+
+		// Configs built in code skip the command line checks
+		if (!SetFixedTimeStep(1.0 / m_config.tickRate))
+		{
+			std::cerr << "Tick rate " << m_config.tickRate << " is invalid, using 60" << std::endl;
+			SetFixedTimeStep(1.0 / 60.0);
+		}
+		m_pacer.SetTargetRate(m_config.frameRate);
+		m_pacer.SetLowLatency(m_config.bLowLatency);
 	}
 
 	Engine::~Engine()
 	{
 		std::cout << "Good Night Engine" << std::endl;
 
+		if (m_recorder.IsOpen())
+		{
+			const std::uint64_t frames = m_recorder.GetFrameCount();
+			std::string path = m_config.recordPath.string();
+			LOG_INFO(ENGINE, "Recorded {} frames to {}", frames, path);
+			m_recorder.Close();
+		}
+
+		if (m_frameCounter != nullptr && !m_config.statsPath.empty())
+		{
+			m_frameCounter->WriteStats(m_config.statsPath);
+		}
 		delete m_frameCounter;
+#if defined(CDEBUG) && defined(CE_PROFILING)
+		delete m_profilerWindow;
+#endif
+#if defined(CDEBUG) && defined(CE_MEMORY_TRACKING)
+		delete m_memoryWindow;
+#endif
 
 		ShutdownSystems();
 
+		if (IsHeadless())
+		{
+			return;
+		}
+
 		ImGui_ImplOpenGL3_Shutdown();
 		ImGui_ImplGlfw_Shutdown();
 
@@ -37,7 +81,18 @@ namespace CE
 
 	void Engine::Start()
 	{
-		
+		// Anything a system doesn't claim is the engine's
+		MEMORY_SCOPE(Memory::MemoryTag::ENGINE);
+
+		for (std::size_t i = 0; i < Memory::s_tagCount; i++)
+		{
+			Memory::MemoryTracker::Get().SetBudget(static_cast<Memory::MemoryTag>(i), m_config.memoryBudgets[i]);
+		}
+
+		if (OpenReplay() == false)
+		{
+			return;
+		}
 
 		if (Initialize() == false)
 		{
@@ -56,8 +111,53 @@ namespace CE
 		CoreLoop();
 	}
 
+	bool Engine::OpenReplay()
+	{
+		// Seeded before any system starts, startups are free to use random numbers too
+		std::uint32_t seed = m_config.seed != 0 ? m_config.seed : Globals::g_rand.GetSeed();
+
+		if (!m_config.replayPath.empty())
+		{
+			if (!m_replay.Open(m_config.replayPath))
+			{
+				std::cerr << "Failed to open replay " << m_config.replayPath << std::endl;
+				return false;
+			}
+
+			const Replay::ReplayHeader& header = m_replay.GetHeader();
+			seed = header.seed;
+			if (!SetFixedTimeStep(1.0 / header.tickRate))
+			{
+				std::cerr << "Replay " << m_config.replayPath << " has an invalid tick rate of " << header.tickRate << std::endl;
+				return false;
+			}
+		}
+
+		Globals::g_rand.Seed(seed);
+
+		if (!m_config.recordPath.empty())
+		{
+			Replay::ReplayHeader header;
+			header.seed = seed;
+			header.tickRate = 1.0 / m_fixedDeltaTime;
+			if (!m_recorder.Open(m_config.recordPath, header))
+			{
+				std::cerr << "Failed to open " << m_config.recordPath << " for recording" << std::endl;
+				return false;
+			}
+		}
+
+		return true;
+	}
+
 	bool Engine::Initialize()
 	{
+		// Dedicated servers and CI boxes may have no display or GPU at all, don't touch GLFW
+		if (IsHeadless())
+		{
+			return true;
+		}
+
 		if (!glfwInit()) {
 			std::cerr << "Failed to initialize GLFW" << std::endl;
 			return false;
@@ -67,7 +167,7 @@ namespace CE
 		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
 		glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE); // Use the core profile
 
-		m_window = glfwCreateWindow(1920, 1080, "Render Window", nullptr, nullptr);
+		m_window = glfwCreateWindow(m_config.windowWidth, m_config.windowHeight, "Render Window", nullptr, nullptr);
 		if (m_window == nullptr) {
 			std::cerr << "Failed to create a GLFW window" << std::endl;
 			glfwTerminate();
@@ -75,7 +175,7 @@ namespace CE
 		}
 
 		glfwMakeContextCurrent(m_window);
-		glfwSwapInterval(1);
+		glfwSwapInterval(m_config.bVSync ? 1 : 0);
 
 		if (!gladLoadGL()) {
 			std::cerr << "Failed to initialize GLAD" << std::endl;
@@ -88,6 +188,31 @@ namespace CE
 
 	void Engine::PostSystemInitialize()
 	{
+		m_frameCounter = new FrameCounter(m_config.hitchBudgetMs);
+		Profiling::Profiler::Get().SetThreadName("Main");
+
+		if (m_replay.IsOpen())
+		{
+			const std::uint64_t frames = m_replay.GetHeader().frameCount;
+			const std::uint32_t seed = m_replay.GetHeader().seed;
+			std::string path = m_config.replayPath.string();
+			LOG_INFO(ENGINE, "Replaying {} frames from {} with seed {}", frames, path, seed);
+		}
+		else if (m_recorder.IsOpen())
+		{
+			const std::uint32_t seed = Globals::g_rand.GetSeed();
+			std::string path = m_config.recordPath.string();
+			LOG_INFO(ENGINE, "Recording to {} with seed {}", path, seed);
+		}
+
+		if (IsHeadless())
+		{
+			const double tickRate = 1.0 / m_fixedDeltaTime;
+			const double frameRate = m_config.frameRate;
+			LOG_INFO(ENGINE, "Running headless, ticking at {:.1f}Hz, frame rate {:.1f}Hz (0 is uncapped)", tickRate, frameRate);
+			return;
+		}
+
 		// ImGui init needs to be after InputSetup for callback chaining
 		IMGUI_CHECKVERSION();
 		ImGui::CreateContext();
@@ -101,11 +226,18 @@ namespace CE
 		ImGui_ImplGlfw_InitForOpenGL(m_window, true);
 		ImGui_ImplOpenGL3_Init("#version 130");
 
-		m_frameCounter = new FrameCounter();
 		std::shared_ptr<DebugSystem> DS = GetSystem<DebugSystem>();
 		if (DS)
 		{
-			//DS->Subscribe(m_frameCounter);
+			DS->Subscribe(m_frameCounter);
+#if defined(CDEBUG) && defined(CE_PROFILING)
+			m_profilerWindow = new ProfilerWindow();
+			DS->Subscribe(m_profilerWindow);
+#endif
+#if defined(CDEBUG) && defined(CE_MEMORY_TRACKING)
+			m_memoryWindow = new MemoryWindow();
+			DS->Subscribe(m_memoryWindow);
+#endif
 		}
 	}
 
@@ -114,34 +246,235 @@ namespace CE
 		m_exit = true;
 	}
 
+	void Engine::Subscribe(ITickEventSubscriber* sub)
+	{
+		m_tickSubscribers.push_back(sub);
+	}
+
+	void Engine::Unsubscribe(ITickEventSubscriber* sub)
+	{
+		std::erase(m_tickSubscribers, sub);
+	}
+
 	void Engine::AddSystems()
 	{
-		m_systems[typeid(ResourceSystem)] = std::make_unique<ResourceSystem>(this);
-		m_systems[typeid(InputSystem)] = std::make_unique<InputSystem>(this);
-		m_systems[typeid(EventSystem)] = std::make_unique<EventSystem>(this);
-		m_systems[typeid(RenderSystem)] = std::make_unique<RenderSystem>(this);
-		m_systems[typeid(WorldSystem)] = std::make_unique<WorldSystem>(this);
-		m_systems[typeid(LogSystem)] = std::make_unique<LogSystem>(this);
-
-		m_systems[typeid(DebugSystem)] = std::make_unique<DebugSystem>(this);
+		AddSystem<ResourceSystem>(Memory::MemoryTag::RESOURCES);
+		AddSystem<InputSystem>(Memory::MemoryTag::INPUT);
+		AddSystem<EventSystem>(Memory::MemoryTag::EVENTS);
+		AddSystem<RenderSystem>(Memory::MemoryTag::RENDER);
+		AddSystem<WorldSystem>(Memory::MemoryTag::WORLD);
+		AddSystem<PhysicsSystem>(Memory::MemoryTag::PHYSICS);
+		AddSystem<LogSystem>(Memory::MemoryTag::LOG);
+		AddSystem<JobSystem>(Memory::MemoryTag::JOBS);
+		AddSystem<TaskSystem>(Memory::MemoryTag::ENGINE);
+
+		AddSystem<DebugSystem>(Memory::MemoryTag::DEBUG);
 	}
 
 	void Engine::SystemInitialize()
 	{
-		// Manual Order
-		GetSystem<LogSystem>()->Startup();
-		
-		GetSystem<ResourceSystem>()->Startup();
+		struct StartupNode
+		{
+			EngineSystem* system = nullptr;
+			std::vector<StartupNode*> dependents;
+			std::atomic<int> waitingOn{ 0 };
+			bool bStarted = false;
+		};
+
+		m_startupBegin = std::chrono::steady_clock::now();
+		m_mainThread = std::this_thread::get_id();
+
+		// Every system stays registered so lookups never fail, render just never starts without a window
+		std::unordered_map<std::type_index, StartupNode> nodes;
+		for (auto& [type, system] : m_systems)
+		{
+			if (IsHeadless() && type == typeid(RenderSystem))
+			{
+				continue;
+			}
+			nodes[type].system = system.get();
+		}
 
-		GetSystem<RenderSystem>()->Startup();
+		for (auto& [type, node] : nodes)
+		{
+			for (const std::type_index& dependency : node.system->GetDependencies())
+			{
+				auto it = nodes.find(dependency);
+				if (it != nodes.end())
+				{
+					it->second.dependents.push_back(&node);
+					node.waitingOn++;
+				}
+				else if (!m_systems.contains(dependency))
+				{
+					std::string name = node.system->Name();
+					std::string_view dependencyName = dependency.name();
+					LOG_ERROR(ENGINE, "{} depends on a system that was never added ({})", name, dependencyName);
+				}
+			}
+		}
 
-		GetSystem<EventSystem>()->Startup();
+		// Topological order up front, so cycles are caught before anything starts
+		std::vector<StartupNode*> order;
+		{
+			std::unordered_map<StartupNode*, int> remaining;
+			for (auto& [type, node] : nodes)
+			{
+				remaining[&node] = node.waitingOn.load();
+				if (node.waitingOn == 0)
+				{
+					order.push_back(&node);
+				}
+			}
+			for (std::size_t i = 0; i < order.size(); i++)
+			{
+				for (StartupNode* dependent : order[i]->dependents)
+				{
+					if (--remaining[dependent] == 0)
+					{
+						order.push_back(dependent);
+					}
+				}
+			}
+		}
 
-		GetSystem<InputSystem>()->Startup();
+		if (order.size() != nodes.size())
+		{
+			std::string cycle;
+			for (auto& [type, node] : nodes)
+			{
+				if (std::find(order.begin(), order.end(), &node) == order.end())
+				{
+					cycle += cycle.empty() ? node.system->Name() : ", " + node.system->Name();
+				}
+			}
+			LOG_ERROR(ENGINE, "System dependencies form a cycle between {}, starting in registration order", cycle);
+#ifdef CDEBUG
+			assert(false);
+#endif
+			std::vector<EngineSystem*> fallback;
+			for (const std::type_index& type : m_registrationOrder)
+			{
+				auto it = nodes.find(type);
+				if (it != nodes.end())
+				{
+					fallback.push_back(it->second.system);
+				}
+			}
+			StartSystemsInOrder(fallback);
+			ReportStartupTimings();
+			return;
+		}
 
-		GetSystem<WorldSystem>()->Startup();
+		// Nothing can run on a worker until the job system is up, so it and everything it needs start
+		// inline on the main thread, which also makes the main thread the scheduler's thread zero
+		std::vector<StartupNode*> inlineNodes;
+		auto jobNode = nodes.find(typeid(JobSystem));
+		if (jobNode == nodes.end())
+		{
+			inlineNodes = order;
+		}
+		else
+		{
+			std::vector<StartupNode*> stack{ &jobNode->second };
+			std::unordered_set<StartupNode*> required;
+			while (!stack.empty())
+			{
+				StartupNode* node = stack.back();
+				stack.pop_back();
+				if (required.insert(node).second)
+				{
+					for (const std::type_index& dependency : node->system->GetDependencies())
+					{
+						auto it = nodes.find(dependency);
+						if (it != nodes.end())
+						{
+							stack.push_back(&it->second);
+						}
+					}
+				}
+			}
+			std::copy_if(order.begin(), order.end(), std::back_inserter(inlineNodes), [&required](StartupNode* node) { return required.contains(node); });
+		}
+
+		std::vector<EngineSystem*> inlineSystems;
+		for (StartupNode* node : inlineNodes)
+		{
+			inlineSystems.push_back(node->system);
+			node->bStarted = true;
+			for (StartupNode* dependent : node->dependents)
+			{
+				dependent->waitingOn--;
+			}
+		}
+		StartSystemsInOrder(inlineSystems);
+
+		if (inlineNodes.size() < order.size())
+		{
+			Jobs::JobScheduler& scheduler = GetSystem<JobSystem>()->GetScheduler();
+			Jobs::JobCounter counter;
+
+			// Each system schedules whichever dependents it was the last thing holding up
+			std::function<void(StartupNode*)> schedule = [&](StartupNode* node) {
+				auto job = [&, node]() {
+					StartupSystem(*node->system);
+					for (StartupNode* dependent : node->dependents)
+					{
+						if (dependent->waitingOn.fetch_sub(1, std::memory_order_acq_rel) == 1)
+						{
+							schedule(dependent);
+						}
+					}
+				};
+
+				if (node->system->RequiresMainThread())
+				{
+					scheduler.RunOnMainThread(job, &counter);
+				}
+				else
+				{
+					scheduler.Run(job, &counter);
+				}
+			};
+
+			// Gather the roots before scheduling any, once jobs run they schedule dependents themselves
+			std::vector<StartupNode*> roots;
+			std::copy_if(order.begin(), order.end(), std::back_inserter(roots), [](StartupNode* node) { return !node->bStarted && node->waitingOn == 0; });
+			for (StartupNode* node : roots)
+			{
+				schedule(node);
+			}
+
+			// Helps with worker jobs and picks up the main thread ones until everything is up
+			scheduler.Wait(counter);
+		}
+
+		ReportStartupTimings();
+	}
+
+	void Engine::StartSystemsInOrder(const std::vector<EngineSystem*>& order)
+	{
+		for (EngineSystem* system : order)
+		{
+			StartupSystem(*system);
+		}
+	}
+
+	void Engine::ReportStartupTimings()
+	{
+		using Milliseconds = std::chrono::duration<double, std::milli>;
+		const double totalMs = Milliseconds(std::chrono::steady_clock::now() - m_startupBegin).count();
 
-		GetSystem<DebugSystem>()->Startup();
+		double workMs = 0.0;
+		for (const SystemStartupTiming& timing : m_startupTimings)
+		{
+			const char* thread = timing.bMainThread ? "main" : "worker";
+			LOG_INFO(ENGINE, "Started {} at {:.2f}ms in {:.2f}ms on {} thread", timing.name, timing.beginMs, timing.durationMs, thread);
+			workMs += timing.durationMs;
+		}
+
+		const std::size_t count = m_startupTimings.size();
+		LOG_INFO(ENGINE, "Started {} systems in {:.2f}ms, {:.2f}ms of startup work", count, totalMs, workMs);
 	}
 
 #ifdef CDEBUG
@@ -197,38 +530,171 @@ namespace CE
 
 	void Engine::CoreLoop()
 	{
+		m_previousTime = std::chrono::steady_clock::now();
+
+		std::shared_ptr<EventSystem> ES = GetSystem<EventSystem>();
+
 		while (m_exit == false)
 		{
+			if (m_replay.IsOpen() && !m_replay.ReadFrame(m_replayFrame))
+			{
+				const std::uint64_t frames = m_replay.GetFrameIndex();
+				const char* result = m_bReplayDiverged ? "diverged from the recording" : "matched the recording";
+				LOG_INFO(ENGINE, "Replay finished after {} frames, {}", frames, result);
+				Stop();
+				break;
+			}
+
 			m_frameCounter->FrameStart();
+			Profiling::Profiler::Get().BeginFrame();
 
-			Update();
-			Render();
-			ProcessInput();
+			const std::uint64_t postedBefore = ES->GetPostedCount();
 
-			
+			// Low latency frames wait first and poll input straight after, so the rest of the frame
+			// works from input sampled as close to the deadline as the pacer can manage. Replays
+			// process input wherever the recorded frame did.
+			const bool bInputFirst = m_replay.IsOpen() ? m_replayFrame.bInputFirst : m_pacer.IsLowLatency() && m_pacer.IsLimiting();
+			if (bInputFirst)
+			{
+				m_pacer.Wait();
+				m_frameCounter->MarkPhase(FrameCounter::Phase::WAIT);
+				ProcessInput();
+				m_frameCounter->MarkPhase(FrameCounter::Phase::INPUT);
+			}
+
+			auto now = std::chrono::steady_clock::now();
+			std::chrono::duration<double> frameTime = now - m_previousTime;
+			m_previousTime = now;
+
+			// Uncapped headless runs step exactly one tick per frame, so a run of N frames is N ticks
+			// no matter how fast the machine is
+			double simulateTime = frameTime.count();
+			if (m_replay.IsOpen())
+			{
+				simulateTime = m_replayFrame.deltaTime;
+			}
+			else if (IsHeadless() && !m_pacer.IsLimiting())
+			{
+				simulateTime = m_fixedDeltaTime;
+			}
+
+			Update(simulateTime);
+			m_frameCounter->MarkPhase(FrameCounter::Phase::UPDATE);
+			float alpha = Simulate(simulateTime);
+			m_frameCounter->MarkPhase(FrameCounter::Phase::SIMULATE);
+			Render(alpha);
+			m_frameCounter->MarkPhase(FrameCounter::Phase::RENDER);
+
+			if (!bInputFirst)
+			{
+				ProcessInput();
+				m_frameCounter->MarkPhase(FrameCounter::Phase::INPUT);
+				m_pacer.Wait();
+				m_frameCounter->MarkPhase(FrameCounter::Phase::WAIT);
+			}
+
+			const std::uint32_t posted = static_cast<std::uint32_t>(ES->GetPostedCount() - postedBefore);
+			RecordFrame(simulateTime, bInputFirst, posted);
+
+			Profiling::Profiler::Get().EndFrame();
+			Memory::MemoryTracker::Get().EndFrame();
+			m_frameCounter->FrameEnd();
+
+			m_frameIndex++;
+			if (m_config.maxFrames > 0 && m_frameIndex >= m_config.maxFrames)
+			{
+				Stop();
+			}
+		}
+	}
 
-			double excess = m_frameCounter->FrameEnd();
-			if (excess > 0)
+	void Engine::RecordFrame(double simulateTime, bool bInputFirst, std::uint32_t eventsPosted)
+	{
+		if (m_recorder.IsOpen())
+		{
+			m_replayFrame.deltaTime = simulateTime;
+			m_replayFrame.bInputFirst = bInputFirst;
+			m_replayFrame.eventsPosted = eventsPosted;
+			m_replayFrame.inputs = GetSystem<InputSystem>()->GetProcessedEvents();
+			if (!m_recorder.WriteFrame(m_replayFrame))
 			{
-				// This caused my frames to skyrocket? TODO investigate
-				//std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(excess)));
+				// Carrying on would record frames that can't replay, keep what is good so far
+				const std::uint64_t frames = m_recorder.GetFrameCount();
+				const std::size_t inputs = m_replayFrame.inputs.size();
+				std::string path = m_config.recordPath.string();
+				LOG_ERROR(ENGINE, "Failed to record a frame with {} inputs, stopped recording {} after {} frames", inputs, path, frames);
+				m_recorder.Close();
 			}
 		}
+		else if (m_replay.IsOpen() && !m_bReplayDiverged && eventsPosted != m_replayFrame.eventsPosted)
+		{
+			// Only the first one is worth reporting, everything after it follows from it
+			m_bReplayDiverged = true;
+			const std::uint64_t frame = m_replay.GetFrameIndex() - 1;
+			const std::uint32_t expected = m_replayFrame.eventsPosted;
+			LOG_WARN(ENGINE, "Replay diverged on frame {}, {} events posted where the recording had {}", frame, eventsPosted, expected);
+		}
 	}
 
-	void Engine::Update()
+	void Engine::Update(double deltaTime)
 	{
-		//std::cout << "Updating!" << std::endl;
+		PROFILE_SCOPE("Engine::Update");
 
-		// TODO Calculate delta time
+		for (ITickEventSubscriber* sub : m_tickSubscribers)
+		{
+			sub->OnTick();
+		}
 
+		// Finished loads and jobs hand their tasks back from the main thread queue, running it first
+		// means those tasks pick up this frame rather than next
+		GetSystem<ResourceSystem>()->ProcessRequests();
+		GetSystem<JobSystem>()->ProcessMainThreadJobs();
+		GetSystem<TaskSystem>()->Update(deltaTime);
 		GetSystem<InputSystem>()->UpdateActions();
-		GetSystem<EventSystem>()->ProcessEvents();
+		GetSystem<EventSystem>()->ProcessEvents(deltaTime);
+	}
+
+	float Engine::Simulate(double frameTime)
+	{
+		PROFILE_SCOPE("Engine::Simulate");
+
+		if (m_bFixedStep == false)
+		{
+			FixedUpdate(frameTime);
+			return 1.f;
+		}
+
+		// Clamp long frames (breakpoints, loading hitches) so we don't spiral trying to catch up
+		static constexpr double s_maxFrameTime = 0.25;
+		m_accumulator += std::min(frameTime, s_maxFrameTime);
+
+		while (m_accumulator >= m_fixedDeltaTime)
+		{
+			FixedUpdate(m_fixedDeltaTime);
+			m_accumulator -= m_fixedDeltaTime;
+		}
+
+		return static_cast<float>(m_accumulator / m_fixedDeltaTime);
+	}
+
+	void Engine::FixedUpdate(double deltaTime)
+	{
+		PROFILE_SCOPE("Engine::FixedUpdate");
+
+		// Physics first so the world publishes this step's positions
+		GetSystem<PhysicsSystem>()->FixedUpdate(static_cast<float>(deltaTime));
+		GetSystem<WorldSystem>()->FixedUpdate();
 	}
 	
-	void Engine::Render()
+	void Engine::Render(float alpha)
 	{
-		GetSystem<RenderSystem>()->Render();
+		if (IsHeadless())
+		{
+			return;
+		}
+
+		PROFILE_SCOPE("Engine::Render");
+		GetSystem<RenderSystem>()->Render(alpha);
 
 		/*
 		// BEGIN FRAME
@@ -253,23 +719,59 @@ namespace CE
 
 	void Engine::ProcessInput()
 	{
+		PROFILE_SCOPE("Engine::ProcessInput");
+
 		// caching IS pointer?
 		GetSystem<InputSystem>()->PollInput();
+
+		// Headless replays have no window, the recording stands in for it
+		if (m_replay.IsOpen())
+		{
+			for (const InputEvent& input : m_replayFrame.inputs)
+			{
+				GetSystem<InputSystem>()->InjectEvent(input);
+			}
+		}
+
 		GetSystem<InputSystem>()->ProcessActions();
 	}
 
-	void Engine::ShutdownSystems()
+	void Engine::StartupSystem(EngineSystem& system)
 	{
-		// Manual order once again
-		GetSystem<DebugSystem>()->Shutdown();
+		const auto begin = std::chrono::steady_clock::now();
+		{
+			MEMORY_SCOPE(system.GetMemoryTag());
+			system.Startup();
+		}
+		const auto end = std::chrono::steady_clock::now();
 
-		GetSystem<WorldSystem>()->Shutdown();
-		
-		GetSystem<EventSystem>()->Shutdown();
-		GetSystem<InputSystem>()->Shutdown();
-		GetSystem<RenderSystem>()->Shutdown();
-		GetSystem<ResourceSystem>()->Shutdown();
+		using Milliseconds = std::chrono::duration<double, std::milli>;
+
+		SystemStartupTiming timing;
+		timing.name = system.Name();
+		timing.beginMs = Milliseconds(begin - m_startupBegin).count();
+		timing.durationMs = Milliseconds(end - begin).count();
+
+		timing.bMainThread = std::this_thread::get_id() == m_mainThread;
+
+		std::lock_guard<std::mutex> lock(m_startupMutex);
+		m_startedSystems.push_back(&system);
+		m_startupTimings.push_back(std::move(timing));
+	}
+
+	void Engine::ShutdownSystem(EngineSystem& system)
+	{
+		MEMORY_SCOPE(system.GetMemoryTag());
+		system.Shutdown();
+	}
 
-		GetSystem<LogSystem>()->Shutdown();
+	void Engine::ShutdownSystems()
+	{
+		// Reverse of the order they finished starting, so nothing shuts down under a dependent
+		for (auto it = m_startedSystems.rbegin(); it != m_startedSystems.rend(); ++it)
+		{
+			ShutdownSystem(**it);
+		}
+		m_startedSystems.clear();
 	}
 }
\ No newline at end of file
@@ -0,0 +1,159 @@
+#include "EngineConfig.h"
+
+#include <charconv>
+#include <cmath>
+#include <string_view>
+
+namespace CE
+{
+	namespace
+	{
+		template <typename T>
+		bool ParseValue(int argc, char** argv, int& index, T& out)
+		{
+			if (index + 1 >= argc)
+			{
+				std::cerr << "Missing value for " << argv[index] << std::endl;
+				return false;
+			}
+
+			const std::string_view value = argv[++index];
+			auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), out);
+			if (ec != std::errc() || ptr != value.data() + value.size())
+			{
+				std::cerr << "Bad value for " << argv[index - 1] << ": " << value << std::endl;
+				return false;
+			}
+			return true;
+		}
+	}
+
+	namespace
+	{
+		bool ParseBudget(int argc, char** argv, int& index, EngineConfig& config)
+		{
+			if (index + 1 >= argc)
+			{
+				std::cerr << "Missing value for " << argv[index] << std::endl;
+				return false;
+			}
+
+			const std::string_view value = argv[++index];
+			const std::size_t split = value.find('=');
+			const Memory::MemoryTag tag = Memory::FindMemoryTag(value.substr(0, split));
+			if (split == std::string_view::npos || tag == Memory::MemoryTag::COUNT)
+			{
+				std::cerr << "Bad memory budget " << value << ", expected Tag=MB" << std::endl;
+				return false;
+			}
+
+			double megabytes = 0.0;
+			const std::string_view amount = value.substr(split + 1);
+			auto [ptr, ec] = std::from_chars(amount.data(), amount.data() + amount.size(), megabytes);
+			if (ec != std::errc() || megabytes < 0.0)
+			{
+				std::cerr << "Bad memory budget " << value << ", expected Tag=MB" << std::endl;
+				return false;
+			}
+
+			config.memoryBudgets[static_cast<std::size_t>(tag)] = static_cast<std::size_t>(megabytes * 1024.0 * 1024.0);
+			return true;
+		}
+	}
+
+	std::optional<EngineConfig> EngineConfig::FromCommandLine(int argc, char** argv)
+	{
+		EngineConfig config;
+
+		// Every problem is reported before giving up, so one run shows them all
+		bool bValid = true;
+		for (int i = 1; i < argc; i++)
+		{
+			const std::string_view arg = argv[i];
+
+			if (arg == "--headless")
+			{
+				config.bHeadless = true;
+			}
+			else if (arg == "--frames")
+			{
+				bValid &= ParseValue(argc, argv, i, config.maxFrames);
+			}
+			else if (arg == "--rate")
+			{
+				bValid &= ParseValue(argc, argv, i, config.frameRate);
+			}
+			else if (arg == "--low-latency")
+			{
+				config.bLowLatency = true;
+			}
+			else if (arg == "--no-vsync")
+			{
+				config.bVSync = false;
+			}
+			else if (arg == "--tick")
+			{
+				bValid &= ParseValue(argc, argv, i, config.tickRate);
+			}
+			else if (arg == "--hitch")
+			{
+				bValid &= ParseValue(argc, argv, i, config.hitchBudgetMs);
+			}
+			else if (arg == "--budget")
+			{
+				bValid &= ParseBudget(argc, argv, i, config);
+			}
+			else if (arg == "--seed")
+			{
+				bValid &= ParseValue(argc, argv, i, config.seed);
+			}
+			else if (arg == "--stats" || arg == "--record" || arg == "--replay")
+			{
+				if (i + 1 < argc)
+				{
+					std::filesystem::path& path = arg == "--stats" ? config.statsPath : arg == "--record" ? config.recordPath : config.replayPath;
+					path = argv[++i];
+				}
+				else
+				{
+					std::cerr << "Missing value for " << arg << std::endl;
+					bValid = false;
+				}
+			}
+			else
+			{
+				std::cerr << "Unknown argument " << arg << std::endl;
+				bValid = false;
+			}
+		}
+
+		// Replays are for measuring, there is nothing to look at and no reason to wait
+		if (!config.replayPath.empty())
+		{
+			config.bHeadless = true;
+			if (!config.recordPath.empty())
+			{
+				std::cerr << "Can't record while replaying, ignoring --record" << std::endl;
+				config.recordPath.clear();
+			}
+		}
+
+		if (!std::isfinite(config.tickRate) || config.tickRate <= 0.0)
+		{
+			std::cerr << "Tick rate must be positive and finite" << std::endl;
+			bValid = false;
+		}
+
+		if (!std::isfinite(config.frameRate) || config.frameRate < 0.0 || !std::isfinite(config.hitchBudgetMs) || config.hitchBudgetMs < 0.0)
+		{
+			std::cerr << "Frame rate and hitch budget can't be negative or infinite" << std::endl;
+			bValid = false;
+		}
+
+		if (!bValid)
+		{
+			return std::nullopt;
+		}
+		return config;
+	}
+}
@@ -0,0 +1,144 @@
+#include "FramePacer.h"
+
+#include "Profiling/Profiler.h"
+
+#include <thread>
+
+#if defined(_WIN32) || defined(_WIN64)
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+	#include <timeapi.h>
+#endif
+
+namespace CE
+{
+	namespace
+	{
+		using Milliseconds = std::chrono::duration<double, std::milli>;
+
+		// Short enough that one overshooting sleep can't carry us far past the deadline
+		constexpr std::chrono::milliseconds SleepStep(1);
+
+		// How fast the sleep estimate follows changes in the scheduler
+		constexpr double SleepSmoothing = 0.1;
+
+		// Slack added on top of the work estimate in low latency mode
+		constexpr double LatencyMarginMs = 0.5;
+
+		// Per frame decay of the sleep cost peak
+		constexpr double SleepPeakDecay = 0.99;
+	}
+
+	FramePacer::FramePacer()
+	{
+#if defined(_WIN32) || defined(_WIN64)
+		timeBeginPeriod(1);
+#endif
+	}
+
+	FramePacer::~FramePacer()
+	{
+#if defined(_WIN32) || defined(_WIN64)
+		timeEndPeriod(1);
+#endif
+	}
+
+	void FramePacer::SetTargetRate(double hz)
+	{
+		m_targetRate = std::max(hz, 0.0);
+		m_period = m_targetRate > 0.0
+			? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_targetRate))
+			: Clock::duration::zero();
+
+		// Start the schedule over from the next frame
+		m_deadline = Clock::time_point{};
+	}
+
+	void FramePacer::Wait()
+	{
+		PROFILE_FUNCTION();
+
+		const Clock::time_point now = Clock::now();
+
+		// Track how long frames take between waits, rising immediately and falling off slowly so one
+		// quick frame doesn't make the next start too late
+		if (m_workStart != Clock::time_point{})
+		{
+			const double workMs = Milliseconds(now - m_workStart).count();
+			m_workEstimateMs = workMs > m_workEstimateMs ? workMs : m_workEstimateMs * 0.95 + workMs * 0.05;
+			m_stats.workEstimateMs = m_workEstimateMs;
+		}
+
+		if (!IsLimiting())
+		{
+			m_stats.lastWaitMs = 0.0;
+			m_stats.lastSpinMs = 0.0;
+			m_workStart = Clock::now();
+			return;
+		}
+
+		if (m_deadline == Clock::time_point{})
+		{
+			m_deadline = now;
+		}
+		else
+		{
+			m_deadline += m_period;
+		}
+
+		// Fell more than a whole frame behind, pick the schedule back up from here rather than
+		// rushing out a burst of frames to catch up
+		if (now > m_deadline + m_period)
+		{
+			m_stats.missedFrames++;
+			m_deadline = now;
+		}
+
+		Clock::time_point target = m_deadline;
+		if (m_bLowLatency)
+		{
+			// The frame should end on the deadline, so it starts its expected duration ahead of it
+			const Milliseconds lead(m_workEstimateMs + LatencyMarginMs);
+			target = m_deadline + m_period - std::chrono::duration_cast<Clock::duration>(lead);
+		}
+
+		SleepUntil(target);
+
+		m_workStart = Clock::now();
+		m_stats.lastWaitMs = Milliseconds(m_workStart - now).count();
+	}
+
+	void FramePacer::SleepUntil(Clock::time_point target)
+	{
+		while (true)
+		{
+			const Clock::time_point now = Clock::now();
+			const double remainingMs = Milliseconds(target - now).count();
+			// Spin rather than sleep once a sleep could plausibly carry us past the target
+			const double sleepCostMs = std::max(m_sleepMeanMs + 2.0 * std::sqrt(m_sleepVarianceMs), m_sleepPeakMs);
+			if (remainingMs <= sleepCostMs)
+			{
+				break;
+			}
+
+			std::this_thread::sleep_for(SleepStep);
+
+			// Exponentially weighted mean and variance of what a sleep actually costs
+			const double observedMs = Milliseconds(Clock::now() - now).count();
+			const double delta = observedMs - m_sleepMeanMs;
+			m_sleepMeanMs += SleepSmoothing * delta;
+			m_sleepVarianceMs = (1.0 - SleepSmoothing) * (m_sleepVarianceMs + SleepSmoothing * delta * delta);
+			m_sleepPeakMs = std::max(m_sleepPeakMs, observedMs);
+		}
+		m_sleepPeakMs = std::max(m_sleepPeakMs * SleepPeakDecay, m_sleepMeanMs);
+		m_stats.sleepCostMs = std::max(m_sleepMeanMs + 2.0 * std::sqrt(m_sleepVarianceMs), m_sleepPeakMs);
+
+		const Clock::time_point spinStart = Clock::now();
+		while (Clock::now() < target)
+		{
+			std::this_thread::yield();
+		}
+		m_stats.lastSpinMs = Milliseconds(Clock::now() - spinStart).count();
+	}
+}
@@ -7,6 +7,11 @@
 namespace CE
 {
 
+	SystemDependencies DebugSystem::GetDependencies() const
+	{
+		return { typeid(RenderSystem) };
+	}
+
 	void DebugSystem::Startup()
 	{
 		// Subscribe to frame updates
@@ -29,11 +34,14 @@ namespace CE
 		dv.subscriber = sub;
 		dv.showDebug = true;
 
+		std::lock_guard<std::mutex> lock(m_subscribeMutex);
 		m_debugSubscribers.push_back(dv);
 	}
 
 	void DebugSystem::OnDoFrame()
 	{
+		MEMORY_SCOPE(Memory::MemoryTag::DEBUG);
+
 		DrawMainMenu();
 		NotifyOnDrawGUI();
 	}
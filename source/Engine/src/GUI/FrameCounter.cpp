@@ -0,0 +1,384 @@
+#include "GUI/FrameCounter.h"
+
+#include "Systems/LogSystem.h"
+#include "imgui.h"
+
+#include <iomanip>
+
+namespace
+{
+	using Milliseconds = std::chrono::duration<double, std::milli>;
+
+	constexpr std::size_t PhaseIndex(FrameCounter::Phase phase)
+	{
+		return static_cast<std::size_t>(phase);
+	}
+
+	// Nearest rank on an already sorted sample
+	double Percentile(const std::vector<double>& sorted, double fraction)
+	{
+		if (sorted.empty()) { return 0.0; }
+		const std::size_t rank = static_cast<std::size_t>(std::ceil(fraction * sorted.size()));
+		return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+	}
+
+	// Upper edge of the bucket holding the given rank, good to a bucket width
+	double BucketPercentile(const std::array<std::uint64_t, FrameCounter::s_bucketCount + 1>& buckets, std::uint64_t total, double fraction, double max)
+	{
+		if (total == 0) { return 0.0; }
+		const std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(fraction * total)));
+
+		std::uint64_t seen = 0;
+		for (std::size_t i = 0; i < buckets.size(); i++)
+		{
+			seen += buckets[i];
+			if (seen >= rank)
+			{
+				return std::min((i + 1) * FrameCounter::s_bucketMs, max);
+			}
+		}
+		return max;
+	}
+}
+
+FrameCounter::FrameCounter(double hitchBudgetMs) :
+	m_fps(0),
+	m_frameCount(0),
+	m_totalTime(0),
+	m_deltaTime(0),
+	m_hitchBudgetMs(hitchBudgetMs),
+	m_frameStart(),
+	m_frameEnd(),
+	m_phaseStart()
+{
+	m_history.reserve(s_historySize);
+}
+
+void FrameCounter::FrameStart()
+{
+	m_frameStart = std::chrono::steady_clock::now();
+	m_phaseStart = m_frameStart;
+	m_current.fill(0.0);
+}
+
+void FrameCounter::MarkPhase(Phase phase)
+{
+	const TimePoint now = std::chrono::steady_clock::now();
+	m_current[PhaseIndex(phase)] += Milliseconds(now - m_phaseStart).count();
+	m_phaseStart = now;
+}
+
+void FrameCounter::FrameEnd()
+{
+	m_frameEnd = std::chrono::steady_clock::now();
+
+	Milliseconds frameDuration = m_frameEnd - m_frameStart;
+
+	m_deltaTime = frameDuration.count();
+	m_fps = static_cast<int>(1000.0 / std::max(m_deltaTime, 0.001));
+	m_totalTime += m_deltaTime;
+	m_current[PhaseIndex(Phase::TOTAL)] = m_deltaTime;
+
+	if (m_history.size() < s_historySize)
+	{
+		m_history.push_back(m_current);
+	}
+	else
+	{
+		m_history[m_historyHead] = m_current;
+	}
+	m_historyHead = (m_historyHead + 1) % s_historySize;
+
+	for (std::size_t phase = 0; phase < s_phaseCount; phase++)
+	{
+		const double ms = m_current[phase];
+		const std::size_t bucket = std::min(static_cast<std::size_t>(ms / s_bucketMs), s_bucketCount);
+		m_buckets[phase][bucket]++;
+		m_sessionSum[phase] += ms;
+		m_sessionMax[phase] = std::max(m_sessionMax[phase], ms);
+	}
+
+	// Time asleep in the pacer isn't work, a low frame rate cap would otherwise make every frame a hitch
+	if (m_hitchBudgetMs > 0.0 && GetWorkMs() > m_hitchBudgetMs)
+	{
+		RecordHitch();
+	}
+
+	m_frameCount++;
+}
+
+void FrameCounter::RecordHitch()
+{
+	if (m_hitches.size() >= s_maxHitches)
+	{
+		m_hitches.erase(m_hitches.begin());
+	}
+
+	Hitch& hitch = m_hitches.emplace_back();
+	hitch.frame = m_frameCount;
+	hitch.phaseMs = m_current;
+
+#ifdef CE_PROFILING
+	// The profiler closes its frame just before us, so its newest frame is this one
+	const CE::Profiling::Profiler& profiler = CE::Profiling::Profiler::Get();
+	if (profiler.GetFrameCount() > 0 && !profiler.IsPaused())
+	{
+		hitch.profile = profiler.GetFrame(profiler.GetFrameCount() - 1);
+	}
+#endif
+
+	const std::uint64_t frame = hitch.frame;
+	const double ms = GetWorkMs();
+	const double budget = m_hitchBudgetMs;
+	LOG_WARN(ENGINE, "Hitch on frame {}: {:.2f}ms of work over a {:.2f}ms budget", frame, ms, budget);
+}
+
+FrameCounter::Percentiles FrameCounter::GetRecentStats(Phase phase) const
+{
+	Percentiles stats;
+	if (m_history.empty()) { return stats; }
+
+	std::vector<double> sorted;
+	sorted.reserve(m_history.size());
+	for (const std::array<double, s_phaseCount>& frame : m_history)
+	{
+		sorted.push_back(frame[PhaseIndex(phase)]);
+	}
+	std::sort(sorted.begin(), sorted.end());
+
+	for (double ms : sorted)
+	{
+		stats.mean += ms;
+	}
+	stats.mean /= sorted.size();
+	stats.p50 = Percentile(sorted, 0.50);
+	stats.p95 = Percentile(sorted, 0.95);
+	stats.p99 = Percentile(sorted, 0.99);
+	stats.max = sorted.back();
+	return stats;
+}
+
+FrameCounter::Percentiles FrameCounter::GetSessionStats(Phase phase) const
+{
+	const std::size_t index = PhaseIndex(phase);
+
+	Percentiles stats;
+	if (m_frameCount == 0) { return stats; }
+
+	stats.mean = m_sessionSum[index] / m_frameCount;
+	stats.max = m_sessionMax[index];
+	stats.p50 = BucketPercentile(m_buckets[index], m_frameCount, 0.50, stats.max);
+	stats.p95 = BucketPercentile(m_buckets[index], m_frameCount, 0.95, stats.max);
+	stats.p99 = BucketPercentile(m_buckets[index], m_frameCount, 0.99, stats.max);
+	return stats;
+}
+
+std::string_view FrameCounter::GetPhaseName(Phase phase)
+{
+	switch (phase)
+	{
+	case Phase::TOTAL: return "Total";
+	case Phase::UPDATE: return "Update";
+	case Phase::SIMULATE: return "Simulate";
+	case Phase::RENDER: return "Render";
+	case Phase::INPUT: return "Input";
+	case Phase::WAIT: return "Wait";
+	default: return "Unknown";
+	}
+}
+
+bool FrameCounter::WriteStats(const std::filesystem::path& path) const
+{
+	std::ofstream file(path, std::ios::trunc);
+	if (!file)
+	{
+		std::string pathStr = path.string();
+		LOG_ERROR(ENGINE, "Failed to open frame stats file {}", pathStr);
+		return false;
+	}
+
+	file << std::fixed << std::setprecision(3);
+	file << "{\n";
+	file << "\t\"frames\": " << m_frameCount << ",\n";
+	file << "\t\"totalMs\": " << m_totalTime << ",\n";
+	file << "\t\"hitchBudgetMs\": " << m_hitchBudgetMs << ",\n";
+	file << "\t\"bucketMs\": " << s_bucketMs << ",\n";
+	file << "\t\"phases\": {\n";
+	for (std::size_t index = 0; index < s_phaseCount; index++)
+	{
+		const Phase phase = static_cast<Phase>(index);
+		const Percentiles stats = GetSessionStats(phase);
+
+		file << "\t\t\"" << GetPhaseName(phase) << "\": { "
+			<< "\"mean\": " << stats.mean << ", \"p50\": " << stats.p50 << ", \"p95\": " << stats.p95
+			<< ", \"p99\": " << stats.p99 << ", \"max\": " << stats.max << ", \"histogram\": [";
+
+		// Trim the empty tail, the bucket index gives the range back
+		std::size_t last = m_buckets[index].size();
+		while (last > 0 && m_buckets[index][last - 1] == 0) { last--; }
+		for (std::size_t bucket = 0; bucket < last; bucket++)
+		{
+			file << (bucket > 0 ? ", " : "") << m_buckets[index][bucket];
+		}
+		file << "] }" << (index + 1 < s_phaseCount ? "," : "") << "\n";
+	}
+	file << "\t},\n";
+	file << "\t\"hitches\": [";
+	for (std::size_t i = 0; i < m_hitches.size(); i++)
+	{
+		const Hitch& hitch = m_hitches[i];
+		file << (i > 0 ? "," : "") << "\n\t\t{ \"frame\": " << hitch.frame;
+		for (std::size_t index = 0; index < s_phaseCount; index++)
+		{
+			file << ", \"" << GetPhaseName(static_cast<Phase>(index)) << "\": " << hitch.phaseMs[index];
+		}
+		file << " }";
+	}
+	file << "\n\t]\n}\n";
+
+	if (!file)
+	{
+		std::string pathStr = path.string();
+		LOG_ERROR(ENGINE, "Failed writing frame stats file {}", pathStr);
+		return false;
+	}
+
+#ifdef CE_PROFILING
+	std::vector<const CE::Profiling::FrameRecord*> profiles;
+	for (const Hitch& hitch : m_hitches)
+	{
+		if (!hitch.profile.events.empty())
+		{
+			profiles.push_back(&hitch.profile);
+		}
+	}
+
+	if (!profiles.empty())
+	{
+		std::filesystem::path tracePath = path;
+		tracePath.replace_filename(path.stem().string() + "_hitches.json");
+		if (!CE::Profiling::Profiler::Get().ExportChromeTrace(tracePath, profiles))
+		{
+			std::string pathStr = tracePath.string();
+			LOG_ERROR(ENGINE, "Failed writing hitch trace {}", pathStr);
+		}
+	}
+#endif
+
+	std::string pathStr = path.string();
+	LOG_INFO(ENGINE, "Wrote frame stats for {} frames to {}", m_frameCount, pathStr);
+	return true;
+}
+
+void FrameCounter::OnDrawGUI()
+{
+	ImGui::Begin("Frame Stats");
+
+	ImGui::Text("FPS: %d", m_fps);
+	ImGui::Text("DeltaTime: %.2fms", m_deltaTime);
+
+	if (!m_history.empty())
+	{
+		// Unroll the ring so the graph scrolls left to right
+		std::array<std::vector<float>, s_phaseCount> series;
+		for (std::size_t index = 0; index < s_phaseCount; index++)
+		{
+			series[index].reserve(m_history.size());
+		}
+		const std::size_t oldest = m_history.size() < s_historySize ? 0 : m_historyHead;
+		for (std::size_t i = 0; i < m_history.size(); i++)
+		{
+			const std::array<double, s_phaseCount>& frame = m_history[(oldest + i) % m_history.size()];
+			for (std::size_t index = 0; index < s_phaseCount; index++)
+			{
+				series[index].push_back(static_cast<float>(frame[index]));
+			}
+		}
+
+		const Percentiles total = GetRecentStats(Phase::TOTAL);
+		const float scale = static_cast<float>(std::max({ total.max, m_hitchBudgetMs, targetFrameDuration }));
+		ImGui::PlotLines("Frame", series[0].data(), static_cast<int>(series[0].size()), 0, nullptr, 0.f, scale, ImVec2(-1.f, 80.f));
+
+		if (ImGui::CollapsingHeader("Phases"))
+		{
+			for (std::size_t index = 1; index < s_phaseCount; index++)
+			{
+				const std::string label(GetPhaseName(static_cast<Phase>(index)));
+				ImGui::PlotLines(label.c_str(), series[index].data(), static_cast<int>(series[index].size()), 0, nullptr, 0.f, scale, ImVec2(-1.f, 40.f));
+			}
+		}
+	}
+
+	if (ImGui::CollapsingHeader("Percentiles", ImGuiTreeNodeFlags_DefaultOpen))
+	{
+		ImGui::Checkbox("Whole Session", &m_bShowSession);
+		DrawPhaseTable(m_bShowSession);
+	}
+
+	if (ImGui::CollapsingHeader("Histogram"))
+	{
+		// Session frame times, clipped to where frames actually landed
+		const std::array<std::uint64_t, s_bucketCount + 1>& buckets = m_buckets[PhaseIndex(Phase::TOTAL)];
+		std::size_t last = buckets.size();
+		while (last > 1 && buckets[last - 1] == 0) { last--; }
+
+		std::vector<float> counts(buckets.begin(), buckets.begin() + last);
+		ImGui::PlotHistogram("##Histogram", counts.data(), static_cast<int>(counts.size()), 0, nullptr, 0.f, FLT_MAX, ImVec2(-1.f, 80.f));
+		ImGui::Text("0 - %.2fms in %.2fms buckets", last * s_bucketMs, s_bucketMs);
+	}
+
+	if (ImGui::CollapsingHeader("Hitches"))
+	{
+		float budget = static_cast<float>(m_hitchBudgetMs);
+		if (ImGui::SliderFloat("Budget (ms)", &budget, 1.f, 250.f))
+		{
+			m_hitchBudgetMs = budget;
+		}
+
+		for (auto it = m_hitches.rbegin(); it != m_hitches.rend(); ++it)
+		{
+			ImGui::Text("Frame %llu: %.2fms", static_cast<unsigned long long>(it->frame), it->phaseMs[PhaseIndex(Phase::TOTAL)]);
+			for (std::size_t index = 1; index < s_phaseCount; index++)
+			{
+				const std::string_view name = GetPhaseName(static_cast<Phase>(index));
+				ImGui::SameLine();
+				ImGui::Text("%.*s %.2f", static_cast<int>(name.size()), name.data(), it->phaseMs[index]);
+			}
+		}
+	}
+
+	ImGui::End();
+}
+
+void FrameCounter::DrawPhaseTable(bool bSession) const
+{
+	if (!ImGui::BeginTable("PhaseStats", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+	{
+		return;
+	}
+
+	ImGui::TableSetupColumn("Phase");
+	ImGui::TableSetupColumn("Mean");
+	ImGui::TableSetupColumn("p50");
+	ImGui::TableSetupColumn("p95");
+	ImGui::TableSetupColumn("p99");
+	ImGui::TableSetupColumn("Max");
+	ImGui::TableHeadersRow();
+
+	for (std::size_t index = 0; index < s_phaseCount; index++)
+	{
+		const Phase phase = static_cast<Phase>(index);
+		const Percentiles stats = bSession ? GetSessionStats(phase) : GetRecentStats(phase);
+		const std::string name(GetPhaseName(phase));
+
+		ImGui::TableNextRow();
+		ImGui::TableNextColumn(); ImGui::Text("%s", name.c_str());
+		ImGui::TableNextColumn(); ImGui::Text("%.2f", stats.mean);
+		ImGui::TableNextColumn(); ImGui::Text("%.2f", stats.p50);
+		ImGui::TableNextColumn(); ImGui::Text("%.2f", stats.p95);
+		ImGui::TableNextColumn(); ImGui::Text("%.2f", stats.p99);
+		ImGui::TableNextColumn(); ImGui::Text("%.2f", stats.max);
+	}
+
+	ImGui::EndTable();
+}
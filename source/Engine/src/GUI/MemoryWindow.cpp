@@ -0,0 +1,85 @@
+#include "GUI/MemoryWindow.h"
+
+#if defined(CDEBUG) && defined(CE_MEMORY_TRACKING)
+
+#include "Memory/MemoryTracker.h"
+#include "imgui.h"
+
+namespace CE
+{
+	namespace
+	{
+		float ToMegabytes(std::int64_t bytes)
+		{
+			return static_cast<float>(static_cast<double>(bytes) / (1024.0 * 1024.0));
+		}
+	}
+
+	void MemoryWindow::OnDrawGUI()
+	{
+		Memory::MemoryTracker& tracker = Memory::MemoryTracker::Get();
+
+		ImGui::Begin("Memory");
+
+		std::int64_t totalBytes = 0;
+		std::int64_t totalAllocations = 0;
+		std::uint64_t totalFrameAllocations = 0;
+
+		const ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp;
+		if (ImGui::BeginTable("MemoryTags", 6, flags))
+		{
+			ImGui::TableSetupColumn("Tag");
+			ImGui::TableSetupColumn("Live (MB)");
+			ImGui::TableSetupColumn("Peak (MB)");
+			ImGui::TableSetupColumn("Blocks");
+			ImGui::TableSetupColumn("Allocs/Frame");
+			ImGui::TableSetupColumn("Budget (MB)");
+			ImGui::TableHeadersRow();
+
+			for (std::size_t i = 0; i < Memory::s_tagCount; i++)
+			{
+				const Memory::MemoryTag tag = static_cast<Memory::MemoryTag>(i);
+				const Memory::TagStats stats = tracker.GetStats(tag);
+				totalBytes += stats.liveBytes;
+				totalAllocations += stats.liveAllocations;
+				totalFrameAllocations += stats.frameAllocations;
+
+				const bool bOverBudget = stats.budget > 0 && stats.liveBytes > static_cast<std::int64_t>(stats.budget);
+
+				ImGui::PushID(static_cast<int>(i));
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				if (bOverBudget)
+				{
+					ImGui::TextColored(ImVec4(1.f, 0.3f, 0.3f, 1.f), "%s", Memory::GetMemoryTagName(tag));
+				}
+				else
+				{
+					ImGui::Text("%s", Memory::GetMemoryTagName(tag));
+				}
+				ImGui::TableNextColumn(); ImGui::Text("%.2f", ToMegabytes(stats.liveBytes));
+				ImGui::TableNextColumn(); ImGui::Text("%.2f", ToMegabytes(stats.peakBytes));
+				ImGui::TableNextColumn(); ImGui::Text("%lld", static_cast<long long>(stats.liveAllocations));
+				ImGui::TableNextColumn(); ImGui::Text("%llu", static_cast<unsigned long long>(stats.frameAllocations));
+
+				ImGui::TableNextColumn();
+				float budget = ToMegabytes(static_cast<std::int64_t>(stats.budget));
+				ImGui::SetNextItemWidth(-1.f);
+				if (ImGui::InputFloat("##Budget", &budget, 0.f, 0.f, "%.1f", ImGuiInputTextFlags_EnterReturnsTrue))
+				{
+					tracker.SetBudget(tag, static_cast<std::size_t>(std::max(budget, 0.f) * 1024.f * 1024.f));
+				}
+				ImGui::PopID();
+			}
+
+			ImGui::EndTable();
+		}
+
+		ImGui::Text("Total: %.2fMB in %lld blocks, %llu allocations last frame", ToMegabytes(totalBytes),
+			static_cast<long long>(totalAllocations), static_cast<unsigned long long>(totalFrameAllocations));
+
+		ImGui::End();
+	}
+}
+
+#endif
@@ -0,0 +1,163 @@
+#include "GUI/ProfilerWindow.h"
+
+#if defined(CDEBUG) && defined(CE_PROFILING)
+
+#include "Profiling/Profiler.h"
+#include "Systems/LogSystem.h"
+#include "imgui.h"
+
+namespace CE
+{
+	namespace
+	{
+		// Stable colour per scope name so the same scope reads the same across frames
+		ImU32 ScopeColor(const char* name)
+		{
+			const std::size_t hash = std::hash<std::string_view>()(name);
+			const int r = 90 + static_cast<int>(hash % 120);
+			const int g = 90 + static_cast<int>((hash >> 8) % 120);
+			const int b = 90 + static_cast<int>((hash >> 16) % 120);
+			return IM_COL32(r, g, b, 255);
+		}
+	}
+
+	void ProfilerWindow::OnDrawGUI()
+	{
+		Profiling::Profiler& profiler = Profiling::Profiler::Get();
+
+		ImGui::Begin("Profiler");
+
+		bool bEnabled = profiler.IsEnabled();
+		if (ImGui::Checkbox("Enabled", &bEnabled))
+		{
+			profiler.SetEnabled(bEnabled);
+		}
+		ImGui::SameLine();
+		bool bPaused = profiler.IsPaused();
+		if (ImGui::Checkbox("Paused", &bPaused))
+		{
+			profiler.SetPaused(bPaused);
+		}
+
+		ImGui::InputText("##ExportPath", m_exportPath, sizeof(m_exportPath));
+		ImGui::SameLine();
+		if (ImGui::Button("Export Chrome Trace"))
+		{
+			std::string path = m_exportPath;
+			if (profiler.ExportChromeTrace(path))
+			{
+				LOG_INFO(ENGINE, "Exported profiler trace to {}", path);
+			}
+			else
+			{
+				LOG_ERROR(ENGINE, "Failed to export profiler trace to {}", path);
+			}
+		}
+
+		const std::size_t frameCount = profiler.GetFrameCount();
+		if (frameCount == 0)
+		{
+			ImGui::Text("No frames recorded");
+			ImGui::End();
+			return;
+		}
+
+		// Frame history, the tallest bars are the spikes worth looking at
+		std::vector<float> durations(frameCount);
+		std::size_t worst = 0;
+		for (std::size_t i = 0; i < frameCount; i++)
+		{
+			durations[i] = static_cast<float>(profiler.GetFrame(i).GetDurationMs());
+			if (durations[i] > durations[worst])
+			{
+				worst = i;
+			}
+		}
+		ImGui::PlotHistogram("##FrameTimes", durations.data(), static_cast<int>(frameCount), 0, "Frame Times (ms)", 0.f, FLT_MAX, ImVec2(-1.f, 60.f));
+
+		m_frameOffset = std::clamp(m_frameOffset, 0, static_cast<int>(frameCount) - 1);
+		ImGui::SliderInt("Frames Back", &m_frameOffset, 0, static_cast<int>(frameCount) - 1);
+		ImGui::SameLine();
+		if (ImGui::Button("Worst"))
+		{
+			m_frameOffset = static_cast<int>(frameCount - 1 - worst);
+			profiler.SetPaused(true);
+		}
+		ImGui::SliderFloat("Zoom", &m_zoom, 1.f, 50.f, "%.1fx", ImGuiSliderFlags_Logarithmic);
+
+		const std::size_t frameIndex = frameCount - 1 - static_cast<std::size_t>(m_frameOffset);
+		const Profiling::FrameRecord& frame = profiler.GetFrame(frameIndex);
+		const std::uint64_t dropped = profiler.GetDroppedEvents();
+		ImGui::Text("Frame %llu: %.3fms, %zu scopes, %llu dropped", static_cast<unsigned long long>(frame.index), frame.GetDurationMs(),
+			frame.events.size(), static_cast<unsigned long long>(dropped));
+
+		DrawFlameGraph(frameIndex);
+
+		ImGui::End();
+	}
+
+	void ProfilerWindow::DrawFlameGraph(std::size_t frameIndex)
+	{
+		const Profiling::FrameRecord& frame = Profiling::Profiler::Get().GetFrame(frameIndex);
+		const std::vector<std::string> threadNames = Profiling::Profiler::Get().GetThreadNames();
+
+		// Group into per thread lanes, each as deep as its deepest scope
+		std::vector<std::uint32_t> laneDepth(threadNames.size(), 0);
+		for (const Profiling::ScopeEvent& event : frame.events)
+		{
+			if (event.thread < laneDepth.size())
+			{
+				laneDepth[event.thread] = std::max(laneDepth[event.thread], event.depth + 1);
+			}
+		}
+
+		static constexpr float s_rowHeight = 18.f;
+		static constexpr float s_laneLabelHeight = 18.f;
+
+		ImGui::BeginChild("FlameGraph", ImVec2(0.f, 0.f), true, ImGuiWindowFlags_HorizontalScrollbar);
+
+		const float width = std::max(ImGui::GetContentRegionAvail().x, 1.f) * m_zoom;
+		const double frameDuration = static_cast<double>(std::max<Profiling::Timestamp>(frame.end - frame.begin, 1));
+		ImDrawList* drawList = ImGui::GetWindowDrawList();
+
+		for (std::size_t thread = 0; thread < laneDepth.size(); thread++)
+		{
+			if (laneDepth[thread] == 0) { continue; }
+
+			ImGui::TextUnformatted(threadNames[thread].c_str());
+			const ImVec2 origin = ImGui::GetCursorScreenPos();
+			const float laneHeight = laneDepth[thread] * s_rowHeight;
+
+			for (const Profiling::ScopeEvent& event : frame.events)
+			{
+				if (event.thread != thread) { continue; }
+
+				// Worker scopes can straddle frame boundaries, clip them to this frame
+				const double begin = std::clamp(static_cast<double>(event.begin - frame.begin) / frameDuration, 0.0, 1.0);
+				const double end = std::clamp(static_cast<double>(event.end - frame.begin) / frameDuration, 0.0, 1.0);
+
+				const ImVec2 min(origin.x + static_cast<float>(begin) * width, origin.y + event.depth * s_rowHeight);
+				const ImVec2 max(std::max(origin.x + static_cast<float>(end) * width, min.x + 1.f), min.y + s_rowHeight - 1.f);
+
+				drawList->AddRectFilled(min, max, ScopeColor(event.name));
+				if (max.x - min.x > 20.f)
+				{
+					const ImVec4 clip(min.x, min.y, max.x, max.y);
+					drawList->AddText(nullptr, 0.f, ImVec2(min.x + 2.f, min.y + 2.f), IM_COL32(0, 0, 0, 255), event.name, nullptr, 0.f, &clip);
+				}
+
+				if (ImGui::IsMouseHoveringRect(min, max))
+				{
+					const double ms = static_cast<double>(event.end - event.begin) / 1000000.0;
+					ImGui::SetTooltip("%s\n%.3fms", event.name, ms);
+				}
+			}
+
+			ImGui::Dummy(ImVec2(width, laneHeight + s_laneLabelHeight * 0.5f));
+		}
+
+		ImGui::EndChild();
+	}
+}
+
+#endif
@@ -0,0 +1,410 @@
+#include "Jobs/JobScheduler.h"
+
+#include "Memory/MemoryTracker.h"
+#include "Profiling/Profiler.h"
+
+namespace CE::Jobs
+{
+	namespace
+	{
+		// Which scheduler owns the current thread and its slot in that scheduler, -1 for strangers
+		struct ThreadContext
+		{
+			const JobScheduler* scheduler = nullptr;
+			int index = -1;
+		};
+
+		thread_local ThreadContext t_context;
+
+		// Spins before a worker gives up and sleeps, long enough to catch bursts of small jobs
+		constexpr int SpinCount = 64;
+
+		std::uint32_t NextRandom(std::uint32_t& state)
+		{
+			// xorshift32, only used to spread out steal victims
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+			return state;
+		}
+	}
+
+	JobScheduler::JobScheduler(std::size_t workerCount)
+	{
+		if (workerCount == 0)
+		{
+			const std::size_t hardware = std::thread::hardware_concurrency();
+			workerCount = hardware > 1 ? hardware - 1 : 1;
+		}
+
+		m_mainThread = std::this_thread::get_id();
+
+		m_threads.reserve(workerCount + 1);
+		for (std::size_t i = 0; i < workerCount + 1; i++)
+		{
+			m_threads.push_back(std::make_unique<ThreadState>());
+			m_threads.back()->randomState = static_cast<std::uint32_t>(i * 2654435761u + 1);
+		}
+
+		t_context = { this, 0 };
+
+		m_workers.reserve(workerCount);
+		for (std::size_t i = 0; i < workerCount; i++)
+		{
+			const int threadIndex = static_cast<int>(i + 1);
+			m_workers.emplace_back([this, threadIndex]() { WorkerLoop(threadIndex); });
+		}
+	}
+
+	JobScheduler::~JobScheduler()
+	{
+		WaitIdle();
+
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+			m_bExit.store(true);
+		}
+		m_wakeCondition.notify_all();
+
+		for (std::thread& worker : m_workers)
+		{
+			worker.join();
+		}
+
+		if (t_context.scheduler == this)
+		{
+			t_context = {};
+		}
+	}
+
+	bool JobScheduler::IsMainThread() const
+	{
+		return std::this_thread::get_id() == m_mainThread;
+	}
+
+	int JobScheduler::GetThreadIndex() const
+	{
+		return t_context.scheduler == this ? t_context.index : -1;
+	}
+
+	SchedulerStats JobScheduler::GetStats() const
+	{
+		SchedulerStats stats;
+		for (const std::unique_ptr<ThreadState>& state : m_threads)
+		{
+			stats.executed += state->executed.load(std::memory_order_relaxed);
+			stats.stolen += state->stolen.load(std::memory_order_relaxed);
+			stats.heapAllocated += state->heapAllocated.load(std::memory_order_relaxed);
+		}
+		return stats;
+	}
+
+	Job* JobScheduler::AllocateJob(int threadIndex)
+	{
+		if (threadIndex >= 0)
+		{
+			ThreadState& state = *m_threads[threadIndex];
+			Job& slot = state.jobs[state.nextJob++ & (RingSize - 1)];
+			if (slot.bFinished.load(std::memory_order_acquire))
+			{
+				slot.bFinished.store(false, std::memory_order_relaxed);
+				slot.bHeap = false;
+				return &slot;
+			}
+			state.heapAllocated.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		Job* job = new Job();
+		job->bFinished.store(false, std::memory_order_relaxed);
+		job->bHeap = true;
+		return job;
+	}
+
+	void JobScheduler::Run(JobFunction function, JobCounter* counter, JobCounter* dependency)
+	{
+		const int threadIndex = GetThreadIndex();
+
+		Job* job = AllocateJob(threadIndex);
+		job->function = std::move(function);
+		job->counter = counter;
+
+		m_active.fetch_add(1, std::memory_order_relaxed);
+		if (counter)
+		{
+			counter->m_value.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		if (dependency)
+		{
+			std::unique_lock<std::mutex> lock(dependency->m_waitersMutex);
+			if (!dependency->IsDone())
+			{
+				// Submitted by whoever finishes the dependency's last job
+				dependency->m_waiters.push_back(job);
+				return;
+			}
+		}
+
+		Submit(job, threadIndex);
+	}
+
+	void JobScheduler::RunOnMainThread(JobFunction function, JobCounter* counter)
+	{
+		Job* job = AllocateJob(GetThreadIndex());
+		job->function = std::move(function);
+		job->counter = counter;
+
+		m_active.fetch_add(1, std::memory_order_relaxed);
+		if (counter)
+		{
+			counter->m_value.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+		m_mainThreadJobs.push_back(job);
+	}
+
+	void JobScheduler::ProcessMainThreadJobs()
+	{
+		assert(IsMainThread());
+
+		// Swapped into a local, main thread jobs can wait on counters which lands back in here
+		std::vector<Job*> jobs;
+		{
+			std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+			if (m_mainThreadJobs.empty()) { return; }
+			std::swap(jobs, m_mainThreadJobs);
+		}
+
+		// Jobs may queue more main thread work, that waits for the next call
+		for (Job* job : jobs)
+		{
+			Execute(job, GetThreadIndex());
+		}
+	}
+
+	void JobScheduler::Submit(Job* job, int threadIndex)
+	{
+		if (threadIndex < 0 || !m_threads[threadIndex]->queue.Push(job))
+		{
+			std::lock_guard<std::mutex> lock(m_injectionMutex);
+			m_injected.push_back(job);
+			m_injectedCount.fetch_add(1, std::memory_order_release);
+		}
+
+		m_pending.fetch_add(1, std::memory_order_seq_cst);
+		if (m_sleepers.load(std::memory_order_seq_cst) > 0)
+		{
+			// Taking the lock orders us after a worker's predicate check so the notify can't be lost
+			{ std::lock_guard<std::mutex> lock(m_sleepMutex); }
+			m_wakeCondition.notify_one();
+		}
+	}
+
+	Job* JobScheduler::FindJob(int threadIndex)
+	{
+		Job* job = nullptr;
+
+		if (threadIndex >= 0 && m_threads[threadIndex]->queue.Pop(job))
+		{
+			return job;
+		}
+
+		if (m_injectedCount.load(std::memory_order_acquire) > 0)
+		{
+			std::lock_guard<std::mutex> lock(m_injectionMutex);
+			if (!m_injected.empty())
+			{
+				job = m_injected.front();
+				m_injected.pop_front();
+				m_injectedCount.fetch_sub(1, std::memory_order_relaxed);
+				return job;
+			}
+		}
+
+		// Start stealing at a random victim so thieves don't all pile onto the same deque
+		const std::size_t threadCount = m_threads.size();
+		std::uint32_t& randomState = m_threads[threadIndex >= 0 ? threadIndex : 0]->randomState;
+		const std::size_t start = threadIndex >= 0 ? NextRandom(randomState) % threadCount : 0;
+		for (std::size_t i = 0; i < threadCount; i++)
+		{
+			const std::size_t victim = (start + i) % threadCount;
+			if (static_cast<int>(victim) == threadIndex) { continue; }
+
+			if (m_threads[victim]->queue.Steal(job))
+			{
+				if (threadIndex >= 0)
+				{
+					m_threads[threadIndex]->stolen.fetch_add(1, std::memory_order_relaxed);
+				}
+				return job;
+			}
+		}
+
+		return nullptr;
+	}
+
+	bool JobScheduler::TryRunJob(int threadIndex)
+	{
+		Job* job = FindJob(threadIndex);
+		if (job == nullptr) { return false; }
+
+		m_pending.fetch_sub(1, std::memory_order_relaxed);
+		Execute(job, threadIndex);
+		return true;
+	}
+
+	void JobScheduler::Execute(Job* job, int threadIndex)
+	{
+		job->function();
+
+		if (threadIndex >= 0)
+		{
+			m_threads[threadIndex]->executed.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		Finish(job, threadIndex);
+	}
+
+	void JobScheduler::Finish(Job* job, int threadIndex)
+	{
+		JobCounter* counter = job->counter;
+
+		// Drop captures now, ring slots can sit around for a long time before reuse
+		job->function = nullptr;
+		if (job->bHeap)
+		{
+			delete job;
+		}
+		else
+		{
+			job->bFinished.store(true, std::memory_order_release);
+		}
+
+		if (counter)
+		{
+			// Decrement under the lock so a job can't slip into the waiters after we've emptied them,
+			// Wait takes the same lock before returning so the counter outlives us
+			std::vector<Job*> waiters;
+			{
+				std::lock_guard<std::mutex> lock(counter->m_waitersMutex);
+				if (counter->m_value.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				{
+					std::swap(waiters, counter->m_waiters);
+				}
+			}
+
+			for (Job* waiter : waiters)
+			{
+				Submit(waiter, threadIndex);
+			}
+		}
+
+		m_active.fetch_sub(1, std::memory_order_acq_rel);
+	}
+
+	void JobScheduler::Wait(JobCounter& counter)
+	{
+		const int threadIndex = GetThreadIndex();
+		const bool bMainThread = IsMainThread();
+
+		while (!counter.IsDone())
+		{
+			if (bMainThread)
+			{
+				ProcessMainThreadJobs();
+			}
+
+			if (!TryRunJob(threadIndex))
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		// The last job may still be unlocking the counter, hold on until it lets go
+		std::lock_guard<std::mutex> lock(counter.m_waitersMutex);
+	}
+
+	void JobScheduler::WaitIdle()
+	{
+		const int threadIndex = GetThreadIndex();
+		const bool bMainThread = IsMainThread();
+
+		while (m_active.load(std::memory_order_acquire) > 0)
+		{
+			if (bMainThread)
+			{
+				ProcessMainThreadJobs();
+			}
+
+			if (!TryRunJob(threadIndex))
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	void JobScheduler::ParallelFor(std::size_t count, std::size_t batchSize, const std::function<void(std::size_t, std::size_t)>& function)
+	{
+		if (count == 0) { return; }
+
+		if (batchSize == 0)
+		{
+			// A few batches per thread so stealing can even out uneven batches
+			batchSize = std::max<std::size_t>(1, count / (m_threads.size() * 4));
+		}
+
+		if (count <= batchSize)
+		{
+			function(0, count);
+			return;
+		}
+
+		JobCounter counter;
+		std::size_t begin = 0;
+		for (; begin + batchSize < count; begin += batchSize)
+		{
+			const std::size_t end = begin + batchSize;
+			Run([&function, begin, end]() { function(begin, end); }, &counter);
+		}
+
+		// Last batch on the calling thread rather than sitting idle
+		function(begin, count);
+		Wait(counter);
+	}
+
+	void JobScheduler::WorkerLoop(int threadIndex)
+	{
+		t_context = { this, threadIndex };
+		Profiling::Profiler::Get().SetThreadName(std::format("Worker {}", threadIndex));
+
+		// Jobs that don't tag themselves count against the job system
+		MEMORY_SCOPE(Memory::MemoryTag::JOBS);
+
+		int spins = 0;
+		while (!m_bExit.load(std::memory_order_relaxed))
+		{
+			if (TryRunJob(threadIndex))
+			{
+				spins = 0;
+				continue;
+			}
+
+			if (++spins < SpinCount)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(m_sleepMutex);
+			m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+			m_wakeCondition.wait(lock, [this]() {
+				return m_pending.load(std::memory_order_seq_cst) > 0 || m_bExit.load();
+			});
+			m_sleepers.fetch_sub(1, std::memory_order_seq_cst);
+			spins = 0;
+		}
+
+		t_context = {};
+	}
+}
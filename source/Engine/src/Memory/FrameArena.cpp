@@ -0,0 +1,64 @@
+#include "Memory/FrameArena.h"
+
+#include <cstring>
+
+namespace CE::Memory
+{
+	void* FrameArena::Allocate(std::size_t size, std::size_t alignment)
+	{
+		assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+		// Blocks kept from earlier frames come first, a new one only once they are all full
+		for (; m_current < m_blocks.size(); m_current++, m_offset = 0)
+		{
+			Block& block = m_blocks[m_current];
+			const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(block.data.get());
+			const std::uintptr_t aligned = (base + m_offset + alignment - 1) & ~(alignment - 1);
+			const std::size_t end = static_cast<std::size_t>(aligned - base) + size;
+			if (end <= block.size)
+			{
+				m_used += end - m_offset;
+				m_peak = std::max(m_peak, m_used);
+				m_offset = end;
+				return reinterpret_cast<void*>(aligned);
+			}
+		}
+
+		const std::size_t blockSize = std::max(m_blockSize, size + alignment);
+		m_blocks.push_back({ std::make_unique<std::byte[]>(blockSize), blockSize });
+		m_capacity += blockSize;
+		m_current = m_blocks.size() - 1;
+		m_offset = 0;
+		return Allocate(size, alignment);
+	}
+
+	std::string_view FrameArena::CopyString(std::string_view text)
+	{
+		char* copy = static_cast<char*>(Allocate(text.size() + 1, alignof(char)));
+		std::memcpy(copy, text.data(), text.size());
+		copy[text.size()] = '\0';
+		return { copy, text.size() };
+	}
+
+	bool FrameArena::Owns(const void* pointer) const
+	{
+		// std::less orders pointers from unrelated allocations, plain < does not have to
+		const std::less<const std::byte*> before;
+		const std::byte* address = static_cast<const std::byte*>(pointer);
+		for (const Block& block : m_blocks)
+		{
+			if (!before(address, block.data.get()) && before(address, block.data.get() + block.size))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void FrameArena::Reset()
+	{
+		m_current = 0;
+		m_offset = 0;
+		m_used = 0;
+	}
+}
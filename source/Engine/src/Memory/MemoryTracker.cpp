@@ -0,0 +1,264 @@
+#include "Memory/MemoryTracker.h"
+
+#include "Systems/LogSystem.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace CE::Memory
+{
+	namespace
+	{
+		// Plain byte so it needs no dynamic initialisation, allocations can happen before main
+		thread_local std::uint8_t t_tag = static_cast<std::uint8_t>(MemoryTag::UNTAGGED);
+
+		double ToMegabytes(std::int64_t bytes)
+		{
+			return static_cast<double>(bytes) / (1024.0 * 1024.0);
+		}
+	}
+
+	MemoryTag FindMemoryTag(std::string_view name)
+	{
+		for (std::size_t i = 0; i < s_tagCount; i++)
+		{
+			const MemoryTag tag = static_cast<MemoryTag>(i);
+			if (name == GetMemoryTagName(tag))
+			{
+				return tag;
+			}
+		}
+		return MemoryTag::COUNT;
+	}
+
+	MemoryTracker& MemoryTracker::Get()
+	{
+		// Constant initialised and trivially destructible, so it is usable from the first allocation
+		// before main through the last free from static destructors
+		static MemoryTracker s_tracker;
+		return s_tracker;
+	}
+
+	MemoryTag MemoryTracker::GetThreadTag()
+	{
+		return static_cast<MemoryTag>(t_tag);
+	}
+
+	void MemoryTracker::SetThreadTag(MemoryTag tag)
+	{
+		t_tag = static_cast<std::uint8_t>(tag);
+	}
+
+	void MemoryTracker::OnAllocate(MemoryTag tag, std::size_t size)
+	{
+		TagCounters& counters = m_counters[static_cast<std::size_t>(tag)];
+
+		const std::int64_t live = counters.liveBytes.fetch_add(static_cast<std::int64_t>(size), std::memory_order_relaxed) + static_cast<std::int64_t>(size);
+		counters.liveAllocations.fetch_add(1, std::memory_order_relaxed);
+		counters.totalAllocations.fetch_add(1, std::memory_order_relaxed);
+
+		std::int64_t peak = counters.peakBytes.load(std::memory_order_relaxed);
+		while (live > peak && !counters.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+	}
+
+	void MemoryTracker::OnFree(MemoryTag tag, std::size_t size)
+	{
+		TagCounters& counters = m_counters[static_cast<std::size_t>(tag)];
+		counters.liveBytes.fetch_sub(static_cast<std::int64_t>(size), std::memory_order_relaxed);
+		counters.liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	void MemoryTracker::SetBudget(MemoryTag tag, std::size_t bytes)
+	{
+		m_counters[static_cast<std::size_t>(tag)].budget.store(bytes, std::memory_order_relaxed);
+	}
+
+	std::size_t MemoryTracker::GetBudget(MemoryTag tag) const
+	{
+		return m_counters[static_cast<std::size_t>(tag)].budget.load(std::memory_order_relaxed);
+	}
+
+	void MemoryTracker::EndFrame()
+	{
+		for (std::size_t i = 0; i < s_tagCount; i++)
+		{
+			const TagCounters& counters = m_counters[i];
+
+			const std::uint64_t total = counters.totalAllocations.load(std::memory_order_relaxed);
+			m_frameAllocations[i] = total - m_lastTotals[i];
+			m_lastTotals[i] = total;
+
+			const std::size_t budget = counters.budget.load(std::memory_order_relaxed);
+			const std::int64_t live = counters.liveBytes.load(std::memory_order_relaxed);
+			const bool bOver = budget > 0 && live > static_cast<std::int64_t>(budget);
+
+			// Only warn on the way over, a tag sitting over budget would flood the log otherwise
+			if (bOver && !m_bOverBudget[i])
+			{
+				std::string_view name = GetMemoryTagName(static_cast<MemoryTag>(i));
+				const double liveMb = ToMegabytes(live);
+				const double budgetMb = ToMegabytes(static_cast<std::int64_t>(budget));
+				LOG_WARN(ENGINE, "Memory tag {} over budget: {:.2f}MB of {:.2f}MB", name, liveMb, budgetMb);
+			}
+			m_bOverBudget[i] = bOver;
+		}
+	}
+
+	TagStats MemoryTracker::GetStats(MemoryTag tag) const
+	{
+		const std::size_t index = static_cast<std::size_t>(tag);
+		const TagCounters& counters = m_counters[index];
+
+		TagStats stats;
+		stats.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+		stats.liveAllocations = counters.liveAllocations.load(std::memory_order_relaxed);
+		stats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+		stats.totalAllocations = counters.totalAllocations.load(std::memory_order_relaxed);
+		stats.frameAllocations = m_frameAllocations[index];
+		stats.budget = counters.budget.load(std::memory_order_relaxed);
+		return stats;
+	}
+}
+
+#ifdef CE_MEMORY_TRACKING
+
+//
+// Global allocation hooks
+//
+// Every block is prefixed with a header recording its size, tag and the distance back to the start
+// of the real allocation. Over aligned blocks pad the header out to the alignment so the user
+// pointer stays aligned.
+//
+namespace
+{
+	using CE::Memory::MemoryTag;
+	using CE::Memory::MemoryTracker;
+
+	struct AllocationHeader
+	{
+		std::size_t size;
+		std::uint32_t offset;
+		std::uint8_t tag;
+	};
+
+	constexpr std::size_t s_headerSize = 16;
+	static_assert(sizeof(AllocationHeader) <= s_headerSize);
+
+	void* TrackedAllocate(std::size_t size, std::size_t alignment) noexcept
+	{
+		alignment = std::max(alignment, s_headerSize);
+		const std::size_t total = size + alignment;
+
+		void* base = nullptr;
+		if (alignment <= alignof(std::max_align_t))
+		{
+			base = std::malloc(total);
+		}
+		else
+		{
+#ifdef _WIN32
+			base = _aligned_malloc(total, alignment);
+#else
+			base = std::aligned_alloc(alignment, (total + alignment - 1) / alignment * alignment);
+#endif
+		}
+		if (base == nullptr)
+		{
+			return nullptr;
+		}
+
+		std::byte* user = static_cast<std::byte*>(base) + alignment;
+		AllocationHeader* header = reinterpret_cast<AllocationHeader*>(user - s_headerSize);
+		header->size = size;
+		header->offset = static_cast<std::uint32_t>(alignment);
+		header->tag = static_cast<std::uint8_t>(MemoryTracker::GetThreadTag());
+
+		MemoryTracker::Get().OnAllocate(static_cast<MemoryTag>(header->tag), size);
+		return user;
+	}
+
+	void TrackedFree(void* pointer) noexcept
+	{
+		if (pointer == nullptr)
+		{
+			return;
+		}
+
+		std::byte* user = static_cast<std::byte*>(pointer);
+		const AllocationHeader* header = reinterpret_cast<const AllocationHeader*>(user - s_headerSize);
+		const std::size_t alignment = header->offset;
+
+		MemoryTracker::Get().OnFree(static_cast<MemoryTag>(header->tag), header->size);
+
+		void* base = user - alignment;
+		if (alignment <= alignof(std::max_align_t))
+		{
+			std::free(base);
+		}
+		else
+		{
+#ifdef _WIN32
+			_aligned_free(base);
+#else
+			std::free(base);
+#endif
+		}
+	}
+
+	void* TrackedNew(std::size_t size, std::size_t alignment)
+	{
+		// Zero sized requests still need a unique pointer
+		size = std::max<std::size_t>(size, 1);
+		while (true)
+		{
+			if (void* pointer = TrackedAllocate(size, alignment))
+			{
+				return pointer;
+			}
+
+			std::new_handler handler = std::get_new_handler();
+			if (handler == nullptr)
+			{
+				throw std::bad_alloc();
+			}
+			handler();
+		}
+	}
+
+	void* TrackedNewNoThrow(std::size_t size, std::size_t alignment) noexcept
+	{
+		try
+		{
+			return TrackedNew(size, alignment);
+		}
+		catch (...)
+		{
+			return nullptr;
+		}
+	}
+}
+
+void* operator new(std::size_t size) { return TrackedNew(size, alignof(std::max_align_t)); }
+void* operator new[](std::size_t size) { return TrackedNew(size, alignof(std::max_align_t)); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return TrackedNewNoThrow(size, alignof(std::max_align_t)); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return TrackedNewNoThrow(size, alignof(std::max_align_t)); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return TrackedNew(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return TrackedNew(size, static_cast<std::size_t>(alignment)); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return TrackedNewNoThrow(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return TrackedNewNoThrow(size, static_cast<std::size_t>(alignment)); }
+
+void operator delete(void* pointer) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { TrackedFree(pointer); }
+
+#endif
@@ -0,0 +1,751 @@
+#include "Physics/PhysicsScene.h"
+
+#include <bit>
+#include <numeric>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CE_PHYSICS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace CE::Physics
+{
+	namespace
+	{
+		constexpr std::uint32_t InvalidIndex = std::numeric_limits<std::uint32_t>::max();
+
+		// Sorted broadphase arrays get this many extra slots so 4-wide loads never read past the end
+		constexpr std::size_t SortPadding = 4;
+
+		// Penetration allowed before position correction kicks in, keeps resting contacts stable
+		constexpr float PenetrationSlop = 0.01f;
+		constexpr float BaumgarteFactor = 0.2f;
+
+		// Closing speeds below this don't bounce, stops resting bodies from jittering
+		constexpr float RestitutionThreshold = 1.f;
+
+		bool CollideSphereSphere(const glm::vec3& pa, float ra, const glm::vec3& pb, float rb, glm::vec3& normal, float& depth)
+		{
+			glm::vec3 delta = pb - pa;
+			float dist2 = glm::dot(delta, delta);
+			float radii = ra + rb;
+			if (dist2 >= radii * radii) { return false; }
+
+			float dist = std::sqrt(dist2);
+			normal = dist > 1e-6f ? delta / dist : glm::vec3(0.f, 1.f, 0.f);
+			depth = radii - dist;
+			return true;
+		}
+
+		bool CollideSphereBox(const glm::vec3& pa, float ra, const glm::vec3& pb, const glm::vec3& hb, glm::vec3& normal, float& depth)
+		{
+			glm::vec3 closest = glm::clamp(pa, pb - hb, pb + hb);
+			glm::vec3 delta = closest - pa;
+			float dist2 = glm::dot(delta, delta);
+			if (dist2 >= ra * ra) { return false; }
+
+			if (dist2 > 1e-12f)
+			{
+				float dist = std::sqrt(dist2);
+				normal = delta / dist;
+				depth = ra - dist;
+				return true;
+			}
+
+			// Center is inside the box, push out through the nearest face
+			glm::vec3 local = pa - pb;
+			glm::vec3 faceDist = hb - glm::abs(local);
+			int axis = 0;
+			if (faceDist[1] < faceDist[axis]) { axis = 1; }
+			if (faceDist[2] < faceDist[axis]) { axis = 2; }
+
+			normal = glm::vec3(0.f);
+			normal[axis] = local[axis] >= 0.f ? -1.f : 1.f;
+			depth = ra + faceDist[axis];
+			return true;
+		}
+
+		bool CollideBoxBox(const glm::vec3& pa, const glm::vec3& ha, const glm::vec3& pb, const glm::vec3& hb, glm::vec3& normal, float& depth)
+		{
+			glm::vec3 delta = pb - pa;
+			glm::vec3 overlap = (ha + hb) - glm::abs(delta);
+			if (overlap.x <= 0.f || overlap.y <= 0.f || overlap.z <= 0.f) { return false; }
+
+			int axis = 0;
+			if (overlap[1] < overlap[axis]) { axis = 1; }
+			if (overlap[2] < overlap[axis]) { axis = 2; }
+
+			normal = glm::vec3(0.f);
+			normal[axis] = delta[axis] >= 0.f ? 1.f : -1.f;
+			depth = overlap[axis];
+			return true;
+		}
+
+		void ComputeTangents(const glm::vec3& normal, glm::vec3& t1, glm::vec3& t2)
+		{
+			if (std::abs(normal.x) >= 0.57735f)
+			{
+				t1 = glm::normalize(glm::vec3(normal.y, -normal.x, 0.f));
+			}
+			else
+			{
+				t1 = glm::normalize(glm::vec3(0.f, normal.z, -normal.y));
+			}
+			t2 = glm::cross(normal, t1);
+		}
+	}
+
+	BodyID PhysicsScene::AddBody(const BodyDesc& desc)
+	{
+		BodyID id;
+		if (!m_freeIds.empty())
+		{
+			id = m_freeIds.back();
+			m_freeIds.pop_back();
+		}
+		else
+		{
+			id = static_cast<BodyID>(m_idToDense.size());
+			m_idToDense.push_back(InvalidIndex);
+		}
+
+		const std::uint32_t dense = static_cast<std::uint32_t>(m_posX.size());
+		m_idToDense[id] = dense;
+		m_denseToId.push_back(id);
+
+		glm::vec3 extents = desc.shape == ShapeType::SPHERE ? glm::vec3(desc.radius) : desc.halfExtents;
+		bool bDynamic = desc.mass > 0.f;
+
+		m_posX.push_back(desc.position.x);
+		m_posY.push_back(desc.position.y);
+		m_posZ.push_back(desc.position.z);
+		m_velX.push_back(bDynamic ? desc.velocity.x : 0.f);
+		m_velY.push_back(bDynamic ? desc.velocity.y : 0.f);
+		m_velZ.push_back(bDynamic ? desc.velocity.z : 0.f);
+		m_extX.push_back(extents.x);
+		m_extY.push_back(extents.y);
+		m_extZ.push_back(extents.z);
+		m_radius.push_back(desc.radius);
+		m_invMass.push_back(bDynamic ? 1.f / desc.mass : 0.f);
+		m_restitution.push_back(desc.restitution);
+		m_friction.push_back(desc.friction);
+		m_sleepTimer.push_back(0.f);
+		m_shape.push_back(desc.shape);
+		m_awake.push_back(bDynamic ? 1 : 0);
+		m_user.push_back(desc.user);
+
+		m_bOrderDirty = true;
+		return id;
+	}
+
+	void PhysicsScene::RemoveBody(BodyID id)
+	{
+		if (!IsValid(id)) { return; }
+
+		const std::uint32_t dense = m_idToDense[id];
+		const std::uint32_t last = static_cast<std::uint32_t>(m_posX.size() - 1);
+
+		auto swapRemove = [dense](auto& array) {
+			array[dense] = array.back();
+			array.pop_back();
+		};
+
+		swapRemove(m_posX); swapRemove(m_posY); swapRemove(m_posZ);
+		swapRemove(m_velX); swapRemove(m_velY); swapRemove(m_velZ);
+		swapRemove(m_extX); swapRemove(m_extY); swapRemove(m_extZ);
+		swapRemove(m_radius);
+		swapRemove(m_invMass);
+		swapRemove(m_restitution);
+		swapRemove(m_friction);
+		swapRemove(m_sleepTimer);
+		swapRemove(m_shape);
+		swapRemove(m_awake);
+		swapRemove(m_user);
+
+		const BodyID movedId = m_denseToId[last];
+		swapRemove(m_denseToId);
+		if (dense != last)
+		{
+			m_idToDense[movedId] = dense;
+		}
+
+		m_idToDense[id] = InvalidIndex;
+		m_freeIds.push_back(id);
+		m_bOrderDirty = true;
+	}
+
+	void PhysicsScene::Clear()
+	{
+		// Keep the tuning and scheduler, only the bodies go
+		PhysicsScene empty;
+		empty.m_gravity = m_gravity;
+		empty.m_solverIterations = m_solverIterations;
+		empty.m_sleepVelocity = m_sleepVelocity;
+		empty.m_timeToSleep = m_timeToSleep;
+		empty.m_parallelFor = std::move(m_parallelFor);
+		*this = std::move(empty);
+	}
+
+	bool PhysicsScene::IsValid(BodyID id) const
+	{
+		return id < m_idToDense.size() && m_idToDense[id] != InvalidIndex;
+	}
+
+	glm::vec3 PhysicsScene::GetPosition(BodyID id) const
+	{
+		assert(IsValid(id));
+		const std::uint32_t i = m_idToDense[id];
+		return glm::vec3(m_posX[i], m_posY[i], m_posZ[i]);
+	}
+
+	glm::vec3 PhysicsScene::GetVelocity(BodyID id) const
+	{
+		assert(IsValid(id));
+		const std::uint32_t i = m_idToDense[id];
+		return glm::vec3(m_velX[i], m_velY[i], m_velZ[i]);
+	}
+
+	ComponentHandle PhysicsScene::GetUser(BodyID id) const
+	{
+		if (!IsValid(id)) { return ComponentHandle::INVALID; }
+		return m_user[m_idToDense[id]];
+	}
+
+	bool PhysicsScene::IsAsleep(BodyID id) const
+	{
+		assert(IsValid(id));
+		const std::uint32_t i = m_idToDense[id];
+		return IsDynamic(i) && !m_awake[i];
+	}
+
+	bool PhysicsScene::IsStatic(BodyID id) const
+	{
+		assert(IsValid(id));
+		return !IsDynamic(m_idToDense[id]);
+	}
+
+	void PhysicsScene::SetPosition(BodyID id, const glm::vec3& position)
+	{
+		assert(IsValid(id));
+		const std::uint32_t i = m_idToDense[id];
+		m_posX[i] = position.x;
+		m_posY[i] = position.y;
+		m_posZ[i] = position.z;
+		WakeDense(i);
+	}
+
+	void PhysicsScene::SetVelocity(BodyID id, const glm::vec3& velocity)
+	{
+		assert(IsValid(id));
+		const std::uint32_t i = m_idToDense[id];
+		if (!IsDynamic(i)) { return; }
+		m_velX[i] = velocity.x;
+		m_velY[i] = velocity.y;
+		m_velZ[i] = velocity.z;
+		WakeDense(i);
+	}
+
+	void PhysicsScene::ApplyImpulse(BodyID id, const glm::vec3& impulse)
+	{
+		assert(IsValid(id));
+		const std::uint32_t i = m_idToDense[id];
+		if (!IsDynamic(i)) { return; }
+		m_velX[i] += impulse.x * m_invMass[i];
+		m_velY[i] += impulse.y * m_invMass[i];
+		m_velZ[i] += impulse.z * m_invMass[i];
+		WakeDense(i);
+	}
+
+	void PhysicsScene::Wake(BodyID id)
+	{
+		assert(IsValid(id));
+		WakeDense(m_idToDense[id]);
+	}
+
+	void PhysicsScene::WakeDense(std::uint32_t index)
+	{
+		if (!IsDynamic(index)) { return; }
+		if (!m_awake[index])
+		{
+			m_awake[index] = 1;
+			m_sleepTimer[index] = 0.f;
+		}
+	}
+
+	void PhysicsScene::Step(float deltaTime)
+	{
+		using Clock = std::chrono::steady_clock;
+		using Milliseconds = std::chrono::duration<double, std::milli>;
+
+		if (deltaTime <= 0.f) { return; }
+
+		auto start = Clock::now();
+
+		IntegrateVelocities(deltaTime);
+
+		UpdateBounds();
+		SortAxis();
+		FindPairs();
+		auto broadphaseEnd = Clock::now();
+
+		FindContacts();
+		auto narrowphaseEnd = Clock::now();
+
+		BuildIslands();
+
+		auto solve = [this, deltaTime](const Island& island) {
+			if (island.bAwake)
+			{
+				SolveIsland(island, deltaTime);
+			}
+		};
+
+		if (m_parallelFor)
+		{
+			m_parallelFor(m_islands.size(), [&](std::size_t index) { solve(m_islands[index]); });
+		}
+		else
+		{
+			std::for_each(m_islands.begin(), m_islands.end(), solve);
+		}
+
+		IntegratePositions(deltaTime);
+		UpdateSleep(deltaTime);
+		auto end = Clock::now();
+
+		m_stats.bodies = m_posX.size();
+		m_stats.pairs = m_pairs.size();
+		m_stats.contacts = m_contacts.size();
+		m_stats.islands = m_islands.size();
+		m_stats.awake = 0;
+		for (std::uint32_t i = 0; i < m_posX.size(); i++)
+		{
+			m_stats.awake += IsActive(i) ? 1 : 0;
+		}
+		m_stats.broadphaseMs = Milliseconds(broadphaseEnd - start).count();
+		m_stats.narrowphaseMs = Milliseconds(narrowphaseEnd - broadphaseEnd).count();
+		m_stats.solveMs = Milliseconds(end - narrowphaseEnd).count();
+		m_stats.totalMs = Milliseconds(end - start).count();
+	}
+
+	void PhysicsScene::IntegrateVelocities(float deltaTime)
+	{
+		const float gx = m_gravity.x * deltaTime;
+		const float gy = m_gravity.y * deltaTime;
+		const float gz = m_gravity.z * deltaTime;
+
+		// Branch free so the compiler can vectorize it, statics and sleepers get a zero scale
+		const std::size_t count = m_posX.size();
+		for (std::size_t i = 0; i < count; i++)
+		{
+			const float scale = (m_invMass[i] > 0.f && m_awake[i]) ? 1.f : 0.f;
+			m_velX[i] += gx * scale;
+			m_velY[i] += gy * scale;
+			m_velZ[i] += gz * scale;
+		}
+	}
+
+	void PhysicsScene::UpdateBounds()
+	{
+		const std::size_t count = m_posX.size();
+		m_minX.resize(count); m_maxX.resize(count);
+		m_minY.resize(count); m_maxY.resize(count);
+		m_minZ.resize(count); m_maxZ.resize(count);
+
+		for (std::size_t i = 0; i < count; i++)
+		{
+			m_minX[i] = m_posX[i] - m_extX[i];
+			m_maxX[i] = m_posX[i] + m_extX[i];
+			m_minY[i] = m_posY[i] - m_extY[i];
+			m_maxY[i] = m_posY[i] + m_extY[i];
+			m_minZ[i] = m_posZ[i] - m_extZ[i];
+			m_maxZ[i] = m_posZ[i] + m_extZ[i];
+		}
+	}
+
+	void PhysicsScene::SortAxis()
+	{
+		const std::size_t count = m_posX.size();
+
+		if (m_bOrderDirty || m_order.size() != count)
+		{
+			m_order.resize(count);
+			std::iota(m_order.begin(), m_order.end(), 0);
+			std::sort(m_order.begin(), m_order.end(), [this](std::uint32_t a, std::uint32_t b) {
+				return m_minX[a] < m_minX[b];
+			});
+			m_bOrderDirty = false;
+		}
+		else
+		{
+			// Bodies barely move between steps so the previous order is almost sorted already
+			for (std::size_t i = 1; i < count; i++)
+			{
+				const std::uint32_t key = m_order[i];
+				const float keyMin = m_minX[key];
+				std::size_t j = i;
+				while (j > 0 && m_minX[m_order[j - 1]] > keyMin)
+				{
+					m_order[j] = m_order[j - 1];
+					j--;
+				}
+				m_order[j] = key;
+			}
+		}
+
+		// Gather bounds into sort order so the sweep reads memory linearly
+		const float inf = std::numeric_limits<float>::infinity();
+		m_sortedMinX.assign(count + SortPadding, inf);
+		m_sortedMaxX.assign(count + SortPadding, -inf);
+		m_sortedMinY.assign(count + SortPadding, inf);
+		m_sortedMaxY.assign(count + SortPadding, -inf);
+		m_sortedMinZ.assign(count + SortPadding, inf);
+		m_sortedMaxZ.assign(count + SortPadding, -inf);
+		m_sortedActive.assign(count + SortPadding, 0);
+
+		for (std::size_t i = 0; i < count; i++)
+		{
+			const std::uint32_t body = m_order[i];
+			m_sortedMinX[i] = m_minX[body];
+			m_sortedMaxX[i] = m_maxX[body];
+			m_sortedMinY[i] = m_minY[body];
+			m_sortedMaxY[i] = m_maxY[body];
+			m_sortedMinZ[i] = m_minZ[body];
+			m_sortedMaxZ[i] = m_maxZ[body];
+			m_sortedActive[i] = IsActive(body) ? 1 : 0;
+		}
+	}
+
+	void PhysicsScene::FindPairs()
+	{
+		m_pairs.clear();
+
+		const std::size_t count = m_posX.size();
+		for (std::size_t i = 0; i < count; i++)
+		{
+			const float maxX = m_sortedMaxX[i];
+			const float minY = m_sortedMinY[i];
+			const float maxY = m_sortedMaxY[i];
+			const float minZ = m_sortedMinZ[i];
+			const float maxZ = m_sortedMaxZ[i];
+			const std::uint8_t active = m_sortedActive[i];
+
+			std::size_t j = i + 1;
+
+#ifdef CE_PHYSICS_SSE2
+			const __m128 vMaxX = _mm_set1_ps(maxX);
+			const __m128 vMinY = _mm_set1_ps(minY);
+			const __m128 vMaxY = _mm_set1_ps(maxY);
+			const __m128 vMinZ = _mm_set1_ps(minZ);
+			const __m128 vMaxZ = _mm_set1_ps(maxZ);
+
+			for (; j < count; j += 4)
+			{
+				// Sorted on min X, so the X mask is always a run of low bits
+				const int xMask = _mm_movemask_ps(_mm_cmple_ps(_mm_loadu_ps(&m_sortedMinX[j]), vMaxX));
+				if (xMask == 0) { break; }
+
+				const __m128 overlapY = _mm_and_ps(
+					_mm_cmple_ps(_mm_loadu_ps(&m_sortedMinY[j]), vMaxY),
+					_mm_cmpge_ps(_mm_loadu_ps(&m_sortedMaxY[j]), vMinY));
+				const __m128 overlapZ = _mm_and_ps(
+					_mm_cmple_ps(_mm_loadu_ps(&m_sortedMinZ[j]), vMaxZ),
+					_mm_cmpge_ps(_mm_loadu_ps(&m_sortedMaxZ[j]), vMinZ));
+
+				unsigned int mask = static_cast<unsigned int>(xMask & _mm_movemask_ps(_mm_and_ps(overlapY, overlapZ)));
+				while (mask != 0)
+				{
+					const std::size_t other = j + std::countr_zero(mask);
+					mask &= mask - 1;
+					if (active | m_sortedActive[other])
+					{
+						m_pairs.emplace_back(m_order[i], m_order[other]);
+					}
+				}
+
+				if (xMask != 0xF) { break; }
+			}
+#else
+			for (; j < count && m_sortedMinX[j] <= maxX; j++)
+			{
+				if ((active | m_sortedActive[j]) == 0) { continue; }
+				if (m_sortedMinY[j] > maxY || m_sortedMaxY[j] < minY) { continue; }
+				if (m_sortedMinZ[j] > maxZ || m_sortedMaxZ[j] < minZ) { continue; }
+				m_pairs.emplace_back(m_order[i], m_order[j]);
+			}
+#endif
+		}
+	}
+
+	void PhysicsScene::FindContacts()
+	{
+		m_contacts.clear();
+
+		for (const auto& [a, b] : m_pairs)
+		{
+			const glm::vec3 pa(m_posX[a], m_posY[a], m_posZ[a]);
+			const glm::vec3 pb(m_posX[b], m_posY[b], m_posZ[b]);
+
+			Contact contact{ a, b, glm::vec3(0.f), 0.f };
+			bool bHit = false;
+
+			if (m_shape[a] == ShapeType::SPHERE && m_shape[b] == ShapeType::SPHERE)
+			{
+				bHit = CollideSphereSphere(pa, m_radius[a], pb, m_radius[b], contact.normal, contact.depth);
+			}
+			else if (m_shape[a] == ShapeType::SPHERE)
+			{
+				const glm::vec3 hb(m_extX[b], m_extY[b], m_extZ[b]);
+				bHit = CollideSphereBox(pa, m_radius[a], pb, hb, contact.normal, contact.depth);
+			}
+			else if (m_shape[b] == ShapeType::SPHERE)
+			{
+				const glm::vec3 ha(m_extX[a], m_extY[a], m_extZ[a]);
+				bHit = CollideSphereBox(pb, m_radius[b], pa, ha, contact.normal, contact.depth);
+				contact.normal = -contact.normal;
+			}
+			else
+			{
+				const glm::vec3 ha(m_extX[a], m_extY[a], m_extZ[a]);
+				const glm::vec3 hb(m_extX[b], m_extY[b], m_extZ[b]);
+				bHit = CollideBoxBox(pa, ha, pb, hb, contact.normal, contact.depth);
+			}
+
+			if (bHit)
+			{
+				m_contacts.push_back(contact);
+			}
+		}
+
+		m_constraints.resize(m_contacts.size());
+	}
+
+	std::uint32_t PhysicsScene::FindRoot(std::uint32_t index)
+	{
+		while (m_parent[index] != index)
+		{
+			m_parent[index] = m_parent[m_parent[index]];
+			index = m_parent[index];
+		}
+		return index;
+	}
+
+	void PhysicsScene::BuildIslands()
+	{
+		const std::uint32_t count = static_cast<std::uint32_t>(m_posX.size());
+
+		// Union dynamic bodies that touch, statics never join islands or they'd merge everything on the ground
+		m_parent.resize(count);
+		std::iota(m_parent.begin(), m_parent.end(), 0);
+		for (const Contact& contact : m_contacts)
+		{
+			if (IsDynamic(contact.a) && IsDynamic(contact.b))
+			{
+				std::uint32_t rootA = FindRoot(contact.a);
+				std::uint32_t rootB = FindRoot(contact.b);
+				if (rootA != rootB)
+				{
+					m_parent[rootA] = rootB;
+				}
+			}
+		}
+
+		m_islands.clear();
+		m_islandOf.assign(count, InvalidIndex);
+		for (std::uint32_t i = 0; i < count; i++)
+		{
+			if (!IsDynamic(i)) { continue; }
+
+			const std::uint32_t root = FindRoot(i);
+			if (m_islandOf[root] == InvalidIndex)
+			{
+				m_islandOf[root] = static_cast<std::uint32_t>(m_islands.size());
+				m_islands.push_back({ 0, 0, 0, 0, false });
+			}
+			m_islandOf[i] = m_islandOf[root];
+		}
+
+		// Count, prefix sum, then scatter bodies and contacts into their island ranges
+		for (std::uint32_t i = 0; i < count; i++)
+		{
+			if (m_islandOf[i] != InvalidIndex)
+			{
+				m_islands[m_islandOf[i]].bodyEnd++;
+			}
+		}
+		for (const Contact& contact : m_contacts)
+		{
+			const std::uint32_t body = IsDynamic(contact.a) ? contact.a : contact.b;
+			m_islands[m_islandOf[body]].contactEnd++;
+		}
+
+		std::uint32_t bodyOffset = 0;
+		std::uint32_t contactOffset = 0;
+		for (Island& island : m_islands)
+		{
+			const std::uint32_t bodies = island.bodyEnd;
+			const std::uint32_t contacts = island.contactEnd;
+			island.bodyBegin = island.bodyEnd = bodyOffset;
+			island.contactBegin = island.contactEnd = contactOffset;
+			bodyOffset += bodies;
+			contactOffset += contacts;
+		}
+
+		m_islandBodies.resize(bodyOffset);
+		m_islandContacts.resize(contactOffset);
+
+		for (std::uint32_t i = 0; i < count; i++)
+		{
+			if (m_islandOf[i] == InvalidIndex) { continue; }
+
+			Island& island = m_islands[m_islandOf[i]];
+			m_islandBodies[island.bodyEnd++] = i;
+			island.bAwake = island.bAwake || m_awake[i];
+		}
+		for (std::uint32_t c = 0; c < m_contacts.size(); c++)
+		{
+			const Contact& contact = m_contacts[c];
+			const std::uint32_t body = IsDynamic(contact.a) ? contact.a : contact.b;
+			Island& island = m_islands[m_islandOf[body]];
+			m_islandContacts[island.contactEnd++] = c;
+		}
+
+		// Anything awake in an island wakes the whole island
+		for (const Island& island : m_islands)
+		{
+			if (!island.bAwake) { continue; }
+			for (std::uint32_t b = island.bodyBegin; b < island.bodyEnd; b++)
+			{
+				WakeDense(m_islandBodies[b]);
+			}
+		}
+	}
+
+	void PhysicsScene::SolveIsland(const Island& island, float deltaTime)
+	{
+		// Only the island's own bodies are written, statics have zero inverse mass and are skipped
+		// so islands sharing a static body never race on it
+		auto applyImpulse = [this](std::uint32_t body, const glm::vec3& impulse) {
+			const float invMass = m_invMass[body];
+			if (invMass > 0.f)
+			{
+				m_velX[body] += impulse.x * invMass;
+				m_velY[body] += impulse.y * invMass;
+				m_velZ[body] += impulse.z * invMass;
+			}
+		};
+
+		auto velocity = [this](std::uint32_t body) {
+			return glm::vec3(m_velX[body], m_velY[body], m_velZ[body]);
+		};
+
+		for (std::uint32_t c = island.contactBegin; c < island.contactEnd; c++)
+		{
+			const std::uint32_t index = m_islandContacts[c];
+			const Contact& contact = m_contacts[index];
+			ContactConstraint& constraint = m_constraints[index];
+
+			const float invMassSum = m_invMass[contact.a] + m_invMass[contact.b];
+			const float closingSpeed = glm::dot(velocity(contact.b) - velocity(contact.a), contact.normal);
+			const float restitution = std::max(m_restitution[contact.a], m_restitution[contact.b]);
+
+			constraint.normalMass = invMassSum > 0.f ? 1.f / invMassSum : 0.f;
+			constraint.bias = (BaumgarteFactor / deltaTime) * std::max(contact.depth - PenetrationSlop, 0.f);
+			constraint.restitutionTarget = closingSpeed < -RestitutionThreshold ? -restitution * closingSpeed : 0.f;
+			constraint.friction = std::sqrt(m_friction[contact.a] * m_friction[contact.b]);
+			constraint.normalImpulse = 0.f;
+			constraint.tangentImpulse1 = 0.f;
+			constraint.tangentImpulse2 = 0.f;
+		}
+
+		for (int iteration = 0; iteration < m_solverIterations; iteration++)
+		{
+			for (std::uint32_t c = island.contactBegin; c < island.contactEnd; c++)
+			{
+				const std::uint32_t index = m_islandContacts[c];
+				const Contact& contact = m_contacts[index];
+				ContactConstraint& constraint = m_constraints[index];
+
+				// Normal, accumulated impulse is clamped so contacts only ever push
+				glm::vec3 relative = velocity(contact.b) - velocity(contact.a);
+				const float target = std::max(constraint.restitutionTarget, constraint.bias);
+				float lambda = -constraint.normalMass * (glm::dot(relative, contact.normal) - target);
+				const float previousNormal = constraint.normalImpulse;
+				constraint.normalImpulse = std::max(previousNormal + lambda, 0.f);
+				lambda = constraint.normalImpulse - previousNormal;
+
+				applyImpulse(contact.a, contact.normal * -lambda);
+				applyImpulse(contact.b, contact.normal * lambda);
+
+				// Friction, bounded by the normal impulse on each tangent
+				glm::vec3 t1, t2;
+				ComputeTangents(contact.normal, t1, t2);
+				const float maxFriction = constraint.friction * constraint.normalImpulse;
+
+				relative = velocity(contact.b) - velocity(contact.a);
+				float lambdaT1 = -constraint.normalMass * glm::dot(relative, t1);
+				const float previousT1 = constraint.tangentImpulse1;
+				constraint.tangentImpulse1 = std::clamp(previousT1 + lambdaT1, -maxFriction, maxFriction);
+				lambdaT1 = constraint.tangentImpulse1 - previousT1;
+
+				float lambdaT2 = -constraint.normalMass * glm::dot(relative, t2);
+				const float previousT2 = constraint.tangentImpulse2;
+				constraint.tangentImpulse2 = std::clamp(previousT2 + lambdaT2, -maxFriction, maxFriction);
+				lambdaT2 = constraint.tangentImpulse2 - previousT2;
+
+				const glm::vec3 frictionImpulse = t1 * lambdaT1 + t2 * lambdaT2;
+				applyImpulse(contact.a, -frictionImpulse);
+				applyImpulse(contact.b, frictionImpulse);
+			}
+		}
+	}
+
+	void PhysicsScene::IntegratePositions(float deltaTime)
+	{
+		const std::size_t count = m_posX.size();
+		for (std::size_t i = 0; i < count; i++)
+		{
+			const float step = (m_invMass[i] > 0.f && m_awake[i]) ? deltaTime : 0.f;
+			m_posX[i] += m_velX[i] * step;
+			m_posY[i] += m_velY[i] * step;
+			m_posZ[i] += m_velZ[i] * step;
+		}
+	}
+
+	void PhysicsScene::UpdateSleep(float deltaTime)
+	{
+		const float threshold = m_sleepVelocity * m_sleepVelocity;
+
+		m_stats.sleepingIslands = 0;
+		for (const Island& island : m_islands)
+		{
+			if (!island.bAwake)
+			{
+				m_stats.sleepingIslands++;
+				continue;
+			}
+
+			// Every body has to have been resting long enough before the island can sleep
+			bool bCanSleep = true;
+			for (std::uint32_t b = island.bodyBegin; b < island.bodyEnd; b++)
+			{
+				const std::uint32_t body = m_islandBodies[b];
+				const float speed2 = m_velX[body] * m_velX[body] + m_velY[body] * m_velY[body] + m_velZ[body] * m_velZ[body];
+				m_sleepTimer[body] = speed2 < threshold ? m_sleepTimer[body] + deltaTime : 0.f;
+				bCanSleep = bCanSleep && m_sleepTimer[body] >= m_timeToSleep;
+			}
+
+			if (!bCanSleep) { continue; }
+
+			for (std::uint32_t b = island.bodyBegin; b < island.bodyEnd; b++)
+			{
+				const std::uint32_t body = m_islandBodies[b];
+				m_awake[body] = 0;
+				m_velX[body] = 0.f;
+				m_velY[body] = 0.f;
+				m_velZ[body] = 0.f;
+			}
+			m_stats.sleepingIslands++;
+		}
+	}
+}
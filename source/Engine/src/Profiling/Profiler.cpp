@@ -0,0 +1,282 @@
+#include "Profiling/Profiler.h"
+
+#include "Memory/MemoryTracker.h"
+
+#include <iomanip>
+
+namespace CE::Profiling
+{
+	namespace
+	{
+		void WriteEscaped(std::ostream& out, std::string_view text)
+		{
+			for (char c : text)
+			{
+				switch (c)
+				{
+				case '"': out << "\\\""; break;
+				case '\\': out << "\\\\"; break;
+				case '\n': out << "\\n"; break;
+				default:
+					if (static_cast<unsigned char>(c) >= 0x20)
+					{
+						out << c;
+					}
+					break;
+				}
+			}
+		}
+
+		// Chrome traces are in microseconds
+		double ToMicroseconds(Timestamp time)
+		{
+			return static_cast<double>(time) / 1000.0;
+		}
+	}
+
+	thread_local Profiler::ThreadBuffer* Profiler::t_buffer = nullptr;
+	thread_local Profiler::ThreadRetirer Profiler::t_retirer;
+
+	Profiler::ThreadRetirer::~ThreadRetirer()
+	{
+		if (t_buffer != nullptr)
+		{
+			Profiler::Get().RetireThreadBuffer();
+		}
+	}
+
+	Profiler& Profiler::Get()
+	{
+		static Profiler s_profiler;
+		return s_profiler;
+	}
+
+	Profiler::Profiler() :
+		m_epoch(std::chrono::steady_clock::now()),
+		m_frames(s_historySize)
+	{
+	}
+
+	Timestamp Profiler::Now() const
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_epoch).count();
+	}
+
+	Profiler::ThreadBuffer& Profiler::GetThreadBuffer()
+	{
+		if (t_buffer == nullptr)
+		{
+			MEMORY_SCOPE(Memory::MemoryTag::PROFILER);
+			t_retirer.bRegistered = true;
+
+			std::lock_guard<std::mutex> lock(m_threadsMutex);
+			for (const std::unique_ptr<ThreadBuffer>& buffer : m_threads)
+			{
+				if (buffer->bRetired)
+				{
+					// Anything the old thread left undrained still goes out with the next frame
+					buffer->bRetired = false;
+					buffer->depth = 0;
+					buffer->name = std::format("Thread {}", buffer->index);
+					t_buffer = buffer.get();
+					return *t_buffer;
+				}
+			}
+
+			auto buffer = std::make_unique<ThreadBuffer>();
+			buffer->events = std::make_unique<ScopeEvent[]>(s_threadCapacity);
+			buffer->index = static_cast<std::uint32_t>(m_threads.size());
+			buffer->name = std::format("Thread {}", buffer->index);
+			t_buffer = buffer.get();
+			m_threads.push_back(std::move(buffer));
+		}
+		return *t_buffer;
+	}
+
+	void Profiler::RetireThreadBuffer()
+	{
+		std::lock_guard<std::mutex> lock(m_threadsMutex);
+		t_buffer->bRetired = true;
+		t_buffer = nullptr;
+	}
+
+	void Profiler::SetThreadName(std::string name)
+	{
+		ThreadBuffer& buffer = GetThreadBuffer();
+
+		std::lock_guard<std::mutex> lock(m_threadsMutex);
+		buffer.name = std::move(name);
+	}
+
+	std::uint32_t Profiler::BeginScope()
+	{
+		return GetThreadBuffer().depth++;
+	}
+
+	void Profiler::EndScope(const char* name, Timestamp begin, std::uint32_t depth)
+	{
+		const Timestamp end = Now();
+
+		ThreadBuffer& buffer = GetThreadBuffer();
+		buffer.depth = depth;
+
+		// Single producer, only this thread moves head and only the frame thread moves tail
+		const std::uint64_t head = buffer.head.load(std::memory_order_relaxed);
+		if (head - buffer.tail.load(std::memory_order_acquire) >= s_threadCapacity)
+		{
+			buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		ScopeEvent& event = buffer.events[head & (s_threadCapacity - 1)];
+		event.name = name;
+		event.begin = begin;
+		event.end = end;
+		event.depth = depth;
+		event.thread = buffer.index;
+		buffer.head.store(head + 1, std::memory_order_release);
+	}
+
+	void Profiler::BeginFrame()
+	{
+		m_frameBegin = Now();
+	}
+
+	void Profiler::EndFrame()
+	{
+		MEMORY_SCOPE(Memory::MemoryTag::PROFILER);
+		const Timestamp frameEnd = Now();
+
+		FrameRecord* frame = nullptr;
+		if (!m_bPaused)
+		{
+			frame = &m_frames[m_frameHead];
+			frame->index = m_frameIndex;
+			frame->begin = m_frameBegin;
+			frame->end = frameEnd;
+			frame->thread = GetThreadBuffer().index;
+			frame->events.clear();
+		}
+		m_frameIndex++;
+
+		{
+			std::lock_guard<std::mutex> lock(m_threadsMutex);
+			for (const std::unique_ptr<ThreadBuffer>& buffer : m_threads)
+			{
+				const std::uint64_t tail = buffer->tail.load(std::memory_order_relaxed);
+				const std::uint64_t head = buffer->head.load(std::memory_order_acquire);
+				if (frame != nullptr)
+				{
+					for (std::uint64_t i = tail; i < head; i++)
+					{
+						frame->events.push_back(buffer->events[i & (s_threadCapacity - 1)]);
+					}
+				}
+				buffer->tail.store(head, std::memory_order_release);
+			}
+		}
+
+		if (frame != nullptr)
+		{
+			m_frameHead = (m_frameHead + 1) % s_historySize;
+			m_frameCount = std::min(m_frameCount + 1, s_historySize);
+		}
+
+		m_frameBegin = frameEnd;
+	}
+
+	const FrameRecord& Profiler::GetFrame(std::size_t index) const
+	{
+		assert(index < m_frameCount);
+		const std::size_t oldest = (m_frameHead + s_historySize - m_frameCount) % s_historySize;
+		return m_frames[(oldest + index) % s_historySize];
+	}
+
+	std::vector<std::string> Profiler::GetThreadNames() const
+	{
+		std::lock_guard<std::mutex> lock(m_threadsMutex);
+
+		std::vector<std::string> names;
+		names.reserve(m_threads.size());
+		for (const std::unique_ptr<ThreadBuffer>& buffer : m_threads)
+		{
+			names.push_back(buffer->name);
+		}
+		return names;
+	}
+
+	std::uint64_t Profiler::GetDroppedEvents() const
+	{
+		std::lock_guard<std::mutex> lock(m_threadsMutex);
+
+		std::uint64_t dropped = 0;
+		for (const std::unique_ptr<ThreadBuffer>& buffer : m_threads)
+		{
+			dropped += buffer->dropped.load(std::memory_order_relaxed);
+		}
+		return dropped;
+	}
+
+	bool Profiler::ExportChromeTrace(const std::filesystem::path& path) const
+	{
+		std::vector<const FrameRecord*> frames;
+		frames.reserve(m_frameCount);
+		for (std::size_t f = 0; f < m_frameCount; f++)
+		{
+			frames.push_back(&GetFrame(f));
+		}
+		return ExportChromeTrace(path, frames);
+	}
+
+	bool Profiler::ExportChromeTrace(const std::filesystem::path& path, const std::vector<const FrameRecord*>& frames) const
+	{
+		std::ofstream file(path, std::ios::trunc);
+		if (!file)
+		{
+			return false;
+		}
+
+		file << std::fixed << std::setprecision(3);
+		file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+		bool bFirst = true;
+		auto separator = [&file, &bFirst]() {
+			if (!bFirst)
+			{
+				file << ",\n";
+			}
+			bFirst = false;
+		};
+
+		const std::vector<std::string> threadNames = GetThreadNames();
+		for (std::size_t i = 0; i < threadNames.size(); i++)
+		{
+			separator();
+			file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << i << ",\"args\":{\"name\":\"";
+			WriteEscaped(file, threadNames[i]);
+			file << "\"}}";
+		}
+
+		for (const FrameRecord* framePtr : frames)
+		{
+			const FrameRecord& frame = *framePtr;
+
+			// Frames wrap everything on the thread driving them so the timeline reads frame by frame
+			separator();
+			file << "{\"name\":\"Frame " << frame.index << "\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":" << frame.thread
+				<< ",\"ts\":" << ToMicroseconds(frame.begin) << ",\"dur\":" << ToMicroseconds(frame.end - frame.begin) << "}";
+
+			for (const ScopeEvent& event : frame.events)
+			{
+				separator();
+				file << "{\"name\":\"";
+				WriteEscaped(file, event.name);
+				file << "\",\"cat\":\"scope\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread
+					<< ",\"ts\":" << ToMicroseconds(event.begin) << ",\"dur\":" << ToMicroseconds(event.end - event.begin) << "}";
+			}
+		}
+
+		file << "\n]}\n";
+		return static_cast<bool>(file);
+	}
+}
@@ -0,0 +1,245 @@
+#include "Replay/ReplayFile.h"
+
+namespace CE::Replay
+{
+	namespace
+	{
+		constexpr std::array<char, 4> s_magic = { 'C', 'E', 'R', 'P' };
+		constexpr std::uint32_t s_version = 1;
+
+		// Where frameCount sits in the header, so Close can patch it
+		constexpr std::streamoff s_frameCountOffset = sizeof(s_magic) + sizeof(std::uint32_t) * 2 + sizeof(double);
+
+		template <typename T>
+		void Write(std::ostream& stream, const T& value)
+		{
+			static_assert(std::is_trivially_copyable_v<T>);
+			stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+		}
+
+		template <typename T>
+		bool Read(std::istream& stream, T& value)
+		{
+			static_assert(std::is_trivially_copyable_v<T>);
+			stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+			return static_cast<bool>(stream);
+		}
+
+		template <typename Enum>
+		std::uint8_t ToByte(Enum value)
+		{
+			return static_cast<std::uint8_t>(value);
+		}
+
+		// Type byte, then only the fields that type uses
+		void WriteInput(std::ostream& stream, const InputEvent& event)
+		{
+			if (auto key = event.GetKey())
+			{
+				Write(stream, ToByte(InputEventType::KEY));
+				Write(stream, ToByte(key->key));
+				Write(stream, ToByte(key->state));
+			}
+			else if (auto button = event.GetMouseButton())
+			{
+				Write(stream, ToByte(InputEventType::MOUSE_BUTTON));
+				Write(stream, ToByte(button->button));
+				Write(stream, ToByte(button->state));
+			}
+			else if (auto axis = event.GetAxis())
+			{
+				Write(stream, ToByte(InputEventType::AXIS));
+				Write(stream, ToByte(axis->axis));
+				Write(stream, axis->value);
+			}
+			else if (auto axis2D = event.GetAxis2D())
+			{
+				Write(stream, ToByte(InputEventType::AXIS_2D));
+				Write(stream, ToByte(axis2D->axis));
+				Write(stream, axis2D->value.X);
+				Write(stream, axis2D->value.Y);
+			}
+			else
+			{
+				Write(stream, ToByte(InputEventType::UNKNOWN));
+			}
+		}
+
+		bool ReadInput(std::istream& stream, InputEvent& event)
+		{
+			std::uint8_t type = 0;
+			std::uint8_t code = 0;
+			if (!Read(stream, type))
+			{
+				return false;
+			}
+
+			switch (static_cast<InputEventType>(type))
+			{
+			case InputEventType::KEY:
+			{
+				std::uint8_t state = 0;
+				Read(stream, code);
+				Read(stream, state);
+				event.SetKey(static_cast<KeyType>(code), static_cast<KeyState>(state));
+				break;
+			}
+			case InputEventType::MOUSE_BUTTON:
+			{
+				std::uint8_t state = 0;
+				Read(stream, code);
+				Read(stream, state);
+				event.SetMouseButton(static_cast<MouseButtonType>(code), static_cast<KeyState>(state));
+				break;
+			}
+			case InputEventType::AXIS:
+			{
+				float value = 0.f;
+				Read(stream, code);
+				Read(stream, value);
+				event.SetAxis(static_cast<AxisType>(code), value);
+				break;
+			}
+			case InputEventType::AXIS_2D:
+			{
+				float x = 0.f;
+				float y = 0.f;
+				Read(stream, code);
+				Read(stream, x);
+				Read(stream, y);
+				event.SetAxis2D(static_cast<Axis2DType>(code), x, y);
+				break;
+			}
+			default:
+				event = InputEvent();
+				break;
+			}
+			return static_cast<bool>(stream);
+		}
+	}
+
+	ReplayWriter::~ReplayWriter()
+	{
+		Close();
+	}
+
+	bool ReplayWriter::Open(const std::filesystem::path& path, const ReplayHeader& header)
+	{
+		Close();
+
+		m_file.open(path, std::ios::binary | std::ios::trunc);
+		if (!m_file.is_open())
+		{
+			return false;
+		}
+
+		m_frameCount = 0;
+
+		m_file.write(s_magic.data(), s_magic.size());
+		Write(m_file, s_version);
+		Write(m_file, header.seed);
+		Write(m_file, header.tickRate);
+		Write(m_file, std::uint64_t(0));
+		return static_cast<bool>(m_file);
+	}
+
+	void ReplayWriter::Close()
+	{
+		if (!m_file.is_open())
+		{
+			return;
+		}
+
+		m_file.seekp(s_frameCountOffset);
+		Write(m_file, m_frameCount);
+		m_file.close();
+	}
+
+	bool ReplayWriter::WriteFrame(const ReplayFrame& frame)
+	{
+		if (frame.inputs.size() > std::numeric_limits<std::uint16_t>::max())
+		{
+			return false;
+		}
+
+		Write(m_file, frame.deltaTime);
+		Write(m_file, static_cast<std::uint8_t>(frame.bInputFirst));
+		Write(m_file, frame.eventsPosted);
+		Write(m_file, static_cast<std::uint16_t>(frame.inputs.size()));
+		for (const InputEvent& input : frame.inputs)
+		{
+			WriteInput(m_file, input);
+		}
+
+		if (!m_file)
+		{
+			return false;
+		}
+		m_frameCount++;
+		return true;
+	}
+
+	bool ReplayReader::Open(const std::filesystem::path& path)
+	{
+		Close();
+
+		m_file.open(path, std::ios::binary);
+		if (!m_file.is_open())
+		{
+			return false;
+		}
+
+		std::array<char, 4> magic{};
+		std::uint32_t version = 0;
+		m_file.read(magic.data(), magic.size());
+		Read(m_file, version);
+		if (!m_file || magic != s_magic || version != s_version)
+		{
+			m_file.close();
+			return false;
+		}
+
+		Read(m_file, m_header.seed);
+		Read(m_file, m_header.tickRate);
+		Read(m_file, m_header.frameCount);
+		m_frameIndex = 0;
+		return static_cast<bool>(m_file);
+	}
+
+	void ReplayReader::Close()
+	{
+		if (m_file.is_open())
+		{
+			m_file.close();
+		}
+	}
+
+	bool ReplayReader::ReadFrame(ReplayFrame& frame)
+	{
+		// An unclosed recording has no count, read until the data stops
+		if (!m_file.is_open() || (m_header.frameCount > 0 && m_frameIndex >= m_header.frameCount))
+		{
+			return false;
+		}
+
+		std::uint8_t bInputFirst = 0;
+		std::uint16_t inputCount = 0;
+		if (!Read(m_file, frame.deltaTime) || !Read(m_file, bInputFirst) || !Read(m_file, frame.eventsPosted) || !Read(m_file, inputCount))
+		{
+			return false;
+		}
+		frame.bInputFirst = bInputFirst != 0;
+
+		frame.inputs.resize(inputCount);
+		for (InputEvent& input : frame.inputs)
+		{
+			if (!ReadInput(m_file, input))
+			{
+				return false;
+			}
+		}
+
+		m_frameIndex++;
+		return true;
+	}
+}
@@ -8,6 +8,53 @@
 #ifdef CDEBUG
 namespace CE
 {
+#ifdef CE_EVENT_STATS
+	namespace
+	{
+		// Most listener tables are short, a targeted storm can leave thousands, only the worst are drawn
+		constexpr std::size_t s_maxListenerRows = 200;
+
+		float LastFrame(const std::vector<float>& history, std::size_t head)
+		{
+			if (history.empty()) { return 0.f; }
+			return history.size() < Events::QueueStats::s_historySize ? history.back() : history[(head + history.size() - 1) % history.size()];
+		}
+
+		// Time spent in the frame that just finished, zero if the listener didn't fire in it
+		double LastFrameMs(const Events::ListenerStats& stats)
+		{
+			return Events::s_statsFrame > 0 && stats.frame == Events::s_statsFrame - 1 ? stats.frameNs / 1e6 : 0.0;
+		}
+
+		template <typename T>
+		int Compare(const T& a, const T& b)
+		{
+			return a < b ? -1 : (b < a ? 1 : 0);
+		}
+
+		// Sorts rows by whichever columns the table header has selected, compare(a, b, column) does the rest
+		template <typename Row, typename Function>
+		void SortRows(std::vector<Row>& rows, Function&& compare)
+		{
+			const ImGuiTableSortSpecs* specs = ImGui::TableGetSortSpecs();
+			if (specs == nullptr || specs->SpecsCount == 0) { return; }
+
+			std::stable_sort(rows.begin(), rows.end(), [&](const Row& a, const Row& b) {
+				for (int i = 0; i < specs->SpecsCount; i++)
+				{
+					const ImGuiTableColumnSortSpecs& spec = specs->Specs[i];
+					const int result = compare(a, b, spec.ColumnIndex);
+					if (result != 0)
+					{
+						return spec.SortDirection == ImGuiSortDirection_Ascending ? result < 0 : result > 0;
+					}
+				}
+				return false;
+			});
+		}
+	}
+#endif
+
 	void EventSystemDebug::OnDrawGUI()
 	{
 		if (m_owner == nullptr) { return; }
@@ -15,26 +62,223 @@ namespace CE
 		ImGui::Begin("Event System Debug");
 		if (ImGui::CollapsingHeader("Queues", ImGuiTreeNodeFlags_DefaultOpen))
 		{
-			for (auto [typeIndex, queue] : m_owner->m_queues)
+			// Listed in dispatch order
+			for (EventTypeID id : m_owner->m_dispatchOrder)
 			{
-				std::string queueName = std::string(queue->GetQueueName());
+				const EventSystem::QueueSlot& slot = m_owner->m_queues[id];
+				std::string queueName = std::string(slot.queue->GetQueueName());
 				ImGui::Bullet();
-				ImGui::Text(queueName.c_str());
+				ImGui::Text("%s (priority %d)", queueName.c_str(), slot.priority);
 			}
+			ImGui::Text("Cascade overflows: %llu", static_cast<unsigned long long>(m_owner->m_cascadeOverflows));
 		}
 
 		if (ImGui::CollapsingHeader("Pending Events", ImGuiTreeNodeFlags_DefaultOpen))
 		{
+			for (EventTypeID id : m_owner->m_dispatchOrder)
+			{
+				IEventQueue* queue = m_owner->m_queues[id].queue;
+				std::string queueName = std::string(queue->GetQueueName());
+				ImGui::Text("%s: %zu (%zu delayed)", queueName.c_str(), queue->GetPendingCount(), queue->GetScheduledCount());
+			}
+			ImGui::Text("Event time: %.3f s", m_owner->m_time);
+		}
 
-			ImGui::Text("Show event queues here...");
+		if (ImGui::CollapsingHeader("Payload Memory"))
+		{
+			for (std::size_t index = 0; index < m_owner->m_frameArenas.size(); index++)
+			{
+				const Memory::FrameArena& arena = m_owner->m_frameArenas[index];
+				const char* role = index == m_owner->m_frameArenaIndex ? "this frame" : "last frame";
+				ImGui::Text("Frame arena (%s): %zu / %zu bytes, peak %zu", role, arena.GetUsedBytes(), arena.GetCapacity(), arena.GetPeakBytes());
+			}
+			ImGui::Text("Interned strings: %zu, %zu bytes", InternedString::GetInternedCount(), InternedString::GetInternedBytes());
 		}
 
 		if (ImGui::CollapsingHeader("Listeners", ImGuiTreeNodeFlags_DefaultOpen))
 		{
-			ImGui::Text("Show listeners here...");
+			for (EventTypeID id : m_owner->m_dispatchOrder)
+			{
+				IEventQueue* queue = m_owner->m_queues[id].queue;
+				std::string queueName = std::string(queue->GetQueueName());
+				ImGui::Text("%s: %zu", queueName.c_str(), queue->GetListenerCount());
+			}
 		}
 
+#ifdef CE_EVENT_STATS
+		if (ImGui::CollapsingHeader("Queue Stats", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			DrawQueueStats();
+		}
+
+		if (ImGui::CollapsingHeader("Listener Stats", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			DrawListenerStats();
+		}
+
+		ImGui::InputText("##ExportPath", m_exportPath, sizeof(m_exportPath));
+		ImGui::SameLine();
+		if (ImGui::Button("Export Stats"))
+		{
+			m_owner->ExportStats(m_exportPath);
+		}
+#endif
+
 		ImGui::End();
 	}
+
+#ifdef CE_EVENT_STATS
+	void EventSystemDebug::DrawQueueStats()
+	{
+		const ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp | ImGuiTableFlags_Sortable;
+		if (!ImGui::BeginTable("QueueStats", 8, flags))
+		{
+			return;
+		}
+
+		ImGui::TableSetupColumn("Queue");
+		ImGui::TableSetupColumn("Posted");
+		ImGui::TableSetupColumn("Dispatched");
+		ImGui::TableSetupColumn("Dispatch ms", ImGuiTableColumnFlags_DefaultSort | ImGuiTableColumnFlags_PreferSortDescending);
+		ImGui::TableSetupColumn("Peak ms", ImGuiTableColumnFlags_PreferSortDescending);
+		ImGui::TableSetupColumn("Peak/Frame", ImGuiTableColumnFlags_PreferSortDescending);
+		ImGui::TableSetupColumn("High Water", ImGuiTableColumnFlags_PreferSortDescending);
+		ImGui::TableSetupColumn("Dispatch ms History", ImGuiTableColumnFlags_NoSort);
+		ImGui::TableHeadersRow();
+
+		std::vector<IEventQueue*> queues;
+		for (EventTypeID id : m_owner->m_dispatchOrder)
+		{
+			queues.push_back(m_owner->m_queues[id].queue);
+		}
+
+		SortRows(queues, [](IEventQueue* a, IEventQueue* b, int column) {
+			const Events::QueueStats& statsA = a->GetStats();
+			const Events::QueueStats& statsB = b->GetStats();
+			switch (column)
+			{
+			case 0: return Compare(a->GetQueueName(), b->GetQueueName());
+			case 1: return Compare(LastFrame(statsA.postedHistory, statsA.historyHead), LastFrame(statsB.postedHistory, statsB.historyHead));
+			case 2: return Compare(LastFrame(statsA.dispatchedHistory, statsA.historyHead), LastFrame(statsB.dispatchedHistory, statsB.historyHead));
+			case 3: return Compare(LastFrame(statsA.dispatchMsHistory, statsA.historyHead), LastFrame(statsB.dispatchMsHistory, statsB.historyHead));
+			case 4: return Compare(statsA.peakDispatchNs, statsB.peakDispatchNs);
+			case 5: return Compare(statsA.peakDispatched, statsB.peakDispatched);
+			case 6: return Compare(statsA.pendingHighWater, statsB.pendingHighWater);
+			default: return 0;
+			}
+		});
+
+		for (IEventQueue* queue : queues)
+		{
+			const Events::QueueStats& stats = queue->GetStats();
+			const std::string queueName(queue->GetQueueName());
+
+			ImGui::PushID(queue);
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn(); ImGui::Text("%s", queueName.c_str());
+			ImGui::TableNextColumn(); ImGui::Text("%.0f", LastFrame(stats.postedHistory, stats.historyHead));
+			ImGui::TableNextColumn(); ImGui::Text("%.0f", LastFrame(stats.dispatchedHistory, stats.historyHead));
+			ImGui::TableNextColumn(); ImGui::Text("%.3f", LastFrame(stats.dispatchMsHistory, stats.historyHead));
+			ImGui::TableNextColumn(); ImGui::Text("%.3f", stats.peakDispatchNs / 1e6);
+			ImGui::TableNextColumn(); ImGui::Text("%llu", static_cast<unsigned long long>(stats.peakDispatched));
+			ImGui::TableNextColumn(); ImGui::Text("%zu", stats.pendingHighWater);
+
+			// Ring buffer, the offset starts the line at the oldest frame
+			ImGui::TableNextColumn();
+			ImGui::PlotLines("##History", stats.dispatchMsHistory.data(), static_cast<int>(stats.dispatchMsHistory.size()),
+				static_cast<int>(stats.historyHead), nullptr, 0.f, FLT_MAX, ImVec2(-1.f, ImGui::GetTextLineHeight() * 2.f));
+			ImGui::PopID();
+		}
+
+		ImGui::EndTable();
+
+		ImGui::Text("Cascade overflows: %llu", static_cast<unsigned long long>(m_owner->m_cascadeOverflows));
+	}
+
+	void EventSystemDebug::DrawListenerStats()
+	{
+		bool bTiming = Events::IsListenerTimingEnabled();
+		if (ImGui::Checkbox("Time Listeners", &bTiming))
+		{
+			Events::SetListenerTiming(bTiming);
+		}
+
+		std::vector<Events::ListenerStatsRow> rows;
+		for (EventTypeID id : m_owner->m_dispatchOrder)
+		{
+			m_owner->m_queues[id].queue->CollectListenerStats(rows);
+		}
+
+		const ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp
+			| ImGuiTableFlags_Sortable | ImGuiTableFlags_ScrollY;
+		if (!ImGui::BeginTable("ListenerStats", 8, flags, ImVec2(0.f, ImGui::GetTextLineHeight() * 16.f)))
+		{
+			return;
+		}
+
+		ImGui::TableSetupScrollFreeze(0, 1);
+		ImGui::TableSetupColumn("Queue");
+		ImGui::TableSetupColumn("Registered At");
+		ImGui::TableSetupColumn("Target");
+		ImGui::TableSetupColumn("Calls", ImGuiTableColumnFlags_PreferSortDescending);
+		ImGui::TableSetupColumn("Frame ms", ImGuiTableColumnFlags_DefaultSort | ImGuiTableColumnFlags_PreferSortDescending);
+		ImGui::TableSetupColumn("Peak Frame ms", ImGuiTableColumnFlags_PreferSortDescending);
+		ImGui::TableSetupColumn("Total ms", ImGuiTableColumnFlags_PreferSortDescending);
+		ImGui::TableSetupColumn("us/Call", ImGuiTableColumnFlags_PreferSortDescending);
+		ImGui::TableHeadersRow();
+
+		const auto perCall = [](const Events::ListenerStats& stats) {
+			return stats.calls > 0 ? stats.totalNs / 1e3 / stats.calls : 0.0;
+		};
+
+		SortRows(rows, [&perCall](const Events::ListenerStatsRow& a, const Events::ListenerStatsRow& b, int column) {
+			switch (column)
+			{
+			case 0: return Compare(a.queue, b.queue);
+			case 1:
+			{
+				const int byFile = Compare(std::string_view(a.stats.registeredAt.file_name()), std::string_view(b.stats.registeredAt.file_name()));
+				return byFile != 0 ? byFile : Compare(a.stats.registeredAt.line(), b.stats.registeredAt.line());
+			}
+			case 2: return Compare(a.target.raw(), b.target.raw());
+			case 3: return Compare(a.stats.calls, b.stats.calls);
+			case 4: return Compare(LastFrameMs(a.stats), LastFrameMs(b.stats));
+			case 5: return Compare(a.stats.peakFrameNs, b.stats.peakFrameNs);
+			case 6: return Compare(a.stats.totalNs, b.stats.totalNs);
+			case 7: return Compare(perCall(a.stats), perCall(b.stats));
+			default: return 0;
+			}
+		});
+
+		const std::size_t shown = std::min(rows.size(), s_maxListenerRows);
+		for (std::size_t i = 0; i < shown; i++)
+		{
+			const Events::ListenerStatsRow& row = rows[i];
+			const std::string queueName(row.queue);
+			const std::string file = std::filesystem::path(row.stats.registeredAt.file_name()).filename().string();
+
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn(); ImGui::Text("%s", queueName.c_str());
+			ImGui::TableNextColumn(); ImGui::Text("%s:%u", file.c_str(), static_cast<unsigned>(row.stats.registeredAt.line()));
+			ImGui::TableNextColumn();
+			if (row.target != EntityHandle::INVALID)
+			{
+				ImGui::Text("%llu", static_cast<unsigned long long>(row.target.GetIndex()));
+			}
+			ImGui::TableNextColumn(); ImGui::Text("%llu", static_cast<unsigned long long>(row.stats.calls));
+			ImGui::TableNextColumn(); ImGui::Text("%.3f", LastFrameMs(row.stats));
+			ImGui::TableNextColumn(); ImGui::Text("%.3f", row.stats.peakFrameNs / 1e6);
+			ImGui::TableNextColumn(); ImGui::Text("%.3f", row.stats.totalNs / 1e6);
+			ImGui::TableNextColumn(); ImGui::Text("%.2f", perCall(row.stats));
+		}
+
+		ImGui::EndTable();
+
+		if (shown < rows.size())
+		{
+			ImGui::Text("Showing the first %zu of %zu listeners", shown, rows.size());
+		}
+	}
+#endif
 }
 #endif
\ No newline at end of file
@@ -115,6 +115,7 @@ namespace CE
 		ImGui::SeparatorText("Log");
 		ImGui::BeginChild("Log", ImVec2(0, 0), true);
 
+		std::lock_guard<std::mutex> lock(m_owner->m_logMutex);
 		for (LogSystem::LogElement& elem : m_owner->m_log)
 		{
 			bool bMatchLevel = (elem.level == LogLevel::INFO && s_bLogInfo) ||
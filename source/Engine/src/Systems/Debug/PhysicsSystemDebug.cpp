@@ -0,0 +1,49 @@
+#include "Systems/Debug/PhysicsSystemDebug.h"
+
+#ifdef CDEBUG
+
+#include "Systems/PhysicsSystem.h"
+#include "imgui.h"
+
+namespace CE
+{
+	void PhysicsSystemDebug::OnDrawGUI()
+	{
+		if (m_owner == nullptr) { return; }
+
+		ImGui::Begin("Physics System Debug");
+
+		Physics::PhysicsScene& scene = m_owner->m_scene;
+		const Physics::SceneStats& stats = scene.GetStats();
+
+		if (ImGui::CollapsingHeader("Stats", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			ImGui::Text("Bodies: %zu (%zu awake)", stats.bodies, stats.awake);
+			ImGui::Text("Pairs: %zu", stats.pairs);
+			ImGui::Text("Contacts: %zu", stats.contacts);
+			ImGui::Text("Islands: %zu (%zu sleeping)", stats.islands, stats.sleepingIslands);
+			ImGui::Separator();
+			ImGui::Text("Broadphase: %.3fms", stats.broadphaseMs);
+			ImGui::Text("Narrowphase: %.3fms", stats.narrowphaseMs);
+			ImGui::Text("Solve: %.3fms", stats.solveMs);
+			ImGui::Text("Total: %.3fms", stats.totalMs);
+		}
+
+		if (ImGui::CollapsingHeader("Settings"))
+		{
+			ImGui::SliderFloat("Gravity", &scene.m_gravity.y, -30.f, 0.f);
+			ImGui::SliderInt("Solver Iterations", &scene.m_solverIterations, 1, 32);
+			ImGui::SliderFloat("Sleep Velocity", &scene.m_sleepVelocity, 0.f, 1.f);
+			ImGui::SliderFloat("Time To Sleep", &scene.m_timeToSleep, 0.f, 5.f);
+		}
+
+		if (ImGui::Button("Drop 100 Bodies"))
+		{
+			m_owner->DropTestBodies(100);
+		}
+
+		ImGui::End();
+	}
+}
+
+#endif
@@ -13,8 +13,43 @@ namespace CE
 
 		ImGui::Begin("World System Debug");
 
+		if (ImGui::CollapsingHeader("Snapshot"))
+		{
+			static std::filesystem::path s_snapshotPath = std::filesystem::temp_directory_path() / "world.snapshot";
+			ImGui::Text("%s", s_snapshotPath.string().c_str());
+			if (ImGui::Button("Save"))
+			{
+				m_owner->SaveSnapshot(s_snapshotPath);
+			}
+			ImGui::SameLine();
+			if (ImGui::Button("Load"))
+			{
+				m_owner->LoadSnapshot(s_snapshotPath);
+			}
+		}
+
 		m_owner->m_components.DrawComponentPools();
 
+		if (ImGui::CollapsingHeader("Spatial Index"))
+		{
+			const SpatialSubsystem& spatial = m_owner->m_spatial;
+			ImGui::Text("Items: %zu", spatial.GetItemCount());
+			ImGui::Text("Occupied Cells: %zu", spatial.GetCellCount());
+			ImGui::Text("Cell Size: %.1f", spatial.GetCellSize());
+		}
+
+		if (ImGui::CollapsingHeader("Queries"))
+		{
+			for (const std::weak_ptr<IWorldQuery>& weakQuery : m_owner->m_queries)
+			{
+				if (std::shared_ptr<IWorldQuery> query = weakQuery.lock())
+				{
+					std::string name(query->GetName());
+					ImGui::Text("%s: %zu matches", name.c_str(), query->GetMatchCount());
+				}
+			}
+		}
+
 		m_owner->m_entities.DrawEntityPool();
 
 		ImGui::End();
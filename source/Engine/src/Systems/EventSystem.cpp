@@ -2,7 +2,12 @@
 
 #include "Engine.h"
 #include "Systems/InputSystem.h"
+#include "Systems/JobSystem.h"
 #include "GUI/Editor.h"
+#include "Profiling/Profiler.h"
+
+#include <fstream>
+#include <iomanip>
 
 #ifdef CDEBUG
 #include "Systems/Debug/EventSystemDebug.h"
@@ -12,8 +17,16 @@ namespace CE
 {
 	EventSystem::EventSystem(Engine* engine) : EngineSystem(engine) {}
 
+	SystemDependencies EventSystem::GetDependencies() const
+	{
+		// Workers post through the scheduler's thread indices, it has to outlive every queue
+		return { typeid(LogSystem), typeid(JobSystem) };
+	}
+
 	void EventSystem::Startup()
 	{
+		m_scheduler = &m_engine->GetSystem<JobSystem>()->GetScheduler();
+
 		AddQueue<GameplayEvent>();
 
 
@@ -33,20 +46,164 @@ namespace CE
 		delete m_debugger;
 #endif
 
-		for (auto [index, queue] : m_queues)
+		for (EventTypeID id : m_dispatchOrder)
+		{
+			delete m_queues[id].queue;
+		}
+		m_queues.clear();
+		m_dispatchOrder.clear();
+	}
+
+	void EventSystem::ProcessEvents(double deltaTime)
+	{
+		PROFILE_SCOPE("EventSystem::ProcessEvents");
+		MEMORY_SCOPE(Memory::MemoryTag::EVENTS);
+
+		// Delayed events come due first, then what workers posted joins in behind them
+		m_time += deltaTime;
+		for (EventTypeID id : m_dispatchOrder)
+		{
+			m_queues[id].queue->AdvanceTime(m_time);
+			m_queues[id].queue->CollectStaged();
+		}
+
+		DispatchCascade();
+
+		// What this frame allocated stays put for anything left pending, the arena being reset held
+		// the frame before's, and whatever that frame left over was dispatched on the first pass above
+		m_frameArenaIndex ^= 1;
+		m_frameArenas[m_frameArenaIndex].Reset();
+
+#ifdef CE_EVENT_STATS
+		for (EventTypeID id : m_dispatchOrder)
 		{
-			delete queue;
+			m_queues[id].queue->EndStatsFrame();
 		}
+		Events::s_statsFrame++;
+#endif
 	}
 
-	void EventSystem::ProcessEvents()
+	void EventSystem::DispatchCascade()
 	{
-		for (auto& [typeIndex, queue] : m_queues)
+		// Each pass dispatches whatever every queue has pending, in dispatch order. Events posted by
+		// listeners cascade into the next pass until the budget runs out, then wait for next frame.
+		for (std::uint32_t pass = 0; pass < m_cascadeBudget; pass++)
+		{
+			bool bDispatched = false;
+			for (EventTypeID id : m_dispatchOrder)
+			{
+				IEventQueue* queue = m_queues[id].queue;
+				if (queue->HasPending())
+				{
+					queue->Process();
+					bDispatched = true;
+				}
+			}
+
+			if (!bDispatched)
+			{
+				return;
+			}
+		}
+
+		for (EventTypeID id : m_dispatchOrder)
 		{
-			queue->Process();
+			if (m_queues[id].queue->HasPending())
+			{
+				m_cascadeOverflows++;
+				return;
+			}
 		}
 	}
 
+	void EventSystem::RebuildDispatchOrder()
+	{
+		m_dispatchOrder.clear();
+		for (std::size_t id = 0; id < m_queues.size(); id++)
+		{
+			if (m_queues[id].queue)
+			{
+				m_dispatchOrder.push_back(static_cast<EventTypeID>(id));
+			}
+		}
+
+		std::sort(m_dispatchOrder.begin(), m_dispatchOrder.end(), [this](EventTypeID a, EventTypeID b) {
+			const QueueSlot& slotA = m_queues[a];
+			const QueueSlot& slotB = m_queues[b];
+			return slotA.priority != slotB.priority ? slotA.priority < slotB.priority : slotA.order < slotB.order;
+		});
+	}
+
+#ifdef CE_EVENT_STATS
+	bool EventSystem::ExportStats(const std::filesystem::path& path) const
+	{
+		std::ofstream file(path, std::ios::trunc);
+		if (!file)
+		{
+			std::string pathStr = path.string();
+			LOG_ERROR(EVENTS, "Failed to open event stats file {}", pathStr);
+			return false;
+		}
+
+		file << std::fixed << std::setprecision(3);
+		file << "{\n";
+		file << "\t\"frames\": " << Events::s_statsFrame << ",\n";
+		file << "\t\"cascadeOverflows\": " << m_cascadeOverflows << ",\n";
+		file << "\t\"queues\": [";
+		for (std::size_t i = 0; i < m_dispatchOrder.size(); i++)
+		{
+			IEventQueue* queue = m_queues[m_dispatchOrder[i]].queue;
+			const Events::QueueStats& stats = queue->GetStats();
+			file << (i > 0 ? "," : "") << "\n\t\t{ \"name\": \"" << queue->GetQueueName() << "\""
+				<< ", \"priority\": " << m_queues[m_dispatchOrder[i]].priority
+				<< ", \"posted\": " << stats.totalPosted
+				<< ", \"dispatched\": " << stats.totalDispatched
+				<< ", \"dispatchMs\": " << stats.totalDispatchNs / 1e6
+				<< ", \"peakDispatchedPerFrame\": " << stats.peakDispatched
+				<< ", \"peakDispatchMs\": " << stats.peakDispatchNs / 1e6
+				<< ", \"pendingHighWater\": " << stats.pendingHighWater << " }";
+		}
+		file << "\n\t],\n";
+
+		std::vector<Events::ListenerStatsRow> rows;
+		for (EventTypeID id : m_dispatchOrder)
+		{
+			m_queues[id].queue->CollectListenerStats(rows);
+		}
+
+		file << "\t\"listeners\": [";
+		for (std::size_t i = 0; i < rows.size(); i++)
+		{
+			const Events::ListenerStatsRow& row = rows[i];
+			file << (i > 0 ? "," : "") << "\n\t\t{ \"queue\": \"" << row.queue << "\""
+				<< ", \"handle\": " << row.handle.raw()
+				<< ", \"file\": \"" << std::filesystem::path(row.stats.registeredAt.file_name()).generic_string() << "\""
+				<< ", \"line\": " << row.stats.registeredAt.line()
+				<< ", \"calls\": " << row.stats.calls
+				<< ", \"totalMs\": " << row.stats.totalNs / 1e6
+				<< ", \"peakFrameMs\": " << row.stats.peakFrameNs / 1e6;
+			if (row.target != EntityHandle::INVALID)
+			{
+				file << ", \"target\": " << row.target.GetIndex();
+			}
+			file << " }";
+		}
+		file << "\n\t]\n}\n";
+
+		if (!file)
+		{
+			std::string pathStr = path.string();
+			LOG_ERROR(EVENTS, "Failed writing event stats file {}", pathStr);
+			return false;
+		}
+
+		std::string pathStr = path.string();
+		std::size_t listenerCount = rows.size();
+		LOG_INFO(EVENTS, "Wrote event stats for {} listeners to {}", listenerCount, pathStr);
+		return true;
+	}
+#endif
+
 	void EventSystem::TestEventSystem()
 	{
 		AddQueue<TestEvent>();
@@ -61,12 +218,17 @@ namespace CE
 		TestEvent testC;
 		testC.someString = "Test C";
 
-		RegisterGlobalListener<TestEvent>([](TestEvent e) {
+		RegisterGlobalListener<TestEvent>([](const TestEvent& e) {
 			LOG(EVENTS, "Listener works! {}", e.someString);
 			});
 
 		RegisterGlobalListener<TestEvent, EventSystem>(this, &EventSystem::OnTestEvent);
 
+		RegisterBatchListener<TestEvent>([](std::span<const TestEvent> events) {
+			std::size_t count = events.size();
+			LOG(EVENTS, "Batch listener works! {} events", count);
+			});
+
 		PostEvent(testA);
 		PostEvent(testB);
 		PostEvent(testC);
@@ -19,22 +19,31 @@ namespace CE
 {
 	InputSystem* g_input = nullptr;
 
+	SystemDependencies InputSystem::GetDependencies() const
+	{
+		return { typeid(LogSystem) };
+	}
+
 	void InputSystem::Startup()
 	{
 		LOG_INFO(INPUT, "Startup");
 
 		m_window = m_engine->GetWindow();
-		assert(m_window);
+		assert(m_window || m_engine->IsHeadless());
 
 		// Save this instance as the global instance for GLFW callbacks
 		g_input = this;
 
-		// Register callbacks for discrete input
-		glfwSetCursorPosCallback(m_window, &GOnCursorMoved);
-		glfwSetKeyCallback(m_window, &GOnKey);
-		glfwSetMouseButtonCallback(m_window, &GOnMouseButton);
-		glfwSetScrollCallback(m_window, &GOnScroll);
-		glfwSetWindowCloseCallback(m_window, &GOnWindowClose);
+		// Headless runs have nothing to listen to, actions still register but never fire
+		if (m_window)
+		{
+			// Register callbacks for discrete input
+			glfwSetCursorPosCallback(m_window, &GOnCursorMoved);
+			glfwSetKeyCallback(m_window, &GOnKey);
+			glfwSetMouseButtonCallback(m_window, &GOnMouseButton);
+			glfwSetScrollCallback(m_window, &GOnScroll);
+			glfwSetWindowCloseCallback(m_window, &GOnWindowClose);
+		}
 
 #ifdef CDEBUG
 		// Register debug GUI
@@ -66,6 +75,13 @@ namespace CE
 
 	void InputSystem::PollInput()
 	{
+		MEMORY_SCOPE(Memory::MemoryTag::INPUT);
+
+		if (m_window == nullptr)
+		{
+			return;
+		}
+
 		if (m_inputKnowledge.bNeedsUpdate)
 		{
 			UpdateInputKnowledge();
@@ -131,6 +147,10 @@ namespace CE
 
 	void InputSystem::ProcessActions()
 	{
+		MEMORY_SCOPE(Memory::MemoryTag::INPUT);
+
+		m_processedEvents.clear();
+
 		// Flush Event Queue
 		while (!m_events.empty())
 		{
@@ -138,12 +158,15 @@ namespace CE
 			{
 				action->ProcessEvent(m_events.front());
 			}
+			m_processedEvents.push_back(m_events.front());
 			m_events.pop();
 		}
 	}
 
 	void InputSystem::UpdateActions()
 	{
+		MEMORY_SCOPE(Memory::MemoryTag::INPUT);
+
 		for (auto& [handle, action] : m_actionPool)
 		{
 			action->Update(0.16f);
@@ -0,0 +1,27 @@
+#include "Systems/JobSystem.h"
+
+#include "Systems/LogSystem.h"
+
+namespace CE
+{
+	SystemDependencies JobSystem::GetDependencies() const
+	{
+		return { typeid(LogSystem) };
+	}
+
+	void JobSystem::Startup()
+	{
+		m_scheduler = std::make_unique<Jobs::JobScheduler>();
+
+		std::size_t workers = m_scheduler->GetWorkerCount();
+		LOG_INFO(ENGINE, "Startup Job System with {} workers", workers);
+	}
+
+	void JobSystem::Shutdown()
+	{
+		LOG_INFO(ENGINE, "Shutdown Job System");
+
+		// Finishes anything still queued before joining the workers
+		m_scheduler.reset();
+	}
+}
@@ -53,6 +53,9 @@ namespace CE
 			return;
 		}
 
+		// Systems start up on the job workers, so messages can come from any thread
+		std::lock_guard<std::mutex> lock(m_logMutex);
+
 		if (m_bLogToCout)
 		{
 			std::cout << message;
@@ -64,7 +67,7 @@ namespace CE
 			if (m_log.size() >= 1000)
 			{
 				m_log.clear();
-				LOG_WARN(INPUT, "Exceeded Log Storage! Clearing.");
+				m_log.emplace_back(LogLevel::WARNING, LogChannel::LOGGER, "Exceeded Log Storage! Clearing.\n");
 			}
 
 			LogElement elem(level, channel, message);
@@ -0,0 +1,236 @@
+#include "Systems/PhysicsSystem.h"
+
+#include "Engine.h"
+#include "Globals.h"
+#include "Systems/LogSystem.h"
+#include "Systems/InputSystem.h"
+#include "Systems/JobSystem.h"
+#include "Systems/WorldSystem.h"
+#include "Components/TransformComponent.h"
+#include "Components/RigidBodyComponent.h"
+#include "Profiling/Profiler.h"
+
+#include "Systems/Debug/PhysicsSystemDebug.h"
+
+namespace CE
+{
+	SystemDependencies PhysicsSystem::GetDependencies() const
+	{
+		return { typeid(LogSystem), typeid(JobSystem), typeid(InputSystem), typeid(WorldSystem) };
+	}
+
+	void PhysicsSystem::Startup()
+	{
+		LOG_INFO(PHYSICS, "Startup Physics System");
+
+#ifdef CDEBUG
+		m_debugger = new PhysicsSystemDebug(this);
+		std::shared_ptr<DebugSystem> DS = m_engine->GetSystem<DebugSystem>();
+		if (DS)
+		{
+			DS->Subscribe(m_debugger);
+		}
+#endif
+
+		// Islands are independent, spread their solves over the workers
+		std::shared_ptr<JobSystem> JS = m_engine->GetSystem<JobSystem>();
+		if (JS)
+		{
+			Jobs::JobScheduler* scheduler = &JS->GetScheduler();
+			m_scene.m_parallelFor = [scheduler](std::size_t count, const std::function<void(std::size_t)>& function) {
+				scheduler->ParallelFor(count, 0, [&function](std::size_t begin, std::size_t end) {
+					PROFILE_SCOPE("PhysicsScene::SolveIslands");
+					MEMORY_SCOPE(Memory::MemoryTag::PHYSICS);
+					for (std::size_t i = begin; i < end; i++)
+					{
+						function(i);
+					}
+				});
+			};
+		}
+
+		std::shared_ptr<WorldSystem> WS = m_engine->GetSystem<WorldSystem>();
+		if (WS)
+		{
+			WS->RegisterComponent<RigidBodyComponent>();
+			m_bodies = WS->CreateQuery<RigidBodyComponent, TransformComponent>("Physics Bodies");
+		}
+
+		CreateTestScene();
+
+		std::shared_ptr<InputSystem> IS = m_engine->GetSystem<InputSystem>();
+		if (IS)
+		{
+			IS->RegisterAction<PressedAction>("Drop Test Bodies", KeyType::P, [&]() {
+				this->DropTestBodies(100);
+			});
+		}
+	}
+
+	void PhysicsSystem::Shutdown()
+	{
+		LOG_INFO(PHYSICS, "Shutdown Physics System");
+
+		m_scene.Clear();
+		m_scene.m_parallelFor = nullptr;
+		m_bodies.reset();
+
+#ifdef CDEBUG
+		delete m_debugger;
+#endif
+	}
+
+	void PhysicsSystem::FixedUpdate(float deltaTime)
+	{
+		PROFILE_SCOPE("PhysicsSystem::FixedUpdate");
+		MEMORY_SCOPE(Memory::MemoryTag::PHYSICS);
+
+		std::shared_ptr<WorldSystem> WS = m_engine->GetSystem<WorldSystem>();
+		if (!WS || !m_bodies) { return; }
+
+		SyncBodies(*WS);
+		{
+			PROFILE_SCOPE("PhysicsScene::Step");
+			m_scene.Step(deltaTime);
+		}
+		WriteBack();
+	}
+
+	void PhysicsSystem::SyncBodies(WorldSystem& world)
+	{
+		PROFILE_SCOPE("PhysicsSystem::SyncBodies");
+
+		// A snapshot load replaces every component wholesale, start the scene over from the new state
+		if (m_snapshotGeneration != world.GetSnapshotGeneration())
+		{
+			m_snapshotGeneration = world.GetSnapshotGeneration();
+			m_scene.Clear();
+		}
+
+		// Stamp every body still backed by a matching component, anything unstamped afterwards is stale
+		m_syncStamp++;
+
+		m_bodies->ForEach([this](const EntityHandle&, RigidBodyComponent& body, TransformComponent& transform) {
+			const bool bTracked = m_scene.IsValid(body.m_body) && m_scene.GetUser(body.m_body) == body.m_handle;
+			if (!bTracked || body.m_bDirty)
+			{
+				if (bTracked)
+				{
+					m_scene.RemoveBody(body.m_body);
+				}
+
+				Physics::BodyDesc desc;
+				desc.shape = body.m_shape;
+				desc.radius = body.m_radius;
+				desc.halfExtents = body.m_halfExtents;
+				desc.mass = body.m_mass;
+				desc.restitution = body.m_restitution;
+				desc.friction = body.m_friction;
+				desc.position = transform.GetPosition();
+				desc.velocity = body.m_velocity;
+				desc.user = body.m_handle;
+
+				body.m_body = m_scene.AddBody(desc);
+				body.m_bDirty = false;
+			}
+			else
+			{
+				// WriteBack leaves the two equal, a difference means gameplay moved the entity itself
+				const glm::vec3 position = transform.GetPosition();
+				if (position != m_scene.GetPosition(body.m_body))
+				{
+					m_scene.SetPosition(body.m_body, position);
+				}
+			}
+
+			if (body.m_body >= m_bodyStamps.size())
+			{
+				m_bodyStamps.resize(body.m_body + 1, 0);
+			}
+			m_bodyStamps[body.m_body] = m_syncStamp;
+		});
+
+		m_staleBodies.clear();
+		m_scene.ForEachBody([this](Physics::BodyID id) {
+			if (id >= m_bodyStamps.size() || m_bodyStamps[id] != m_syncStamp)
+			{
+				m_staleBodies.push_back(id);
+			}
+		});
+		for (Physics::BodyID id : m_staleBodies)
+		{
+			m_scene.RemoveBody(id);
+		}
+	}
+
+	void PhysicsSystem::WriteBack()
+	{
+		PROFILE_SCOPE("PhysicsSystem::WriteBack");
+
+		m_bodies->ForEach([this](const EntityHandle&, RigidBodyComponent& body, TransformComponent& transform) {
+			if (!m_scene.IsValid(body.m_body) || m_scene.IsStatic(body.m_body)) { return; }
+
+			// Only touch transforms that moved so resting bodies don't dirty the spatial index
+			const glm::vec3 position = m_scene.GetPosition(body.m_body);
+			if (position != transform.GetPosition())
+			{
+				transform.SetPosition(position);
+			}
+			body.m_velocity = m_scene.GetVelocity(body.m_body);
+		});
+	}
+
+	void PhysicsSystem::CreateTestScene()
+	{
+		std::shared_ptr<WorldSystem> WS = m_engine->GetSystem<WorldSystem>();
+		if (!WS) { return; }
+
+		Entity& ground = WS->CreateEntity();
+		const EntityHandle groundHandle = ground.m_handle;
+		TransformComponent* transform = WS->AddComponent<TransformComponent>(groundHandle);
+		transform->SetPosition(glm::vec3(0.f, -1.f, 0.f));
+
+		RigidBodyComponent* body = WS->AddComponent<RigidBodyComponent>(groundHandle);
+		body->SetBox(glm::vec3(50.f, 1.f, 50.f));
+		body->SetMass(0.f);
+	}
+
+	void PhysicsSystem::DropTestBodies(std::size_t amount)
+	{
+		std::shared_ptr<WorldSystem> WS = m_engine->GetSystem<WorldSystem>();
+		if (!WS) { return; }
+
+		// Every body takes an entity and a component from two pools, stop short of filling any of them
+		const std::size_t space = std::min({ WS->GetFreeEntityCount(), WS->GetFreeComponentCount<TransformComponent>(), WS->GetFreeComponentCount<RigidBodyComponent>() });
+		if (amount > space)
+		{
+			LOG_WARN(PHYSICS, "Only room for {} of {} test bodies", space, amount);
+			amount = space;
+		}
+
+		LOG_INFO(PHYSICS, "Dropping {} test bodies", amount);
+
+		for (std::size_t i = 0; i < amount; i++)
+		{
+			Entity& entity = WS->CreateEntity();
+			const EntityHandle handle = entity.m_handle;
+
+			TransformComponent* transform = WS->AddComponent<TransformComponent>(handle);
+			transform->SetPosition(glm::vec3(
+				CE::Globals::g_rand.GetFloat(-20.f, 20.f),
+				CE::Globals::g_rand.GetFloat(5.f, 30.f),
+				CE::Globals::g_rand.GetFloat(-20.f, 20.f)
+			));
+
+			RigidBodyComponent* body = WS->AddComponent<RigidBodyComponent>(handle);
+			if (i % 2 == 0)
+			{
+				body->SetSphere(0.5f);
+			}
+			else
+			{
+				body->SetBox(glm::vec3(0.5f));
+			}
+		}
+	}
+}
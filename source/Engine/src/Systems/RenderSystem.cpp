@@ -4,6 +4,7 @@
 #include "stdlibincl.h"
 #include "Systems/LogSystem.h"
 #include "Systems/WorldSystem.h"
+#include "Profiling/Profiler.h"
 
 #include "Components/TransformComponent.h"
 
@@ -53,8 +54,12 @@ namespace CE
 		 1.0f,-1.0f, 1.0f
 	};
 
-	void RenderSystem::Render()
+	void RenderSystem::Render(float alpha)
 	{
+		MEMORY_SCOPE(Memory::MemoryTag::RENDER);
+
+		m_alpha = alpha;
+
 		BeginFrame();
 		DoFrame();
 		EndFrame();
@@ -62,6 +67,8 @@ namespace CE
 
 	void RenderSystem::BeginFrame()
 	{
+		PROFILE_SCOPE("RenderSystem::BeginFrame");
+
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 		glEnable(GL_DEPTH_TEST);
 		glDepthFunc(GL_LESS);
@@ -72,6 +79,8 @@ namespace CE
 
 	void RenderSystem::DoFrame()
 	{
+		PROFILE_SCOPE("RenderSystem::DoFrame");
+
 		glUseProgram(programID);
 	
 		glm::mat4 Projection = glm::perspective(glm::radians(45.0f), 4.0f / 3.0f, 0.1f, 200.0f);
@@ -103,12 +112,7 @@ namespace CE
 		std::shared_ptr<WorldSystem> WS = m_engine->GetSystem<WorldSystem>();
 		if (WS)
 		{
-			WS->ForEachComponent<TransformComponent>([&](TransformComponent* component) {
-				
-				// This is hitting every Transform Component
-				component->GetPosition();
-
-				glm::mat4 Model = component->m_transform;//glm::mat4(1.0f);
+			WS->GetRenderState().Interpolate(m_alpha, [&](const ComponentHandle& handle, const glm::mat4& Model) {
 				glm::mat4 MVP = Projection * View * Model;
 				glUniformMatrix4fv(MatrixID, 1, GL_FALSE, &MVP[0][0]);
 				glDrawArrays(GL_TRIANGLES, 0, 12 * 3);
@@ -118,6 +122,8 @@ namespace CE
 
 	void RenderSystem::EndFrame()
 	{
+		PROFILE_SCOPE("RenderSystem::EndFrame");
+
 		glDisableVertexAttribArray(0);
 
 		NotifyOnEndFrame();
@@ -126,6 +132,11 @@ namespace CE
 		glfwSwapBuffers(m_window);
 	}
 
+	SystemDependencies RenderSystem::GetDependencies() const
+	{
+		return { typeid(LogSystem) };
+	}
+
 	void RenderSystem::Startup()
 	{
 		LOG(RENDER, "Startup");
@@ -1,17 +1,47 @@
 #include "Systems/ResourceSystem.h"
 
+#include "Engine.h"
 #include "Systems/LogSystem.h"
+#include "Systems/JobSystem.h"
 
 namespace CE
 {
+	SystemDependencies ResourceSystem::GetDependencies() const
+	{
+		return { typeid(LogSystem), typeid(JobSystem) };
+	}
+
 	void ResourceSystem::Startup()
 	{
 		LOG(RESOURCES, "Startup");
+		m_jobs = &m_engine->GetSystem<JobSystem>()->GetScheduler();
 	}
 
 	void ResourceSystem::Shutdown()
 	{
 		LOG(RESOURCES, "Shutdown");
+
+		// Requests nobody started yet are dropped, loads already going are seen through
+		{
+			std::lock_guard<std::mutex> lock(m_requestMutex);
+			m_requests = {};
+		}
+		m_jobs->Wait(m_loads);
+	}
+
+	void ResourceSystem::ProcessRequests()
+	{
+		std::queue<InplaceFunction<void()>> requests;
+		{
+			std::lock_guard<std::mutex> lock(m_requestMutex);
+			std::swap(requests, m_requests);
+		}
+
+		while (!requests.empty())
+		{
+			requests.front()();
+			requests.pop();
+		}
 	}
 
 	bool ResourceSystem::IsValidResourcePath(const std::filesystem::path& rPath)
@@ -32,6 +62,12 @@ namespace CE
 		return std::make_shared<Shader>();
 	}
 
+	template<>
+	std::shared_ptr<Shader> ResourceSystem::FinishResource<Shader>(std::shared_ptr<Shader> staged)
+	{
+		return staged;
+	}
+
 	// Textures
 	template<>
 	std::shared_ptr<Texture> ResourceSystem::LoadResource<Texture>(const std::filesystem::path& resourcePath)
@@ -39,6 +75,12 @@ namespace CE
 		return std::make_shared<Texture>();
 	}
 
+	template<>
+	std::shared_ptr<Texture> ResourceSystem::FinishResource<Texture>(std::shared_ptr<Texture> staged)
+	{
+		return staged;
+	}
+
 	enum class OBJ_PREFIX
 	{
 		V,
@@ -67,11 +109,11 @@ namespace CE
 		float u, v;
 	};
 
-	// Meshes
+	// Mesh Data
 	template<>
-	std::shared_ptr<rl::Mesh> ResourceSystem::LoadResource<rl::Mesh>(const std::filesystem::path& resourcePath)
+	std::shared_ptr<MeshData> ResourceSystem::LoadResource<MeshData>(const std::filesystem::path& resourcePath)
 	{
-		auto mesh = std::make_shared<rl::Mesh>();
+		auto meshData = std::make_shared<MeshData>();
 
 		std::ifstream file(resourcePath);
 		if (!file)
@@ -110,8 +152,8 @@ namespace CE
 		};
 
 		std::unordered_map<VertexKey, size_t, VertexHasher> vertexMap;
-		std::vector<rl::Vertex> finalVertices;
-		std::vector<size_t> indices;
+		std::vector<rl::Vertex>& finalVertices = meshData->vertices;
+		std::vector<size_t>& indices = meshData->indices;
 
 		std::string line;
 		while (std::getline(file, line))
@@ -176,7 +218,33 @@ namespace CE
 			}
 		}
 
-		mesh->SetBuffers(finalVertices, indices);
+		return meshData;
+	}
+
+	template<>
+	std::shared_ptr<MeshData> ResourceSystem::FinishResource<MeshData>(std::shared_ptr<MeshData> staged)
+	{
+		return staged;
+	}
+
+	// Meshes
+	template<>
+	std::shared_ptr<MeshData> ResourceSystem::LoadResource<rl::Mesh>(const std::filesystem::path& resourcePath)
+	{
+		return LoadResource<MeshData>(resourcePath);
+	}
+
+	template<>
+	std::shared_ptr<rl::Mesh> ResourceSystem::FinishResource<rl::Mesh>(std::shared_ptr<MeshData> staged)
+	{
+		if (m_engine->IsHeadless())
+		{
+			LOG_ERROR(RESOURCES, "No GL context to upload meshes to when headless, load MeshData instead.");
+			return nullptr;
+		}
+
+		auto mesh = std::make_shared<rl::Mesh>();
+		mesh->SetBuffers(staged->vertices, staged->indices);
 		return mesh;
 	}
 
@@ -0,0 +1,30 @@
+#include "Systems/TaskSystem.h"
+
+#include "Engine.h"
+#include "Systems/LogSystem.h"
+#include "Systems/JobSystem.h"
+#include "Systems/ResourceSystem.h"
+
+namespace CE
+{
+	SystemDependencies TaskSystem::GetDependencies() const
+	{
+		// Tasks await jobs and loads, those have to outlive every task that could be waiting on them
+		return { typeid(LogSystem), typeid(JobSystem), typeid(ResourceSystem) };
+	}
+
+	void TaskSystem::Startup()
+	{
+		LOG_INFO(ENGINE, "Startup Task System");
+	}
+
+	void TaskSystem::Shutdown()
+	{
+		const std::size_t running = m_scheduler.GetStats().running;
+		LOG_INFO(ENGINE, "Shutdown Task System, {} tasks still running", running);
+
+		// Nothing may hand a task back once it is gone, so jobs and loads it started finish first
+		m_engine->GetSystem<JobSystem>()->GetScheduler().WaitIdle();
+		m_scheduler.Clear();
+	}
+}
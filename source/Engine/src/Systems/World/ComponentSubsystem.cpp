@@ -30,4 +30,74 @@ namespace CE
 			}
 		}
 	}
-}
\ No newline at end of file
+
+	bool ComponentSubsystem::CanSnapshot()
+	{
+		bool bCanSnapshot = true;
+		for (std::size_t i = 0; i < m_componentIDs.size(); i++)
+		{
+			std::shared_ptr<IComponentPool> pool = m_componentStorage[m_componentIDs[i]];
+			if (pool == nullptr || !pool->CanSnapshot())
+			{
+				const std::string& name = m_componentNames[i];
+				LOG_ERROR(WORLD, "Component {} is not trivially copyable and can't be snapshot", name);
+				bCanSnapshot = false;
+			}
+		}
+		return bCanSnapshot;
+	}
+
+	void ComponentSubsystem::WriteSnapshot(Snapshot::Writer& writer)
+	{
+		for (std::size_t i = 0; i < m_componentIDs.size(); i++)
+		{
+			std::shared_ptr<IComponentPool> pool = m_componentStorage[m_componentIDs[i]];
+
+			// Callers check CanSnapshot first, a pool missing here would leave a partial snapshot
+			assert(pool != nullptr && pool->CanSnapshot());
+
+			std::ostream& out = writer.BeginSection(Snapshot::SectionType::COMPONENTS, static_cast<std::uint32_t>(i), m_componentNames[i]);
+			pool->WriteSnapshot(out);
+			writer.EndSection();
+		}
+	}
+
+	std::shared_ptr<IComponentPool> ComponentSubsystem::FindSnapshotPool(const Snapshot::Section& section)
+	{
+		// Component IDs are baked into every handle, registration order has to match the saved world
+		const std::size_t componentID = section.header.id;
+		if (componentID >= m_componentIDs.size() || m_componentNames[componentID] != section.name)
+		{
+			std::string name(section.name);
+			LOG_ERROR(WORLD, "Snapshot component {} does not match registered components", name);
+			return nullptr;
+		}
+		return m_componentStorage[m_componentIDs[componentID]];
+	}
+
+	bool ComponentSubsystem::ValidateSnapshot(const Snapshot::Section& section)
+	{
+		std::shared_ptr<IComponentPool> pool = FindSnapshotPool(section);
+		if (pool == nullptr) { return false; }
+
+		if (!pool->ValidateSnapshot(section.payload, section.header.payloadSize))
+		{
+			std::string name(section.name);
+			LOG_ERROR(WORLD, "Snapshot component pool {} has an unexpected layout", name);
+			return false;
+		}
+		return true;
+	}
+
+	bool ComponentSubsystem::ReadSnapshot(const Snapshot::Section& section)
+	{
+		std::shared_ptr<IComponentPool> pool = FindSnapshotPool(section);
+		if (pool == nullptr || !pool->ReadSnapshot(section.payload, section.header.payloadSize))
+		{
+			std::string name(section.name);
+			LOG_ERROR(WORLD, "Snapshot component pool {} has an unexpected layout", name);
+			return false;
+		}
+		return true;
+	}
+}
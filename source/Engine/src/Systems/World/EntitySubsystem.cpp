@@ -2,6 +2,8 @@
 
 #include "imgui.h"
 
+#include <cstring>
+
 namespace CE
 {
 	void EntitySubsystem::DrawEntityPool()
@@ -33,4 +35,148 @@ namespace CE
 			ImGui::Unindent();
 		}
 	}
-}
\ No newline at end of file
+
+	void EntitySubsystem::WriteSnapshot(Snapshot::Writer& writer)
+	{
+		std::ostream& out = writer.BeginSection(Snapshot::SectionType::ENTITIES, 0, "Entities");
+		m_entityPool->WriteHandles(out);
+
+		// Component lists follow, one count per active entity in pool order then every handle back to back
+		std::vector<std::uint64_t> counts;
+		std::vector<ComponentHandle> components;
+		counts.reserve(m_entityPool->GetFill());
+
+		for (auto& [handle, entity] : *m_entityPool)
+		{
+			auto& list = entity.GetComponentList();
+			counts.push_back(list.size());
+			components.insert(components.end(), list.begin(), list.end());
+		}
+
+		std::uint64_t activeCount = counts.size();
+		out.write(reinterpret_cast<const char*>(&activeCount), sizeof(activeCount));
+		out.write(reinterpret_cast<const char*>(counts.data()), counts.size() * sizeof(std::uint64_t));
+		out.write(reinterpret_cast<const char*>(components.data()), components.size() * sizeof(ComponentHandle));
+
+		writer.EndSection();
+	}
+
+	bool EntitySubsystem::ValidateSnapshot(const Snapshot::Section& section, std::size_t componentTypeCount) const
+	{
+		const std::byte* data = section.payload;
+		const std::size_t size = section.header.payloadSize;
+
+		EntityPool::RawHeader header;
+		std::size_t offset = 0;
+		if (!EntityPool::ValidateRaw(data, size, true, header, &offset))
+		{
+			LOG_ERROR(WORLD, "Snapshot entity pool has an unexpected layout");
+			return false;
+		}
+
+		std::uint64_t activeCount = 0;
+		if (offset + sizeof(activeCount) > size) { return false; }
+		std::memcpy(&activeCount, data + offset, sizeof(activeCount));
+		offset += sizeof(activeCount);
+
+		if (activeCount != header.count || activeCount > (size - offset) / sizeof(std::uint64_t))
+		{
+			LOG_ERROR(WORLD, "Snapshot entity component lists are truncated");
+			return false;
+		}
+
+		// Counts are checked one by one so a corrupt one can't overflow the total
+		const std::size_t listBytes = size - offset - activeCount * sizeof(std::uint64_t);
+		const std::size_t maxComponents = listBytes / sizeof(ComponentHandle);
+		std::uint64_t totalComponents = 0;
+		for (std::uint64_t i = 0; i < activeCount; i++)
+		{
+			std::uint64_t count = 0;
+			std::memcpy(&count, data + offset + i * sizeof(std::uint64_t), sizeof(count));
+			if (count > maxComponents - totalComponents)
+			{
+				LOG_ERROR(WORLD, "Snapshot entity component lists are truncated");
+				return false;
+			}
+			totalComponents += count;
+		}
+
+		const std::byte* components = data + offset + activeCount * sizeof(std::uint64_t);
+		for (std::uint64_t i = 0; i < totalComponents; i++)
+		{
+			ComponentHandle component;
+			std::memcpy(&component, components + i * sizeof(ComponentHandle), sizeof(ComponentHandle));
+			if (!component.IsActive() || component.GetType() >= componentTypeCount)
+			{
+				LOG_ERROR(WORLD, "Snapshot entity lists a component of an unregistered type");
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool EntitySubsystem::ReadSnapshot(const Snapshot::Section& section)
+	{
+		const std::byte* data = section.payload;
+		const std::size_t size = section.header.payloadSize;
+
+		if (!m_entityPool->ReadHandles(data, size))
+		{
+			LOG_ERROR(WORLD, "Snapshot entity pool has an unexpected layout");
+			return false;
+		}
+
+		// Sections are validated before anything is read, the checks here only keep a bad one from crashing
+		std::size_t offset = m_entityPool->RawSize(true);
+		std::uint64_t activeCount = 0;
+		if (offset + sizeof(activeCount) > size) { return false; }
+		std::memcpy(&activeCount, data + offset, sizeof(activeCount));
+		offset += sizeof(activeCount);
+
+		if (activeCount != m_entityPool->GetFill() || offset + activeCount * sizeof(std::uint64_t) > size)
+		{
+			LOG_ERROR(WORLD, "Snapshot entity component lists are truncated");
+			return false;
+		}
+
+		const std::byte* counts = data + offset;
+		const std::byte* components = counts + activeCount * sizeof(std::uint64_t);
+		const std::size_t componentBytes = size - (components - data);
+
+		// Entities are restored in place, every list keeps its storage. Free slots drop what they held
+		// so nothing alive before the load outlives it.
+		bool bTruncated = false;
+		std::size_t entityIndex = 0;
+		std::size_t componentIndex = 0;
+		m_entityPool->ForEachSlot([&](const EntityHandle& handle, Entity& entity) {
+			if (!handle.IsActive() || bTruncated)
+			{
+				entity.m_handle = EntityHandle::INVALID;
+				entity.ClearComponents();
+				return;
+			}
+
+			std::uint64_t count = 0;
+			std::memcpy(&count, counts + entityIndex * sizeof(std::uint64_t), sizeof(count));
+			if ((componentIndex + count) * sizeof(ComponentHandle) > componentBytes)
+			{
+				bTruncated = true;
+				entity.ClearComponents();
+				return;
+			}
+
+			entity.m_handle = handle;
+			entity.AssignComponents(reinterpret_cast<const ComponentHandle*>(components) + componentIndex, count);
+
+			componentIndex += count;
+			entityIndex++;
+		});
+
+		if (bTruncated)
+		{
+			LOG_ERROR(WORLD, "Snapshot entity component lists are truncated");
+			return false;
+		}
+		return true;
+	}
+}
@@ -0,0 +1,437 @@
+#include "Systems/World/SpatialSubsystem.h"
+
+#include <cmath>
+
+namespace CE
+{
+	SpatialSubsystem::CellCoord SpatialSubsystem::ToCell(const glm::vec3& position) const
+	{
+		// Clamped while still a float, casting one outside int32 is undefined. NaN lands at the origin.
+		auto toCoord = [this](float value) {
+			const float scaled = std::floor(value * m_invCellSize);
+			if (std::isnan(scaled)) { return 0; }
+			return static_cast<std::int32_t>(std::clamp(scaled, static_cast<float>(-s_maxCellCoord), static_cast<float>(s_maxCellCoord)));
+		};
+		return CellCoord{ toCoord(position.x), toCoord(position.y), toCoord(position.z) };
+	}
+
+	SpatialSubsystem::CellKey SpatialSubsystem::ToKey(const CellCoord& coord)
+	{
+		// 21 bits per axis, plenty of cells either side of the origin
+		constexpr std::uint64_t mask = (1ULL << 21) - 1;
+		return ((static_cast<std::uint64_t>(coord.x) & mask) << 42) |
+			((static_cast<std::uint64_t>(coord.y) & mask) << 21) |
+			(static_cast<std::uint64_t>(coord.z) & mask);
+	}
+
+	std::int32_t SpatialSubsystem::GetSearchMargin() const
+	{
+		const float margin = std::ceil(m_maxRadius * m_invCellSize);
+		return static_cast<std::int32_t>(std::min(margin, static_cast<float>(2 * s_maxCellCoord)));
+	}
+
+	void SpatialSubsystem::AddRadius(float radius)
+	{
+		if (radius > m_maxRadius)
+		{
+			m_maxRadius = radius;
+			m_maxRadiusCount = 1;
+		}
+		else if (radius == m_maxRadius)
+		{
+			m_maxRadiusCount++;
+		}
+	}
+
+	void SpatialSubsystem::RemoveRadius(float radius)
+	{
+		if (radius != m_maxRadius || --m_maxRadiusCount > 0)
+		{
+			return;
+		}
+
+		// The last of the largest went, so one big body doesn't keep widening every query
+		m_maxRadius = 0.f;
+		m_maxRadiusCount = 0;
+		for (const Item& item : m_items)
+		{
+			AddRadius(item.radius);
+		}
+	}
+
+	void SpatialSubsystem::Update(const EntityHandle& entity, const ComponentHandle& component, const glm::vec3& position, float radius)
+	{
+		const std::size_t componentIndex = component.GetIndex();
+		if (componentIndex >= m_lookup.size())
+		{
+			m_lookup.resize(componentIndex + 1, s_invalidItem);
+		}
+
+		const CellCoord coord = ToCell(position);
+		const CellKey cell = ToKey(coord);
+
+		if (m_bHasBounds)
+		{
+			m_minCell = { std::min(m_minCell.x, coord.x), std::min(m_minCell.y, coord.y), std::min(m_minCell.z, coord.z) };
+			m_maxCell = { std::max(m_maxCell.x, coord.x), std::max(m_maxCell.y, coord.y), std::max(m_maxCell.z, coord.z) };
+		}
+		else
+		{
+			m_minCell = coord;
+			m_maxCell = coord;
+			m_bHasBounds = true;
+		}
+
+		std::uint32_t itemIndex = m_lookup[componentIndex];
+		if (itemIndex == s_invalidItem)
+		{
+			itemIndex = static_cast<std::uint32_t>(m_items.size());
+			m_items.push_back(Item{ entity, component, position, radius, cell, 0 });
+			m_lookup[componentIndex] = itemIndex;
+			AddToCell(itemIndex, cell);
+			AddRadius(radius);
+			return;
+		}
+
+		Item& item = m_items[itemIndex];
+		const float previousRadius = item.radius;
+		item.entity = entity;
+		item.component = component;
+		item.position = position;
+		item.radius = radius;
+
+		// Added before the old one goes, so growing never rescans
+		if (radius != previousRadius)
+		{
+			AddRadius(radius);
+			RemoveRadius(previousRadius);
+		}
+
+		// Most moves stay inside the same cell and never touch the grid
+		if (item.cell != cell)
+		{
+			RemoveFromCell(itemIndex);
+			AddToCell(itemIndex, cell);
+		}
+	}
+
+	void SpatialSubsystem::Remove(const ComponentHandle& component)
+	{
+		const std::size_t componentIndex = component.GetIndex();
+		if (componentIndex >= m_lookup.size()) { return; }
+
+		const std::uint32_t itemIndex = m_lookup[componentIndex];
+		if (itemIndex == s_invalidItem || m_items[itemIndex].component != component) { return; }
+
+		RemoveFromCell(itemIndex);
+		m_lookup[componentIndex] = s_invalidItem;
+		const float radius = m_items[itemIndex].radius;
+
+		// Swap the last item into the hole and repoint everything that referenced it
+		const std::uint32_t lastIndex = static_cast<std::uint32_t>(m_items.size() - 1);
+		if (itemIndex != lastIndex)
+		{
+			Item& moved = m_items[itemIndex];
+			moved = m_items[lastIndex];
+			m_lookup[moved.component.GetIndex()] = itemIndex;
+			m_cells[moved.cell][moved.cellSlot] = itemIndex;
+		}
+		m_items.pop_back();
+		RemoveRadius(radius);
+	}
+
+	void SpatialSubsystem::Clear()
+	{
+		m_items.clear();
+		m_lookup.clear();
+		m_cells.clear();
+		m_maxRadius = 0.f;
+		m_maxRadiusCount = 0;
+		m_bHasBounds = false;
+	}
+
+	void SpatialSubsystem::AddToCell(std::uint32_t itemIndex, CellKey cell)
+	{
+		std::vector<std::uint32_t>& items = m_cells[cell];
+		m_items[itemIndex].cell = cell;
+		m_items[itemIndex].cellSlot = static_cast<std::uint32_t>(items.size());
+		items.push_back(itemIndex);
+	}
+
+	void SpatialSubsystem::RemoveFromCell(std::uint32_t itemIndex)
+	{
+		const Item& item = m_items[itemIndex];
+		auto it = m_cells.find(item.cell);
+		assert(it != m_cells.end());
+
+		std::vector<std::uint32_t>& items = it->second;
+		const std::uint32_t last = items.back();
+		items[item.cellSlot] = last;
+		m_items[last].cellSlot = item.cellSlot;
+		items.pop_back();
+
+		if (items.empty())
+		{
+			m_cells.erase(it);
+		}
+	}
+
+	void SpatialSubsystem::QueryRange(const glm::vec3& center, float radius, std::vector<EntityHandle>& results) const
+	{
+		if (m_items.empty()) { return; }
+
+		auto test = [&](const Item& item) {
+			const glm::vec3 delta = item.position - center;
+			const float reach = radius + item.radius;
+			if (glm::dot(delta, delta) <= reach * reach)
+			{
+				results.push_back(item.entity);
+			}
+		};
+
+		const float reach = radius + m_maxRadius;
+		CellCoord lo = ToCell(center - glm::vec3(reach));
+		CellCoord hi = ToCell(center + glm::vec3(reach));
+		lo = { std::max(lo.x, m_minCell.x), std::max(lo.y, m_minCell.y), std::max(lo.z, m_minCell.z) };
+		hi = { std::min(hi.x, m_maxCell.x), std::min(hi.y, m_maxCell.y), std::min(hi.z, m_maxCell.z) };
+		if (lo.x > hi.x || lo.y > hi.y || lo.z > hi.z) { return; }
+
+		// Huge radius over a sparse world, cheaper to walk the occupied cells than the covered ones
+		const std::uint64_t coveredCells = static_cast<std::uint64_t>(hi.x - lo.x + 1) * (hi.y - lo.y + 1) * (hi.z - lo.z + 1);
+		if (coveredCells > m_cells.size())
+		{
+			for (const auto& [cell, items] : m_cells)
+			{
+				for (std::uint32_t itemIndex : items)
+				{
+					test(m_items[itemIndex]);
+				}
+			}
+			return;
+		}
+
+		for (std::int32_t x = lo.x; x <= hi.x; x++)
+		{
+			for (std::int32_t y = lo.y; y <= hi.y; y++)
+			{
+				for (std::int32_t z = lo.z; z <= hi.z; z++)
+				{
+					ForEachInCell(ToKey({ x, y, z }), test);
+				}
+			}
+		}
+	}
+
+	void SpatialSubsystem::QueryRanges(std::span<const RangeQuery> queries, std::vector<EntityHandle>& results, std::vector<std::size_t>& offsets) const
+	{
+		offsets.reserve(offsets.size() + queries.size() + 1);
+		for (const RangeQuery& query : queries)
+		{
+			offsets.push_back(results.size());
+			QueryRange(query.center, query.radius, results);
+		}
+		offsets.push_back(results.size());
+	}
+
+	void SpatialSubsystem::QueryNearest(const glm::vec3& point, std::size_t k, std::vector<EntityHandle>& results) const
+	{
+		if (k == 0 || m_items.empty()) { return; }
+
+		// Max heap on distance, top is the worst of the current best k
+		using Candidate = std::pair<float, std::uint32_t>;
+		std::priority_queue<Candidate> best;
+
+		auto consider = [&](CellKey cell) {
+			auto it = m_cells.find(cell);
+			if (it == m_cells.end()) { return; }
+			for (std::uint32_t itemIndex : it->second)
+			{
+				const glm::vec3 delta = m_items[itemIndex].position - point;
+				const float distSq = glm::dot(delta, delta);
+				if (best.size() < k)
+				{
+					best.push({ distSq, itemIndex });
+				}
+				else if (distSq < best.top().first)
+				{
+					best.pop();
+					best.push({ distSq, itemIndex });
+				}
+			}
+		};
+
+		auto inBounds = [&](std::int32_t x, std::int32_t y, std::int32_t z) {
+			return x >= m_minCell.x && x <= m_maxCell.x &&
+				y >= m_minCell.y && y <= m_maxCell.y &&
+				z >= m_minCell.z && z <= m_maxCell.z;
+		};
+
+		// Search outward in shells of cells, ring r holds every cell r steps away from the start
+		const CellCoord c = ToCell(point);
+		const std::int32_t maxRing = std::max({
+			std::abs(c.x - m_minCell.x), std::abs(m_maxCell.x - c.x),
+			std::abs(c.y - m_minCell.y), std::abs(m_maxCell.y - c.y),
+			std::abs(c.z - m_minCell.z), std::abs(m_maxCell.z - c.z)
+		});
+
+		for (std::int32_t r = 0; r <= maxRing; r++)
+		{
+			for (std::int32_t dx = -r; dx <= r; dx++)
+			{
+				for (std::int32_t dy = -r; dy <= r; dy++)
+				{
+					const bool bEdge = std::abs(dx) == r || std::abs(dy) == r;
+					const std::int32_t dzStep = (bEdge || r == 0) ? 1 : 2 * r;
+					for (std::int32_t dz = -r; dz <= r; dz += dzStep)
+					{
+						if (inBounds(c.x + dx, c.y + dy, c.z + dz))
+						{
+							consider(ToKey({ c.x + dx, c.y + dy, c.z + dz }));
+						}
+					}
+				}
+			}
+
+			// Everything in the next ring is at least r whole cells away
+			const float nextRingDistance = r * m_cellSize;
+			if (best.size() == k && nextRingDistance * nextRingDistance >= best.top().first)
+			{
+				break;
+			}
+		}
+
+		const std::size_t start = results.size();
+		results.resize(start + best.size());
+		for (std::size_t i = results.size(); i > start; i--)
+		{
+			results[i - 1] = m_items[best.top().second].entity;
+			best.pop();
+		}
+	}
+
+	void SpatialSubsystem::QueryNearestBatch(std::span<const glm::vec3> points, std::size_t k, std::vector<EntityHandle>& results, std::vector<std::size_t>& offsets) const
+	{
+		offsets.reserve(offsets.size() + points.size() + 1);
+		for (const glm::vec3& point : points)
+		{
+			offsets.push_back(results.size());
+			QueryNearest(point, k, results);
+		}
+		offsets.push_back(results.size());
+	}
+
+	RaycastHit SpatialSubsystem::Raycast(const Ray& ray) const
+	{
+		RaycastHit hit;
+		if (m_items.empty() || glm::dot(ray.direction, ray.direction) == 0.f) { return hit; }
+
+		float bestT = ray.maxDistance;
+		const std::int32_t margin = GetSearchMargin();
+
+		auto testItem = [&](const Item& item) {
+			// Standard ray/sphere, origin inside the sphere counts as a hit at zero
+			const glm::vec3 oc = ray.origin - item.position;
+			const float b = glm::dot(oc, ray.direction);
+			const float c = glm::dot(oc, oc) - item.radius * item.radius;
+			if (c > 0.f && b > 0.f) { return; }
+
+			const float discriminant = b * b - c;
+			if (discriminant < 0.f) { return; }
+
+			const float t = std::max(0.f, -b - std::sqrt(discriminant));
+			if (t <= bestT)
+			{
+				bestT = t;
+				hit.entity = item.entity;
+				hit.component = item.component;
+				hit.distance = t;
+			}
+		};
+
+		// Amanatides & Woo grid traversal, each visited cell also tests its neighbours out to
+		// the search margin since spheres can reach in from next door
+		CellCoord cell = ToCell(ray.origin);
+		const std::int32_t step[3] = {
+			ray.direction.x > 0.f ? 1 : (ray.direction.x < 0.f ? -1 : 0),
+			ray.direction.y > 0.f ? 1 : (ray.direction.y < 0.f ? -1 : 0),
+			ray.direction.z > 0.f ? 1 : (ray.direction.z < 0.f ? -1 : 0)
+		};
+
+		float tMax[3];
+		float tDelta[3];
+		std::int32_t* coord[3] = { &cell.x, &cell.y, &cell.z };
+		for (int axis = 0; axis < 3; axis++)
+		{
+			const float direction = ray.direction[axis];
+			if (step[axis] == 0)
+			{
+				tMax[axis] = std::numeric_limits<float>::infinity();
+				tDelta[axis] = std::numeric_limits<float>::infinity();
+				continue;
+			}
+
+			const float boundary = (*coord[axis] + (step[axis] > 0 ? 1 : 0)) * m_cellSize;
+			tMax[axis] = (boundary - ray.origin[axis]) / direction;
+			tDelta[axis] = m_cellSize / std::abs(direction);
+		}
+
+		const std::int32_t minBound[3] = { m_minCell.x - margin, m_minCell.y - margin, m_minCell.z - margin };
+		const std::int32_t maxBound[3] = { m_maxCell.x + margin, m_maxCell.y + margin, m_maxCell.z + margin };
+
+		// The walk only ever moves each axis one way, so a cell any earlier step covered is also
+		// inside the previous step's block. Skipping that block is enough to test every cell once.
+		CellCoord previous = cell;
+		bool bHasPrevious = false;
+		auto coveredBefore = [&](std::int32_t x, std::int32_t y, std::int32_t z) {
+			return bHasPrevious && std::abs(x - previous.x) <= margin && std::abs(y - previous.y) <= margin && std::abs(z - previous.z) <= margin;
+		};
+
+		while (true)
+		{
+			// Stop once we've left the occupied region and are still heading away from it
+			bool bLeaving = false;
+			for (int axis = 0; axis < 3; axis++)
+			{
+				if ((*coord[axis] < minBound[axis] && step[axis] <= 0) || (*coord[axis] > maxBound[axis] && step[axis] >= 0))
+				{
+					bLeaving = true;
+				}
+			}
+			if (bLeaving) { break; }
+
+			for (std::int32_t x = cell.x - margin; x <= cell.x + margin; x++)
+			{
+				for (std::int32_t y = cell.y - margin; y <= cell.y + margin; y++)
+				{
+					for (std::int32_t z = cell.z - margin; z <= cell.z + margin; z++)
+					{
+						if (!coveredBefore(x, y, z))
+						{
+							ForEachInCell(ToKey({ x, y, z }), testItem);
+						}
+					}
+				}
+			}
+
+			// Anything closer than the best hit had its center near a cell we've already covered
+			const int axis = (tMax[0] < tMax[1]) ? (tMax[0] < tMax[2] ? 0 : 2) : (tMax[1] < tMax[2] ? 1 : 2);
+			if (tMax[axis] > bestT) { break; }
+
+			previous = cell;
+			bHasPrevious = true;
+			*coord[axis] += step[axis];
+			tMax[axis] += tDelta[axis];
+		}
+
+		return hit;
+	}
+
+	void SpatialSubsystem::Raycasts(std::span<const Ray> rays, std::vector<RaycastHit>& hits) const
+	{
+		hits.reserve(hits.size() + rays.size());
+		for (const Ray& ray : rays)
+		{
+			hits.push_back(Raycast(ray));
+		}
+	}
+}
@@ -0,0 +1,99 @@
+#include "Systems/World/WorldSnapshot.h"
+
+#include <cstring>
+#include <cstddef>
+
+namespace CE::Snapshot
+{
+	Writer::Writer(std::ostream& out) :
+		m_out(out),
+		m_sectionStart(0),
+		m_payloadStart(0),
+		m_sectionCount(0)
+	{
+		Header header{ Magic, Version, 0, 0 };
+		m_out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+		Pad();
+	}
+
+	std::ostream& Writer::BeginSection(SectionType type, std::uint32_t id, std::string_view name)
+	{
+		m_sectionStart = m_out.tellp();
+
+		// Payload size is patched in EndSection once we know it
+		SectionHeader section{ type, id, static_cast<std::uint32_t>(name.size()), 0, 0 };
+		m_out.write(reinterpret_cast<const char*>(&section), sizeof(SectionHeader));
+		m_out.write(name.data(), name.size());
+		Pad();
+
+		m_payloadStart = m_out.tellp();
+		return m_out;
+	}
+
+	void Writer::EndSection()
+	{
+		std::streampos payloadEnd = m_out.tellp();
+		std::uint64_t payloadSize = static_cast<std::uint64_t>(payloadEnd - m_payloadStart);
+
+		m_out.seekp(m_sectionStart + static_cast<std::streamoff>(offsetof(SectionHeader, payloadSize)));
+		m_out.write(reinterpret_cast<const char*>(&payloadSize), sizeof(payloadSize));
+		m_out.seekp(payloadEnd);
+		Pad();
+
+		m_sectionCount++;
+	}
+
+	bool Writer::Finish()
+	{
+		std::streampos end = m_out.tellp();
+		m_out.seekp(offsetof(Header, sectionCount));
+		m_out.write(reinterpret_cast<const char*>(&m_sectionCount), sizeof(m_sectionCount));
+		m_out.seekp(end);
+		m_out.flush();
+		return m_out.good();
+	}
+
+	void Writer::Pad()
+	{
+		static constexpr std::array<char, Alignment> s_zeroes{};
+
+		std::size_t position = static_cast<std::size_t>(m_out.tellp());
+		std::size_t padding = AlignUp(position) - position;
+		m_out.write(s_zeroes.data(), padding);
+	}
+
+	bool Reader::ReadHeader()
+	{
+		if (m_size < sizeof(Header)) { return false; }
+
+		Header header;
+		std::memcpy(&header, m_data, sizeof(Header));
+		if (header.magic != Magic || header.version != Version)
+		{
+			return false;
+		}
+
+		m_remaining = header.sectionCount;
+		m_offset = AlignUp(sizeof(Header));
+		return true;
+	}
+
+	bool Reader::NextSection(Section& section)
+	{
+		if (m_remaining == 0) { return false; }
+		if (m_offset + sizeof(SectionHeader) > m_size) { return false; }
+
+		std::memcpy(&section.header, m_data + m_offset, sizeof(SectionHeader));
+
+		std::size_t nameOffset = m_offset + sizeof(SectionHeader);
+		std::size_t payloadOffset = AlignUp(nameOffset + section.header.nameLength);
+		if (payloadOffset + section.header.payloadSize > m_size) { return false; }
+
+		section.name = std::string_view(reinterpret_cast<const char*>(m_data + nameOffset), section.header.nameLength);
+		section.payload = m_data + payloadOffset;
+
+		m_offset = AlignUp(payloadOffset + section.header.payloadSize);
+		m_remaining--;
+		return true;
+	}
+}
@@ -7,11 +7,19 @@
 #include "Systems/InputSystem.h"
 #include "Components/RenderComponent.h"
 #include "Components/TransformComponent.h"
+#include "Systems/World/WorldSnapshot.h"
+#include "MappedFile.h"
+#include "Profiling/Profiler.h"
 
 #include "Systems/Debug/WorldSystemDebug.h"
 
 namespace CE
 {
+	SystemDependencies WorldSystem::GetDependencies() const
+	{
+		return { typeid(LogSystem), typeid(InputSystem) };
+	}
+
 	void WorldSystem::Startup()
 	{
 		LOG_INFO(WORLD, "Startup Game World System");
@@ -58,6 +66,13 @@ namespace CE
 
 	void WorldSystem::DestroyEntity(const EntityHandle& handle)
 	{
+		// Components go with their entity, otherwise they linger in pools and the spatial index
+		for (const ComponentHandle& component : m_entities.Get(handle).GetComponentList())
+		{
+			m_components.RemoveComponent(component);
+			m_spatial.Remove(component);
+		}
+		NotifyEntityDestroyed(handle);
 		m_entities.DestroyEntity(handle);
 	}
 
@@ -66,6 +81,244 @@ namespace CE
 		return m_entities.Get(handle);
 	}
 
+	bool WorldSystem::SaveSnapshot(const std::filesystem::path& path)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		// Checked before the file is touched so a refused save never leaves a partial snapshot behind
+		if (!m_components.CanSnapshot())
+		{
+			std::string pathStr = path.string();
+			LOG_ERROR(WORLD, "Not saving snapshot {}, some component pools can't be written", pathStr);
+			return false;
+		}
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			std::string pathStr = path.string();
+			LOG_ERROR(WORLD, "Failed to open snapshot file {}", pathStr);
+			return false;
+		}
+
+		Snapshot::Writer writer(file);
+		m_entities.WriteSnapshot(writer);
+		m_components.WriteSnapshot(writer);
+
+		if (!writer.Finish())
+		{
+			std::string pathStr = path.string();
+			LOG_ERROR(WORLD, "Failed writing snapshot file {}", pathStr);
+			return false;
+		}
+
+		std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+		double ms = duration.count();
+		LOG_INFO(WORLD, "Saved snapshot in {:.2f}ms", ms);
+		return true;
+	}
+
+	bool WorldSystem::LoadSnapshot(const std::filesystem::path& path)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		MappedFile file(path);
+		if (!file.IsOpen())
+		{
+			std::string pathStr = path.string();
+			LOG_ERROR(WORLD, "Failed to map snapshot file {}", pathStr);
+			return false;
+		}
+
+		Snapshot::Reader reader(file.Data(), file.Size());
+		if (!reader.ReadHeader())
+		{
+			LOG_ERROR(WORLD, "Snapshot has an invalid header or unsupported version");
+			return false;
+		}
+
+		// Everything is checked up front so a refused load changes nothing
+		if (!ValidateSnapshot(reader))
+		{
+			return false;
+		}
+
+		Snapshot::Section section;
+		while (reader.NextSection(section))
+		{
+			bool bRead = false;
+			switch (section.header.type)
+			{
+			case Snapshot::SectionType::ENTITIES:
+				bRead = m_entities.ReadSnapshot(section);
+				break;
+			case Snapshot::SectionType::COMPONENTS:
+				bRead = m_components.ReadSnapshot(section);
+				break;
+			default:
+				LOG_WARN(WORLD, "Skipping unknown snapshot section");
+				bRead = true;
+				break;
+			}
+
+			if (!bRead)
+			{
+				// Validation passed, so this is a bug rather than a bad file
+				assert(false && "Snapshot section failed to read after validating");
+				return false;
+			}
+		}
+
+		RebuildSpatialIndex();
+		RebuildQueries();
+		m_snapshotGeneration++;
+
+		std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+		double ms = duration.count();
+		LOG_INFO(WORLD, "Loaded snapshot in {:.2f}ms", ms);
+		return true;
+	}
+
+	bool WorldSystem::ValidateSnapshot(Snapshot::Reader reader)
+	{
+		const std::size_t componentTypeCount = m_components.GetComponentTypeCount();
+		std::size_t entitySections = 0;
+		std::vector<std::size_t> componentSections(componentTypeCount, 0);
+
+		Snapshot::Section section;
+		while (reader.NextSection(section))
+		{
+			if (section.header.type == Snapshot::SectionType::ENTITIES)
+			{
+				if (!m_entities.ValidateSnapshot(section, componentTypeCount)) { return false; }
+				entitySections++;
+			}
+			else if (section.header.type == Snapshot::SectionType::COMPONENTS)
+			{
+				if (!m_components.ValidateSnapshot(section)) { return false; }
+				componentSections[section.header.id]++;
+			}
+		}
+
+		if (reader.GetRemainingSections() > 0)
+		{
+			const std::uint32_t remaining = reader.GetRemainingSections();
+			LOG_ERROR(WORLD, "Snapshot is cut short, {} sections missing", remaining);
+			return false;
+		}
+
+		// Exactly one of each, a pool left out would keep its live components while the restored
+		// entities point at whatever is in it
+		const std::size_t badPools = std::count_if(componentSections.begin(), componentSections.end(), [](std::size_t count) { return count != 1; });
+		if (entitySections != 1 || badPools > 0)
+		{
+			LOG_ERROR(WORLD, "Snapshot needs one entity section and one section per pool, {} pools are off", badPools);
+			return false;
+		}
+		return true;
+	}
+
+	void WorldSystem::FixedUpdate()
+	{
+		PROFILE_SCOPE("WorldSystem::FixedUpdate");
+		MEMORY_SCOPE(Memory::MemoryTag::WORLD);
+
+		SyncSpatialIndex();
+
+		PublishRenderState();
+	}
+
+	void WorldSystem::SyncSpatialIndex()
+	{
+		PROFILE_SCOPE("WorldSystem::SyncSpatialIndex");
+
+		// Handles queued before their component was removed fail validation and drop out here
+		for (const ComponentHandle& handle : m_dirtyTransforms)
+		{
+			if (!m_components.IsValid(handle)) { continue; }
+
+			TransformComponent* component = m_components.GetComponent<TransformComponent>(handle);
+			if (component->m_bDirty)
+			{
+				m_spatial.Update(component->m_owner, component->m_handle, component->GetPosition(), component->GetBoundingRadius());
+				component->m_bDirty = false;
+			}
+		}
+		m_dirtyTransforms.clear();
+	}
+
+	void WorldSystem::RebuildSpatialIndex()
+	{
+		// Loaded flags and queue pointers came from whichever world saved them, queue every transform afresh
+		m_spatial.Clear();
+		m_dirtyTransforms.clear();
+		m_components.ForEachComponent<TransformComponent>([this](TransformComponent* component) {
+			component->m_dirtyList = &m_dirtyTransforms;
+			component->m_bDirty = false;
+			component->MarkDirty();
+		});
+		SyncSpatialIndex();
+	}
+
+	void WorldSystem::NotifyEntityChanged(const EntityHandle& handle)
+	{
+		std::erase_if(m_queries, [](const std::weak_ptr<IWorldQuery>& query) { return query.expired(); });
+
+		std::vector<ComponentHandle>& components = m_entities.Get(handle).GetComponentList();
+		for (const std::weak_ptr<IWorldQuery>& weakQuery : m_queries)
+		{
+			if (std::shared_ptr<IWorldQuery> query = weakQuery.lock())
+			{
+				query->OnEntityChanged(handle, components, m_components);
+			}
+		}
+	}
+
+	void WorldSystem::NotifyEntityDestroyed(const EntityHandle& handle)
+	{
+		std::erase_if(m_queries, [](const std::weak_ptr<IWorldQuery>& query) { return query.expired(); });
+
+		for (const std::weak_ptr<IWorldQuery>& weakQuery : m_queries)
+		{
+			if (std::shared_ptr<IWorldQuery> query = weakQuery.lock())
+			{
+				query->OnEntityDestroyed(handle);
+			}
+		}
+	}
+
+	void WorldSystem::PopulateQuery(IWorldQuery& query)
+	{
+		query.Clear();
+		m_entities.ForEachEntity([this, &query](Entity& entity) {
+			query.OnEntityChanged(entity.m_handle, entity.GetComponentList(), m_components);
+		});
+	}
+
+	void WorldSystem::RebuildQueries()
+	{
+		std::erase_if(m_queries, [](const std::weak_ptr<IWorldQuery>& query) { return query.expired(); });
+
+		for (const std::weak_ptr<IWorldQuery>& weakQuery : m_queries)
+		{
+			if (std::shared_ptr<IWorldQuery> query = weakQuery.lock())
+			{
+				PopulateQuery(*query);
+			}
+		}
+	}
+
+	void WorldSystem::PublishRenderState()
+	{
+		PROFILE_SCOPE("WorldSystem::PublishRenderState");
+
+		RenderState& state = m_renderState.BeginWrite();
+		m_components.ForEachComponent<TransformComponent>([&state](TransformComponent* component) {
+			state.instances.push_back({ component->m_handle, component->GetTransform() });
+		});
+		m_renderState.Publish();
+	}
+
 	void WorldSystem::CreateTestComponents(std::size_t amount)
 	{
 		std::array<EntityHandle, 15> someEntities{};
@@ -0,0 +1,97 @@
+#include "Tasks/TaskScheduler.h"
+
+#include "Profiling/Profiler.h"
+
+namespace CE::Tasks
+{
+	TaskScheduler::~TaskScheduler()
+	{
+		Clear();
+	}
+
+	void TaskScheduler::Spawn(std::coroutine_handle<> root)
+	{
+		// Tracked before it runs, it may finish without ever suspending
+		m_roots.push_back(root);
+		root.resume();
+	}
+
+	void TaskScheduler::Finish(std::coroutine_handle<> root)
+	{
+		auto it = std::find(m_roots.begin(), m_roots.end(), root);
+		assert(it != m_roots.end());
+		m_roots.erase(it);
+		root.destroy();
+	}
+
+	void TaskScheduler::WaitFrame(std::coroutine_handle<> handle)
+	{
+		m_nextFrame.push_back(handle);
+	}
+
+	void TaskScheduler::WaitSeconds(std::coroutine_handle<> handle, double seconds)
+	{
+		m_timers.push({ m_time + seconds, m_timerOrder++, handle });
+	}
+
+	void TaskScheduler::Resume(std::coroutine_handle<> handle)
+	{
+		std::lock_guard<std::mutex> lock(m_resumeMutex);
+		m_resumed.push_back(handle);
+	}
+
+	void TaskScheduler::Update(double deltaTime)
+	{
+		PROFILE_FUNCTION();
+
+		m_time += deltaTime;
+
+		// Everything due is gathered up front, anything those tasks wait on next is left for next frame
+		m_ready.clear();
+		{
+			std::lock_guard<std::mutex> lock(m_resumeMutex);
+			m_ready.swap(m_resumed);
+		}
+		m_ready.insert(m_ready.end(), m_nextFrame.begin(), m_nextFrame.end());
+		m_nextFrame.clear();
+
+		while (!m_timers.empty() && m_timers.top().wakeTime <= m_time)
+		{
+			m_ready.push_back(m_timers.top().handle);
+			m_timers.pop();
+		}
+
+		for (std::coroutine_handle<> handle : m_ready)
+		{
+			handle.resume();
+		}
+		m_resumeCount += m_ready.size();
+	}
+
+	void TaskScheduler::Clear()
+	{
+		m_nextFrame.clear();
+		m_timers = {};
+		{
+			std::lock_guard<std::mutex> lock(m_resumeMutex);
+			m_resumed.clear();
+		}
+
+		// Destroying a task destroys whatever it was awaiting along with it
+		for (std::coroutine_handle<> root : m_roots)
+		{
+			root.destroy();
+		}
+		m_roots.clear();
+	}
+
+	TaskStats TaskScheduler::GetStats() const
+	{
+		TaskStats stats;
+		stats.running = m_roots.size();
+		stats.waitingFrame = m_nextFrame.size();
+		stats.waitingTime = m_timers.size();
+		stats.resumed = m_resumeCount;
+		return stats;
+	}
+}
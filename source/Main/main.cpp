@@ -4,9 +4,15 @@
 //#define STB_IMAGE_IMPLEMENTATION
 //#include "stb_image.h"
 
-int main()
+int main(int argc, char** argv)
 {
-	CE::Engine my_engine;
+	const std::optional<CE::EngineConfig> config = CE::EngineConfig::FromCommandLine(argc, argv);
+	if (!config)
+	{
+		return 1;
+	}
+
+	CE::Engine my_engine(*config);
 	my_engine.Start();
 }
 